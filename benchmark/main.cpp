@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+#include "Renderer.hpp"
+#include "RendererConfig.hpp"
+#include "TangentSpace.hpp"
+
+namespace {
+
+const uint32_t TANGENT_BENCHMARK_RUNS = 5;
+
+template <typename Function>
+double MeasureBest(Function function)
+{
+    auto best = std::numeric_limits<double>::max();
+    for (uint32_t i = 0; i < TANGENT_BENCHMARK_RUNS; i++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+            start).count());
+    }
+    return best;
+}
+
+float GetMaxDeviation(const std::vector<glm::vec3>& normals, const std::vector<glm::vec4>& tangents,
+    const std::vector<glm::vec3>& referenceNormals, const std::vector<glm::vec4>& referenceTangents)
+{
+    auto deviation = 0.0f;
+    for (size_t i = 0; i < normals.size(); i++) {
+        deviation = std::max(deviation, glm::length(normals[i] - referenceNormals[i]));
+        deviation = std::max(deviation, glm::length(tangents[i] - referenceTangents[i]));
+    }
+    return deviation;
+}
+
+void RunTangentSpaceBenchmark(const RendererConfig& config)
+{
+    auto gridSize = config.tangentBenchmarkGrid;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<uint32_t> indices;
+    positions.reserve((gridSize + 1) * (gridSize + 1));
+    uvs.reserve((gridSize + 1) * (gridSize + 1));
+    indices.reserve(6 * gridSize * gridSize);
+    for (uint32_t i = 0; i <= gridSize; i++) {
+        for (uint32_t j = 0; j <= gridSize; j++) {
+            auto uv = glm::vec2(j, i) / static_cast<float>(gridSize);
+            positions.emplace_back(uv.x, 0.05f * std::sin(20.0f * uv.x) * std::cos(17.0f * uv.y), uv.y);
+            uvs.push_back(uv);
+        }
+    }
+    for (uint32_t i = 0; i < gridSize; i++) {
+        for (uint32_t j = 0; j < gridSize; j++) {
+            auto corner = i * (gridSize + 1) + j;
+            indices.insert(indices.end(), {corner, corner + gridSize + 1, corner + 1, corner + 1,
+                corner + gridSize + 1, corner + gridSize + 2});
+        }
+    }
+
+    TangentSpaceInput input;
+    input.positions = positions.data();
+    input.uvs = uvs.data();
+    input.indices = indices.data();
+    input.vertexCount = static_cast<uint32_t>(positions.size());
+    input.indexCount = static_cast<uint32_t>(indices.size());
+
+    std::vector<glm::vec3> referenceNormals, normals;
+    std::vector<glm::vec4> referenceTangents, tangents;
+    auto scalarMs = MeasureBest([&]() {
+        TangentSpaceGenerator::GenerateScalar(input, referenceNormals, referenceTangents);
+    });
+
+    TangentSpaceGenerator serialGenerator(nullptr);
+    auto simdMs = MeasureBest([&]() { serialGenerator.Generate(input, normals, tangents); });
+    auto simdDeviation = GetMaxDeviation(normals, tangents, referenceNormals, referenceTangents);
+
+    ThreadPool threadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    TangentSpaceGenerator parallelGenerator(&threadPool);
+    auto parallelMs = MeasureBest([&]() { parallelGenerator.Generate(input, normals, tangents); });
+    auto parallelDeviation = GetMaxDeviation(normals, tangents, referenceNormals, referenceTangents);
+
+    std::cout << "Tangent space: " << input.vertexCount << " vertices, " << input.indexCount / 3 << " triangles"
+        << std::endl;
+    std::cout << "  scalar:            " << scalarMs << " ms" << std::endl;
+    std::cout << "  simd:              " << simdMs << " ms (" << scalarMs / simdMs << "x, max deviation "
+        << simdDeviation << ")" << std::endl;
+    std::cout << "  simd, " << threadPool.GetThreadCount() << " threads: " << parallelMs << " ms ("
+        << scalarMs / parallelMs << "x, max deviation " << parallelDeviation << ")" << std::endl;
+
+    if (!config.reportPath.empty()) {
+        std::ofstream file(config.reportPath);
+        file << "{\n";
+        file << "  \"vertices\": " << input.vertexCount << ",\n";
+        file << "  \"triangles\": " << input.indexCount / 3 << ",\n";
+        file << "  \"threads\": " << threadPool.GetThreadCount() << ",\n";
+        file << "  \"scalarMs\": " << scalarMs << ",\n";
+        file << "  \"simdMs\": " << simdMs << ",\n";
+        file << "  \"parallelMs\": " << parallelMs << ",\n";
+        file << "  \"maxDeviation\": " << std::max(simdDeviation, parallelDeviation) << "\n";
+        file << "}\n";
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    RendererConfig config;
+    config.headless = true;
+    config.benchmark = true;
+    config.ParseArguments(argc, argv);
+
+    if (config.tangentBenchmarkGrid > 0) {
+        RunTangentSpaceBenchmark(config);
+        return EXIT_SUCCESS;
+    }
+
+    Renderer renderer(config);
+    renderer.Run();
+
+    auto result = renderer.GetBenchmarkResult();
+    if (config.budgetMs > 0.0 && (result.cpu.p95 > config.budgetMs || result.gpu.p95 > config.budgetMs)) {
+        std::cerr << "Frame time p95 exceeds budget of " << config.budgetMs << " ms" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
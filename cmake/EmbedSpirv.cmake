@@ -0,0 +1,28 @@
+# Converts a SPIR-V binary into a header with a constexpr word array.
+# Usage: cmake -DINPUT=<file.spv> -DOUTPUT=<file.hpp> -DSYMBOL=<name> -P EmbedSpirv.cmake
+file(READ ${INPUT} CONTENT HEX)
+string(LENGTH "${CONTENT}" CONTENT_LENGTH)
+math(EXPR REMAINDER "${CONTENT_LENGTH} % 8")
+if (NOT REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a valid SPIR-V binary")
+endif()
+
+string(REGEX REPLACE "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])" "0x\\4\\3\\2\\1, "
+    WORDS "${CONTENT}")
+set(WORD "0x[0-9a-f]+, ")
+string(REGEX REPLACE "(${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD})" "\\1\n    " WORDS "${WORDS}")
+string(REGEX REPLACE " +\n" "\n" WORDS "${WORDS}")
+string(STRIP "${WORDS}" WORDS)
+
+file(WRITE ${OUTPUT}
+    "#ifndef ${SYMBOL}_HPP\n"
+    "#define ${SYMBOL}_HPP\n"
+    "\n"
+    "#include <cstdint>\n"
+    "\n"
+    "inline constexpr uint32_t ${SYMBOL}[] = {\n"
+    "    ${WORDS}\n"
+    "};\n"
+    "\n"
+    "#endif\n"
+)
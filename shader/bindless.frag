@@ -0,0 +1,17 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec2 fragUv;
+
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform MaterialConstants {
+    uint textureIndex;
+} material;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = texture(textures[material.textureIndex], fragUv);
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : require
+
+#define CLUSTERED_LIGHTING
+#include "forward.glsl"
\ No newline at end of file
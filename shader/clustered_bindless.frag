@@ -0,0 +1,8 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : require
+#extension GL_GOOGLE_include_directive : require
+
+#define BINDLESS_TEXTURES
+#define CLUSTERED_LIGHTING
+#include "forward.glsl"
\ No newline at end of file
@@ -0,0 +1,39 @@
+const uint CLUSTER_COUNT_X = 16;
+const uint CLUSTER_COUNT_Y = 9;
+const uint CLUSTER_COUNT_Z = 24;
+const uint CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+const uint MAX_LIGHTS_PER_CLUSTER = 128;
+
+const uint LIGHT_TYPE_POINT = 0;
+const uint LIGHT_TYPE_SPOT = 1;
+
+struct Light {
+    vec4 positionRange;
+    vec4 colorIntensity;
+    vec4 directionCosOuter;
+    vec4 parameters;
+};
+
+struct ClusterParameters {
+    vec4 cameraPosition;
+    vec2 screenSize;
+    float nearPlane;
+    float farPlane;
+    uint lightCount;
+};
+
+float GetSliceDepth(uint slice, ClusterParameters parameters)
+{
+    return parameters.nearPlane * pow(parameters.farPlane / parameters.nearPlane,
+        float(slice) / float(CLUSTER_COUNT_Z));
+}
+
+uint GetClusterIndex(vec2 fragCoord, float viewDepth, ClusterParameters parameters)
+{
+    uvec2 tile = min(uvec2(fragCoord / parameters.screenSize * vec2(CLUSTER_COUNT_X, CLUSTER_COUNT_Y)),
+        uvec2(CLUSTER_COUNT_X - 1, CLUSTER_COUNT_Y - 1));
+    float slice = log(max(viewDepth, parameters.nearPlane) / parameters.nearPlane) /
+        log(parameters.farPlane / parameters.nearPlane) * float(CLUSTER_COUNT_Z);
+    uint z = min(uint(slice), CLUSTER_COUNT_Z - 1);
+    return tile.x + tile.y * CLUSTER_COUNT_X + z * CLUSTER_COUNT_X * CLUSTER_COUNT_Y;
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+layout(local_size_x = 64) in;
+
+struct DrawIndexedIndirectCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(push_constant) uniform CullConstants {
+    mat4 viewProjection;
+    vec4 boundsMin;
+    vec4 boundsMax;
+    uint instanceCount;
+    uint commandIndex;
+    uint visibleOffset;
+    uint flagOffset;
+    uint latePhase;
+    uint pyramidLevels;
+    vec2 pyramidSize;
+} constants;
+
+layout(std430, binding = 0) readonly buffer Instances {
+    mat4 transforms[];
+} instances;
+
+layout(std430, binding = 1) writeonly buffer Visible {
+    mat4 transforms[];
+} visible;
+
+layout(std430, binding = 2) buffer Commands {
+    DrawIndexedIndirectCommand commands[];
+} commands;
+
+#ifdef OCCLUSION_CULLING
+layout(std430, binding = 3) buffer OccludedFlags {
+    uint flags[];
+} occluded;
+
+layout(binding = 4) uniform sampler2D pyramid;
+#endif
+
+bool IsInsideFrustum(mat4 clip)
+{
+    mat4 rows = transpose(clip);
+    vec4 planes[6] = vec4[6](
+        rows[3] + rows[0],
+        rows[3] - rows[0],
+        rows[3] + rows[1],
+        rows[3] - rows[1],
+        rows[2],
+        rows[3] - rows[2]
+    );
+
+    vec3 center = 0.5 * (constants.boundsMax.xyz + constants.boundsMin.xyz);
+    vec3 extents = 0.5 * (constants.boundsMax.xyz - constants.boundsMin.xyz);
+    for (int i = 0; i < 6; i++) {
+        if (dot(planes[i].xyz, center) + planes[i].w + dot(abs(planes[i].xyz), extents) < 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef OCCLUSION_CULLING
+bool IsOccluded(mat4 clip)
+{
+    vec2 minUv = vec2(1.0);
+    vec2 maxUv = vec2(0.0);
+    float minDepth = 1.0;
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = mix(constants.boundsMin.xyz, constants.boundsMax.xyz, vec3(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+        vec4 position = clip * vec4(corner, 1.0);
+        if (position.w <= 0.0) {
+            return false;
+        }
+        vec3 ndc = position.xyz / position.w;
+        minUv = min(minUv, ndc.xy * 0.5 + 0.5);
+        maxUv = max(maxUv, ndc.xy * 0.5 + 0.5);
+        minDepth = min(minDepth, ndc.z);
+    }
+    minUv = clamp(minUv, 0.0, 1.0);
+    maxUv = clamp(maxUv, 0.0, 1.0);
+
+    vec2 extent = (maxUv - minUv) * constants.pyramidSize;
+    int level = min(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), int(constants.pyramidLevels) - 1);
+    ivec2 levelSize = textureSize(pyramid, level);
+    ivec2 texelMin = min(ivec2(minUv * vec2(levelSize)), levelSize - 1);
+    ivec2 texelMax = min(ivec2(maxUv * vec2(levelSize)), levelSize - 1);
+
+    float depth = max(
+        max(texelFetch(pyramid, texelMin, level).r, texelFetch(pyramid, ivec2(texelMax.x, texelMin.y), level).r),
+        max(texelFetch(pyramid, ivec2(texelMin.x, texelMax.y), level).r, texelFetch(pyramid, texelMax, level).r));
+    return minDepth > depth;
+}
+#endif
+
+void Emit(mat4 transform)
+{
+    uint slot = atomicAdd(commands.commands[constants.commandIndex].instanceCount, 1);
+    visible.transforms[constants.visibleOffset + slot] = transform;
+}
+
+void main() {
+    uint instance = gl_GlobalInvocationID.x;
+    if (instance >= constants.instanceCount) {
+        return;
+    }
+
+    mat4 transform = instances.transforms[instance];
+    mat4 clip = constants.viewProjection * transform;
+#ifdef OCCLUSION_CULLING
+    uint flag = constants.flagOffset + instance;
+    if (constants.latePhase != 0) {
+        if (occluded.flags[flag] != 0u && !IsOccluded(clip)) {
+            Emit(transform);
+        }
+        return;
+    }
+
+    bool occludedInstance = false;
+    if (IsInsideFrustum(clip)) {
+        occludedInstance = constants.pyramidLevels > 0 && IsOccluded(clip);
+        if (!occludedInstance) {
+            Emit(transform);
+        }
+    }
+    occluded.flags[flag] = occludedInstance ? 1u : 0u;
+#else
+    if (IsInsideFrustum(clip)) {
+        Emit(transform);
+    }
+#endif
+}
\ No newline at end of file
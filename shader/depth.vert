@@ -0,0 +1,19 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 vertPosition;
+layout(location = 2) in mat4 instanceTransform;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+invariant gl_Position;
+
+void main() {
+    vec4 scenePosition = instanceTransform * vec4(vertPosition, 1.0);
+    vec4 worldPosition = ubo.model * scenePosition;
+    gl_Position = ubo.proj * ubo.view * worldPosition;
+}
\ No newline at end of file
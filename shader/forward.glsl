@@ -0,0 +1,147 @@
+#ifdef CLUSTERED_LIGHTING
+#include "clusters.glsl"
+#endif
+#ifdef SHADOWS
+#include "shadows.glsl"
+#endif
+
+layout(location = 0) in vec2 fragUv;
+layout(location = 1) in vec3 fragWorldPosition;
+layout(location = 2) in vec3 fragScenePosition;
+layout(location = 3) in vec3 fragNormal;
+layout(location = 4) in vec4 fragTangent;
+
+#ifdef BINDLESS_TEXTURES
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform MaterialConstants {
+    uint textureIndex;
+} material;
+
+#define LIGHTING_SET 2
+#else
+layout(binding = 1) uniform sampler2D textureSampler;
+
+#define LIGHTING_SET 1
+#endif
+
+#ifdef CLUSTERED_LIGHTING
+layout(std430, set = LIGHTING_SET, binding = 0) readonly buffer Lights {
+    Light lights[];
+};
+
+layout(std430, set = LIGHTING_SET, binding = 1) readonly buffer ClusterCounts {
+    uint clusterCounts[];
+};
+
+layout(std430, set = LIGHTING_SET, binding = 2) readonly buffer ClusterLights {
+    uint clusterLights[];
+};
+
+layout(std140, set = LIGHTING_SET, binding = 3) uniform ClusterUniforms {
+    ClusterParameters clusterParameters;
+};
+
+#if LIGHTING_SET == 2
+#define SHADOW_SET 3
+#else
+#define SHADOW_SET 2
+#endif
+#else
+#define SHADOW_SET LIGHTING_SET
+#endif
+
+#ifdef SHADOWS
+layout(std140, set = SHADOW_SET, binding = 0) uniform ShadowUniforms {
+    ShadowParameters shadowParameters;
+};
+
+layout(set = SHADOW_SET, binding = 1) uniform sampler2DArrayShadow shadowMap;
+#endif
+
+layout(location = 0) out vec4 outColor;
+
+const float AMBIENT = 0.05;
+
+#ifdef CLUSTERED_LIGHTING
+vec3 EvaluateLight(Light light, vec3 position, vec3 normal)
+{
+    vec3 toLight = light.positionRange.xyz - position;
+    float distance = length(toLight);
+    vec3 direction = toLight / max(distance, 1e-4);
+
+    float window = clamp(1.0 - pow(distance / light.positionRange.w, 4.0), 0.0, 1.0);
+    float attenuation = window * window / (distance * distance + 1.0);
+    if (uint(light.parameters.y) == LIGHT_TYPE_SPOT) {
+        float cosAngle = dot(-direction, light.directionCosOuter.xyz);
+        attenuation *= smoothstep(light.directionCosOuter.w, light.parameters.x, cosAngle);
+    }
+    return light.colorIntensity.rgb * light.colorIntensity.w * attenuation * max(dot(normal, direction), 0.0);
+}
+#endif
+
+#ifdef SHADOWS
+float SampleShadow(vec3 scenePosition, float viewDepth)
+{
+    uint cascade = GetCascadeIndex(viewDepth, shadowParameters);
+    vec4 lightPosition = shadowParameters.lightViewProjections[cascade] * vec4(scenePosition, 1.0);
+    vec3 coord = lightPosition.xyz / lightPosition.w;
+    vec2 uv = coord.xy * 0.5 + 0.5;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))) || coord.z > 1.0) {
+        return 1.0;
+    }
+
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float visibility = 0.0;
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++) {
+            vec2 offset = (vec2(x, y) - 0.5) * texelSize;
+            visibility += texture(shadowMap, vec4(uv + offset, float(cascade), coord.z));
+        }
+    }
+    return visibility * 0.25;
+}
+#endif
+
+void main() {
+#ifdef BINDLESS_TEXTURES
+    vec4 albedo = texture(textures[material.textureIndex], fragUv);
+#else
+    vec4 albedo = texture(textureSampler, fragUv);
+#endif
+
+#ifdef CLUSTERED_LIGHTING
+    vec3 cameraPosition = clusterParameters.cameraPosition.xyz;
+    float nearPlane = clusterParameters.nearPlane;
+    float farPlane = clusterParameters.farPlane;
+#else
+    vec3 cameraPosition = shadowParameters.cameraPosition.xyz;
+    float nearPlane = shadowParameters.depthRange.x;
+    float farPlane = shadowParameters.depthRange.y;
+#endif
+
+    vec3 normal = normalize(fragNormal);
+    if (dot(normal, cameraPosition - fragWorldPosition) < 0.0) {
+        normal = -normal;
+    }
+    float viewDepth = nearPlane * farPlane / (farPlane - gl_FragCoord.z * (farPlane - nearPlane));
+
+    vec3 lighting = vec3(AMBIENT);
+#ifdef SHADOWS
+    vec3 sunDirection = shadowParameters.lightDirection.xyz;
+    float sunDiffuse = max(dot(normal, sunDirection), 0.0);
+    if (sunDiffuse > 0.0) {
+        lighting += shadowParameters.lightColor.rgb * shadowParameters.lightColor.w * sunDiffuse *
+            SampleShadow(fragScenePosition, viewDepth);
+    }
+#endif
+#ifdef CLUSTERED_LIGHTING
+    uint cluster = GetClusterIndex(gl_FragCoord.xy, viewDepth, clusterParameters);
+    uint count = clusterCounts[cluster];
+    for (uint i = 0; i < count; i++) {
+        lighting += EvaluateLight(lights[clusterLights[cluster * MAX_LIGHTS_PER_CLUSTER + i]], fragWorldPosition,
+            normal);
+    }
+#endif
+    outColor = vec4(albedo.rgb * lighting, albedo.a);
+}
\ No newline at end of file
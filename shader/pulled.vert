@@ -0,0 +1,34 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : require
+
+#include "pulling.glsl"
+
+layout(location = 2) in mat4 instanceTransform;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(location = 0) out vec2 fragUv;
+layout(location = 1) out vec3 fragWorldPosition;
+layout(location = 2) out vec3 fragScenePosition;
+layout(location = 3) out vec3 fragNormal;
+layout(location = 4) out vec4 fragTangent;
+
+invariant gl_Position;
+
+void main() {
+    vec4 scenePosition = instanceTransform * vec4(PullPosition(uint(gl_VertexIndex)), 1.0);
+    vec4 worldPosition = ubo.model * scenePosition;
+    gl_Position = ubo.proj * ubo.view * worldPosition;
+    fragUv = PullUv(uint(gl_VertexIndex));
+    fragWorldPosition = worldPosition.xyz;
+    fragScenePosition = scenePosition.xyz;
+    mat3 normalTransform = mat3(ubo.model * instanceTransform);
+    vec4 tangent = PullTangent(uint(gl_VertexIndex));
+    fragNormal = normalTransform * PullNormal(uint(gl_VertexIndex));
+    fragTangent = vec4(normalTransform * tangent.xyz, tangent.w);
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+layout(std430, binding = 2) readonly buffer PackedVertices {
+    uint packedVertices[];
+};
+
+layout(push_constant) uniform PulledMesh {
+    layout(offset = 16) vec3 positionOffset;
+    uint baseVertex;
+    vec3 positionScale;
+} pulledMesh;
+
+const uint PACKED_VERTEX_WORDS = 5;
+
+vec3 DecodeOctahedral(uint packed) {
+    vec2 encoded = unpackSnorm2x16(packed);
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.xy += mix(vec2(fold), vec2(-fold), greaterThanEqual(direction.xy, vec2(0.0)));
+    return normalize(direction);
+}
+
+vec3 PullPosition(uint vertex) {
+    uint base = PACKED_VERTEX_WORDS * (pulledMesh.baseVertex + vertex);
+    uint xy = packedVertices[base];
+    uint z = packedVertices[base + 1];
+    vec3 quantized = vec3(xy & 0xffffu, xy >> 16, z & 0xffffu);
+    return pulledMesh.positionOffset + quantized * pulledMesh.positionScale;
+}
+
+vec2 PullUv(uint vertex) {
+    return unpackHalf2x16(packedVertices[PACKED_VERTEX_WORDS * (pulledMesh.baseVertex + vertex) + 2]);
+}
+
+vec3 PullNormal(uint vertex) {
+    return DecodeOctahedral(packedVertices[PACKED_VERTEX_WORDS * (pulledMesh.baseVertex + vertex) + 3]);
+}
+
+vec4 PullTangent(uint vertex) {
+    uint base = PACKED_VERTEX_WORDS * (pulledMesh.baseVertex + vertex);
+    return vec4(DecodeOctahedral(packedVertices[base + 4]), (packedVertices[base + 1] >> 16) != 0u ? 1.0 : -1.0);
+}
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 layout(location = 0) in vec3 vertPosition;
 layout(location = 1) in vec2 vertUv;
+layout(location = 2) in mat4 instanceTransform;
+layout(location = 6) in vec3 vertNormal;
+layout(location = 7) in vec4 vertTangent;
 
 layout(binding = 0) uniform UniformBufferObject {
     mat4 model;
@@ -11,8 +14,21 @@ layout(binding = 0) uniform UniformBufferObject {
 } ubo;
 
 layout(location = 0) out vec2 fragUv;
+layout(location = 1) out vec3 fragWorldPosition;
+layout(location = 2) out vec3 fragScenePosition;
+layout(location = 3) out vec3 fragNormal;
+layout(location = 4) out vec4 fragTangent;
+
+invariant gl_Position;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(vertPosition, 1.0);
+    vec4 scenePosition = instanceTransform * vec4(vertPosition, 1.0);
+    vec4 worldPosition = ubo.model * scenePosition;
+    gl_Position = ubo.proj * ubo.view * worldPosition;
     fragUv = vertUv;
+    fragWorldPosition = worldPosition.xyz;
+    fragScenePosition = scenePosition.xyz;
+    mat3 normalTransform = mat3(ubo.model * instanceTransform);
+    fragNormal = normalTransform * vertNormal;
+    fragTangent = vec4(normalTransform * vertTangent.xyz, vertTangent.w);
 }
\ No newline at end of file
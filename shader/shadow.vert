@@ -0,0 +1,13 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 vertPosition;
+layout(location = 2) in mat4 instanceTransform;
+
+layout(push_constant) uniform ShadowConstants {
+    mat4 lightViewProjection;
+} constants;
+
+void main() {
+    gl_Position = constants.lightViewProjection * instanceTransform * vec4(vertPosition, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+const uint CASCADE_COUNT = 4;
+
+struct ShadowParameters {
+    mat4 lightViewProjections[CASCADE_COUNT];
+    vec4 splitDepths;
+    vec4 lightDirection;
+    vec4 lightColor;
+    vec4 cameraPosition;
+    vec2 depthRange;
+};
+
+uint GetCascadeIndex(float viewDepth, ShadowParameters parameters)
+{
+    uint cascade = 0;
+    while (cascade < CASCADE_COUNT - 1 && viewDepth > parameters.splitDepths[cascade]) {
+        cascade++;
+    }
+    return cascade;
+}
\ No newline at end of file
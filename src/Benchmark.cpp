@@ -0,0 +1,333 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+Benchmark::Benchmark(uint32_t warmupFrames, uint32_t measuredFrames, float timestep) :
+    warmupFrames_(warmupFrames),
+    measuredFrames_(measuredFrames),
+    timestep_(timestep)
+{
+    cpuSamples_.reserve(measuredFrames);
+    gpuSamples_.reserve(measuredFrames);
+    latencySamples_.reserve(measuredFrames);
+}
+
+void Benchmark::AddCpuSample(uint32_t frameIndex, double milliseconds, uint32_t drawCount)
+{
+    if (IsMeasured(frameIndex)) {
+        cpuSamples_.push_back(milliseconds);
+        drawCount_ += drawCount;
+    }
+}
+
+void Benchmark::AddGpuSample(uint32_t frameIndex, double milliseconds)
+{
+    if (IsMeasured(frameIndex)) {
+        gpuSamples_.push_back(milliseconds);
+    }
+}
+
+void Benchmark::AddLatencySample(uint32_t frameIndex, double milliseconds)
+{
+    if (IsMeasured(frameIndex)) {
+        latencySamples_.push_back(milliseconds);
+    }
+}
+
+void Benchmark::AddResizeSample(uint32_t frameIndex, double milliseconds)
+{
+    if (IsMeasured(frameIndex)) {
+        resizeSamples_.push_back(milliseconds);
+    }
+}
+
+void Benchmark::AddCullSample(uint32_t frameIndex, double milliseconds, uint32_t testedCount, uint32_t visibleCount)
+{
+    if (IsMeasured(frameIndex)) {
+        cullSamples_.push_back(milliseconds);
+        testedCount_ += testedCount;
+        visibleCount_ += visibleCount;
+    }
+}
+
+void Benchmark::AddLightCullSample(uint32_t frameIndex, double milliseconds, uint32_t lightCount,
+    uint32_t clusterCount, uint32_t occupiedClusters, uint32_t assignedLights)
+{
+    if (IsMeasured(frameIndex)) {
+        lightCullSamples_.push_back(milliseconds);
+        lightCount_ += lightCount;
+        clusterCount_ += clusterCount;
+        occupiedClusters_ += occupiedClusters;
+        assignedLights_ += assignedLights;
+    }
+}
+
+void Benchmark::AddShadowSample(uint32_t frameIndex, const std::vector<uint32_t>& cascadeDraws, uint32_t cacheHits)
+{
+    if (IsMeasured(frameIndex)) {
+        shadowDraws_.resize(cascadeDraws.size(), 0);
+        for (size_t i = 0; i < cascadeDraws.size(); i++) {
+            shadowDraws_[i] += cascadeDraws[i];
+        }
+        shadowFrames_++;
+        shadowCacheHits_ += cacheHits;
+    }
+}
+
+void Benchmark::AddPassSample(uint32_t frameIndex, const std::string& pass, double milliseconds)
+{
+    if (!IsMeasured(frameIndex)) {
+        return;
+    }
+
+    auto iter = std::find(passNames_.begin(), passNames_.end(), pass);
+    if (iter == passNames_.end()) {
+        passNames_.push_back(pass);
+        passSamples_.emplace_back().reserve(measuredFrames_);
+        iter = passNames_.end() - 1;
+    }
+    passSamples_[iter - passNames_.begin()].push_back(milliseconds);
+}
+
+void Benchmark::SetStartup(double timeToFirstFrame, const std::vector<StartupPhase>& phases)
+{
+    timeToFirstFrame_ = timeToFirstFrame;
+    startupPhases_ = phases;
+}
+
+void Benchmark::SetFramesInFlight(uint32_t framesInFlight, bool timelineSemaphore)
+{
+    framesInFlight_ = framesInFlight;
+    timelineSemaphore_ = timelineSemaphore;
+}
+
+void Benchmark::SetUploadStats(uint64_t directBytes, uint64_t stagedBytes)
+{
+    directUploadBytes_ = directBytes;
+    stagedUploadBytes_ = stagedBytes;
+}
+
+void Benchmark::SetModelStats(uint32_t meshes, uint32_t primitives, uint32_t draws, uint64_t mappedBytes)
+{
+    modelMeshes_ = meshes;
+    modelPrimitives_ = primitives;
+    modelDraws_ = draws;
+    modelMappedBytes_ = mappedBytes;
+}
+
+void Benchmark::SampleMemory(VmaAllocator allocator)
+{
+    const VkPhysicalDeviceMemoryProperties* memoryProperties;
+    vmaGetMemoryProperties(allocator, &memoryProperties);
+
+    std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    memoryUsage_ = 0;
+    memoryBudget_ = 0;
+    allocationBytes_ = 0;
+    allocationCount_ = 0;
+    for (const auto& budget : budgets) {
+        memoryUsage_ += budget.usage;
+        memoryBudget_ += budget.budget;
+        allocationBytes_ += budget.statistics.allocationBytes;
+        allocationCount_ += budget.statistics.allocationCount;
+    }
+}
+
+BenchmarkResult Benchmark::GetResult() const
+{
+    BenchmarkResult result{};
+    result.warmupFrames = warmupFrames_;
+    result.measuredFrames = static_cast<uint32_t>(cpuSamples_.size());
+    result.timestep = timestep_;
+    result.framesInFlight = framesInFlight_;
+    result.timelineSemaphore = timelineSemaphore_;
+    result.cpu = ComputeStats(cpuSamples_);
+    result.gpu = ComputeStats(gpuSamples_);
+    result.inputToGpuComplete = ComputeStats(latencySamples_);
+    result.resize = ComputeStats(resizeSamples_);
+    result.cull = ComputeStats(cullSamples_);
+    result.lightCull = ComputeStats(lightCullSamples_);
+    for (size_t i = 0; i < passNames_.size(); i++) {
+        result.passGpu.emplace_back(passNames_[i], ComputeStats(passSamples_[i]));
+    }
+    result.timeToFirstFrame = timeToFirstFrame_;
+    result.startupPhases = startupPhases_;
+    result.drawsPerFrame = cpuSamples_.empty() ? 0.0 :
+        static_cast<double>(drawCount_) / static_cast<double>(cpuSamples_.size());
+    result.testedPerFrame = cullSamples_.empty() ? 0.0 :
+        static_cast<double>(testedCount_) / static_cast<double>(cullSamples_.size());
+    result.visiblePerFrame = cullSamples_.empty() ? 0.0 :
+        static_cast<double>(visibleCount_) / static_cast<double>(cullSamples_.size());
+    result.lightsPerFrame = lightCullSamples_.empty() ? 0.0 :
+        static_cast<double>(lightCount_) / static_cast<double>(lightCullSamples_.size());
+    result.clusterOccupancy = clusterCount_ == 0 ? 0.0 :
+        static_cast<double>(occupiedClusters_) / static_cast<double>(clusterCount_);
+    result.lightsPerOccupiedCluster = occupiedClusters_ == 0 ? 0.0 :
+        static_cast<double>(assignedLights_) / static_cast<double>(occupiedClusters_);
+    for (auto draws : shadowDraws_) {
+        result.shadowDrawsPerCascade.push_back(static_cast<double>(draws) / static_cast<double>(shadowFrames_));
+    }
+    result.shadowCacheHitRate = shadowDraws_.empty() ? 0.0 :
+        static_cast<double>(shadowCacheHits_) / static_cast<double>(shadowFrames_ * shadowDraws_.size());
+    result.memoryUsage = memoryUsage_;
+    result.memoryBudget = memoryBudget_;
+    result.allocationBytes = allocationBytes_;
+    result.allocationCount = allocationCount_;
+    result.directUploadBytes = directUploadBytes_;
+    result.stagedUploadBytes = stagedUploadBytes_;
+    result.modelMeshes = modelMeshes_;
+    result.modelPrimitives = modelPrimitives_;
+    result.modelDraws = modelDraws_;
+    result.modelMappedBytes = modelMappedBytes_;
+    return result;
+}
+
+void Benchmark::WriteReport(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open report file: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    auto result = GetResult();
+    auto writeValues = [&file](const FrameTimeStats& stats) {
+        file << "{\"samples\": " << stats.samples << ", \"mean\": " << stats.mean << ", \"p50\": " << stats.p50
+            << ", \"p95\": " << stats.p95 << ", \"p99\": " << stats.p99 << ", \"max\": " << stats.max << "}";
+    };
+    auto writeStats = [&file, &writeValues](const char* name, const FrameTimeStats& stats) {
+        file << "  \"" << name << "\": ";
+        writeValues(stats);
+        file << ",\n";
+    };
+
+    file << std::fixed << std::setprecision(4);
+    file << "{\n";
+    file << "  \"warmupFrames\": " << result.warmupFrames << ",\n";
+    file << "  \"measuredFrames\": " << result.measuredFrames << ",\n";
+    file << "  \"timestep\": " << result.timestep << ",\n";
+    file << "  \"framesInFlight\": " << result.framesInFlight << ",\n";
+    file << "  \"timelineSemaphore\": " << (result.timelineSemaphore ? "true" : "false") << ",\n";
+    writeStats("cpuFrameMs", result.cpu);
+    writeStats("gpuFrameMs", result.gpu);
+    writeStats("inputToGpuCompleteMs", result.inputToGpuComplete);
+    writeStats("resizeMs", result.resize);
+    writeStats("cullMs", result.cull);
+    writeStats("lightCullMs", result.lightCull);
+    file << "  \"passGpuMs\": {";
+    for (size_t i = 0; i < result.passGpu.size(); i++) {
+        file << (i == 0 ? "\n" : ",\n") << "    \"" << result.passGpu[i].first << "\": ";
+        writeValues(result.passGpu[i].second);
+    }
+    file << (result.passGpu.empty() ? "},\n" : "\n  },\n");
+    file << "  \"startup\": {\"timeToFirstFrameMs\": " << result.timeToFirstFrame << ", \"phases\": [";
+    for (size_t i = 0; i < result.startupPhases.size(); i++) {
+        const auto& phase = result.startupPhases[i];
+        file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << phase.name << "\", \"beginMs\": " << phase.beginMs
+            << ", \"endMs\": " << phase.endMs << "}";
+    }
+    file << (result.startupPhases.empty() ? "]},\n" : "\n  ]},\n");
+    file << "  \"drawsPerFrame\": " << result.drawsPerFrame << ",\n";
+    file << "  \"objectsTestedPerFrame\": " << result.testedPerFrame << ",\n";
+    file << "  \"objectsVisiblePerFrame\": " << result.visiblePerFrame << ",\n";
+    file << "  \"lightCount\": " << result.lightsPerFrame << ",\n";
+    file << "  \"clusterOccupancy\": " << result.clusterOccupancy << ",\n";
+    file << "  \"lightsPerOccupiedCluster\": " << result.lightsPerOccupiedCluster << ",\n";
+    file << "  \"shadowDrawsPerCascade\": [";
+    for (size_t i = 0; i < result.shadowDrawsPerCascade.size(); i++) {
+        file << (i == 0 ? "" : ", ") << result.shadowDrawsPerCascade[i];
+    }
+    file << "],\n";
+    file << "  \"shadowCacheHitRate\": " << result.shadowCacheHitRate << ",\n";
+    file << "  \"memory\": {\"usageBytes\": " << result.memoryUsage << ", \"budgetBytes\": " << result.memoryBudget
+        << ", \"allocationBytes\": " << result.allocationBytes << ", \"allocationCount\": "
+        << result.allocationCount << "},\n";
+    file << "  \"uploads\": {\"directBytes\": " << result.directUploadBytes << ", \"stagedBytes\": "
+        << result.stagedUploadBytes << "},\n";
+    file << "  \"model\": {\"meshes\": " << result.modelMeshes << ", \"primitives\": " << result.modelPrimitives
+        << ", \"draws\": " << result.modelDraws << ", \"mappedBytes\": " << result.modelMappedBytes << "}\n";
+    file << "}\n";
+}
+
+void Benchmark::PrintSummary() const
+{
+    auto result = GetResult();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Benchmark: " << result.measuredFrames << " frames after " << result.warmupFrames << " warm-up"
+        << std::endl;
+    std::cout << "  Frames in flight: " << result.framesInFlight << " ("
+        << (result.timelineSemaphore ? "timeline semaphore" : "fences") << ")" << std::endl;
+    std::cout << "  CPU ms p50/p95/p99: " << result.cpu.p50 << " / " << result.cpu.p95 << " / " << result.cpu.p99
+        << std::endl;
+    std::cout << "  GPU ms p50/p95/p99: " << result.gpu.p50 << " / " << result.gpu.p95 << " / " << result.gpu.p99
+        << std::endl;
+    std::cout << "  Time to first frame ms: " << result.timeToFirstFrame << std::endl;
+    std::cout << "  Input to GPU complete ms p50/p95/p99: " << result.inputToGpuComplete.p50 << " / "
+        << result.inputToGpuComplete.p95 << " / " << result.inputToGpuComplete.p99 << std::endl;
+    if (result.resize.samples > 0) {
+        std::cout << "  Resize ms p50/p95/max: " << result.resize.p50 << " / " << result.resize.p95 << " / "
+            << result.resize.max << " over " << result.resize.samples << " resizes" << std::endl;
+    }
+    if (result.cull.samples > 0) {
+        std::cout << "  Cull ms p50/p95/p99: " << result.cull.p50 << " / " << result.cull.p95 << " / "
+            << result.cull.p99 << " (" << result.visiblePerFrame << " of " << result.testedPerFrame
+            << " objects visible)" << std::endl;
+    }
+    if (result.lightCull.samples > 0) {
+        std::cout << "  Light cull ms p50/p95/p99: " << result.lightCull.p50 << " / " << result.lightCull.p95 << " / "
+            << result.lightCull.p99 << " (" << result.lightsPerFrame << " lights, "
+            << result.clusterOccupancy * 100.0 << "% clusters occupied, " << result.lightsPerOccupiedCluster
+            << " lights per occupied cluster)" << std::endl;
+    }
+    if (!result.shadowDrawsPerCascade.empty()) {
+        std::cout << "  Shadow casters per cascade:";
+        for (auto draws : result.shadowDrawsPerCascade) {
+            std::cout << " " << draws;
+        }
+        std::cout << " (cache hit rate " << result.shadowCacheHitRate * 100.0 << "%)" << std::endl;
+    }
+    for (const auto& [pass, stats] : result.passGpu) {
+        std::cout << "  Pass " << pass << " GPU ms p50/p95/p99: " << stats.p50 << " / " << stats.p95 << " / "
+            << stats.p99 << std::endl;
+    }
+    std::cout << "  Draws per frame: " << result.drawsPerFrame << std::endl;
+    std::cout << "  Memory usage: " << result.memoryUsage / (1024 * 1024) << " MiB" << std::endl;
+    std::cout << "  Asset uploads: " << (result.directUploadBytes >> 10) << " KiB direct, "
+        << (result.stagedUploadBytes >> 10) << " KiB staged" << std::endl;
+    std::cout << "  Model: " << result.modelMeshes << " meshes, " << result.modelPrimitives << " primitives, "
+        << result.modelDraws << " draws, " << (result.modelMappedBytes >> 10) << " KiB mapped" << std::endl;
+}
+
+FrameTimeStats Benchmark::ComputeStats(std::vector<double> samples)
+{
+    FrameTimeStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+
+    stats.samples = static_cast<uint32_t>(samples.size());
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+bool Benchmark::IsMeasured(uint32_t frameIndex) const
+{
+    return frameIndex >= warmupFrames_ && frameIndex < warmupFrames_ + measuredFrames_;
+}
\ No newline at end of file
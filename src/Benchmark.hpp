@@ -0,0 +1,84 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <vk_mem_alloc.h>
+
+#include "StartupTimer.hpp"
+
+struct FrameTimeStats {
+    uint32_t samples = 0;
+    double mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+struct BenchmarkResult {
+    uint32_t warmupFrames, measuredFrames;
+    float timestep;
+    uint32_t framesInFlight;
+    bool timelineSemaphore;
+    FrameTimeStats cpu, gpu, inputToGpuComplete, resize, cull, lightCull;
+    std::vector<std::pair<std::string, FrameTimeStats>> passGpu;
+    double timeToFirstFrame;
+    std::vector<StartupPhase> startupPhases;
+    double drawsPerFrame, testedPerFrame, visiblePerFrame;
+    double lightsPerFrame, clusterOccupancy, lightsPerOccupiedCluster;
+    std::vector<double> shadowDrawsPerCascade;
+    double shadowCacheHitRate;
+    uint64_t memoryUsage, memoryBudget, allocationBytes;
+    uint32_t allocationCount;
+    uint64_t directUploadBytes, stagedUploadBytes;
+    uint32_t modelMeshes, modelPrimitives, modelDraws;
+    uint64_t modelMappedBytes;
+};
+
+class Benchmark {
+public:
+    Benchmark(uint32_t warmupFrames, uint32_t measuredFrames, float timestep);
+
+    void AddCpuSample(uint32_t frameIndex, double milliseconds, uint32_t drawCount);
+    void AddGpuSample(uint32_t frameIndex, double milliseconds);
+    void AddLatencySample(uint32_t frameIndex, double milliseconds);
+    void AddResizeSample(uint32_t frameIndex, double milliseconds);
+    void AddCullSample(uint32_t frameIndex, double milliseconds, uint32_t testedCount, uint32_t visibleCount);
+    void AddLightCullSample(uint32_t frameIndex, double milliseconds, uint32_t lightCount, uint32_t clusterCount,
+        uint32_t occupiedClusters, uint32_t assignedLights);
+    void AddShadowSample(uint32_t frameIndex, const std::vector<uint32_t>& cascadeDraws, uint32_t cacheHits);
+    void AddPassSample(uint32_t frameIndex, const std::string& pass, double milliseconds);
+    void SetStartup(double timeToFirstFrame, const std::vector<StartupPhase>& phases);
+    void SetFramesInFlight(uint32_t framesInFlight, bool timelineSemaphore);
+    void SetUploadStats(uint64_t directBytes, uint64_t stagedBytes);
+    void SetModelStats(uint32_t meshes, uint32_t primitives, uint32_t draws, uint64_t mappedBytes);
+    void SampleMemory(VmaAllocator allocator);
+    BenchmarkResult GetResult() const;
+    void WriteReport(const std::string& path) const;
+    void PrintSummary() const;
+
+private:
+    static FrameTimeStats ComputeStats(std::vector<double> samples);
+    bool IsMeasured(uint32_t frameIndex) const;
+
+    uint32_t warmupFrames_, measuredFrames_;
+    float timestep_;
+    uint32_t framesInFlight_ = 0;
+    bool timelineSemaphore_ = false;
+    std::vector<double> cpuSamples_, gpuSamples_, latencySamples_, resizeSamples_, cullSamples_, lightCullSamples_;
+    uint64_t drawCount_ = 0, testedCount_ = 0, visibleCount_ = 0;
+    uint64_t lightCount_ = 0, clusterCount_ = 0, occupiedClusters_ = 0, assignedLights_ = 0;
+    std::vector<std::string> passNames_;
+    std::vector<std::vector<double>> passSamples_;
+    double timeToFirstFrame_ = 0.0;
+    std::vector<StartupPhase> startupPhases_;
+    std::vector<uint64_t> shadowDraws_;
+    uint64_t shadowFrames_ = 0, shadowCacheHits_ = 0;
+    uint64_t memoryUsage_ = 0, memoryBudget_ = 0, allocationBytes_ = 0;
+    uint32_t allocationCount_ = 0;
+    uint64_t directUploadBytes_ = 0, stagedUploadBytes_ = 0;
+    uint32_t modelMeshes_ = 0, modelPrimitives_ = 0, modelDraws_ = 0;
+    uint64_t modelMappedBytes_ = 0;
+};
+
+#endif
\ No newline at end of file
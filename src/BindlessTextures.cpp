@@ -0,0 +1,111 @@
+#include "BindlessTextures.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "VulkanContext.hpp"
+
+bool BindlessTextures::IsSupported()
+{
+    const auto& features = VulkanContext::Instance().GetDeviceFeatures();
+    return features.descriptorIndexing && features.maxBindlessTextures > 0;
+}
+
+BindlessTextures::BindlessTextures(uint32_t capacity) :
+    capacity_(std::min(capacity, VulkanContext::Instance().GetDeviceFeatures().maxBindlessTextures))
+{
+    auto device = VulkanContext::Instance().GetDevice();
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = capacity_;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    VULKAN_CHECK(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout_));
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = capacity_;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    VULKAN_CHECK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool_));
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = descriptorPool_;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &descriptorSetLayout_;
+    VULKAN_CHECK(vkAllocateDescriptorSets(device, &allocateInfo, &descriptorSet_));
+}
+
+BindlessTextures::~BindlessTextures()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    vkDestroyDescriptorPool(device, descriptorPool_, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout_, nullptr);
+}
+
+VkDescriptorSetLayout BindlessTextures::GetDescriptorSetLayout() const
+{
+    return descriptorSetLayout_;
+}
+
+VkDescriptorSet BindlessTextures::GetDescriptorSet() const
+{
+    return descriptorSet_;
+}
+
+uint32_t BindlessTextures::GetCapacity() const
+{
+    return capacity_;
+}
+
+uint32_t BindlessTextures::GetTextureCount() const
+{
+    return textureCount_;
+}
+
+uint32_t BindlessTextures::Register(const VkDescriptorImageInfo& imageInfo)
+{
+    if (textureCount_ >= capacity_) {
+        std::cerr << "Bindless texture table is full: " << capacity_ << " textures" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    auto textureIndex = textureCount_++;
+    Update(textureIndex, imageInfo);
+    return textureIndex;
+}
+
+void BindlessTextures::Update(uint32_t textureIndex, const VkDescriptorImageInfo& imageInfo)
+{
+    VkWriteDescriptorSet writeDescriptorSet{};
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSet.dstSet = descriptorSet_;
+    writeDescriptorSet.dstBinding = 0;
+    writeDescriptorSet.dstArrayElement = textureIndex;
+    writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(VulkanContext::Instance().GetDevice(), 1, &writeDescriptorSet, 0, nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef BINDLESS_TEXTURES_HPP
+#define BINDLESS_TEXTURES_HPP
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+class BindlessTextures {
+public:
+    static bool IsSupported();
+
+    BindlessTextures(uint32_t capacity);
+    ~BindlessTextures();
+
+    BindlessTextures(const BindlessTextures&) = delete;
+    BindlessTextures& operator=(const BindlessTextures&) = delete;
+
+    VkDescriptorSetLayout GetDescriptorSetLayout() const;
+    VkDescriptorSet GetDescriptorSet() const;
+    uint32_t GetCapacity() const;
+    uint32_t GetTextureCount() const;
+    uint32_t Register(const VkDescriptorImageInfo& imageInfo);
+    void Update(uint32_t textureIndex, const VkDescriptorImageInfo& imageInfo);
+
+private:
+    uint32_t capacity_;
+    uint32_t textureCount_ = 0;
+    VkDescriptorSetLayout descriptorSetLayout_;
+    VkDescriptorPool descriptorPool_;
+    VkDescriptorSet descriptorSet_;
+};
+
+#endif
\ No newline at end of file
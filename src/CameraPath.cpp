@@ -0,0 +1,83 @@
+#include "CameraPath.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+CameraPath CameraPath::Orbit(const glm::vec3& target, float radius, float height, float period,
+    uint32_t keyframeCount)
+{
+    CameraPath path;
+    for (uint32_t i = 0; i <= keyframeCount; i++) {
+        float t = static_cast<float>(i) / static_cast<float>(keyframeCount);
+        float angle = t * 2.0f * glm::pi<float>();
+        glm::vec3 eye = target + glm::vec3(radius * std::cos(angle), radius * std::sin(angle), height);
+        path.AddKeyframe(t * period, eye, target);
+    }
+    return path;
+}
+
+void CameraPath::AddKeyframe(float time, const glm::vec3& eye, const glm::vec3& target)
+{
+    auto iter = std::upper_bound(keyframes_.begin(), keyframes_.end(), time,
+        [](float value, const CameraKeyframe& keyframe) {
+            return value < keyframe.time;
+        }
+    );
+    keyframes_.insert(iter, {time, eye, target});
+}
+
+bool CameraPath::IsEmpty() const
+{
+    return keyframes_.empty();
+}
+
+float CameraPath::GetDuration() const
+{
+    return keyframes_.empty() ? 0.0f : keyframes_.back().time - keyframes_.front().time;
+}
+
+glm::mat4 CameraPath::Evaluate(float time) const
+{
+    const glm::vec3 up(0.0f, 0.0f, 1.0f);
+    if (keyframes_.empty()) {
+        return glm::mat4(1.0f);
+    } else if (keyframes_.size() == 1) {
+        return glm::lookAt(keyframes_[0].eye, keyframes_[0].target, up);
+    }
+
+    float duration = GetDuration();
+    float local = keyframes_.front().time;
+    if (duration > 0.0f) {
+        local += std::fmod(std::max(time, 0.0f), duration);
+    }
+
+    auto iter = std::upper_bound(keyframes_.begin(), keyframes_.end(), local,
+        [](float value, const CameraKeyframe& keyframe) {
+            return value < keyframe.time;
+        }
+    );
+    auto last = static_cast<int32_t>(keyframes_.size()) - 1;
+    auto i1 = std::clamp(static_cast<int32_t>(iter - keyframes_.begin()) - 1, 0, last - 1);
+    auto i0 = std::max(i1 - 1, 0);
+    auto i2 = i1 + 1;
+    auto i3 = std::min(i2 + 1, last);
+
+    float span = keyframes_[i2].time - keyframes_[i1].time;
+    float t = span > 0.0f ? std::clamp((local - keyframes_[i1].time) / span, 0.0f, 1.0f) : 0.0f;
+    auto eye = CatmullRom(keyframes_[i0].eye, keyframes_[i1].eye, keyframes_[i2].eye, keyframes_[i3].eye, t);
+    auto target = CatmullRom(keyframes_[i0].target, keyframes_[i1].target, keyframes_[i2].target,
+        keyframes_[i3].target, t);
+    return glm::lookAt(eye, target, up);
+}
+
+glm::vec3 CameraPath::CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+    float t)
+{
+    float t2 = t * t;
+    float t3 = t2 * t;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+        (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef CAMERA_PATH_HPP
+#define CAMERA_PATH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct CameraKeyframe {
+    float time;
+    glm::vec3 eye, target;
+};
+
+class CameraPath {
+public:
+    static CameraPath Orbit(const glm::vec3& target, float radius, float height, float period, uint32_t keyframeCount);
+
+    void AddKeyframe(float time, const glm::vec3& eye, const glm::vec3& target);
+    bool IsEmpty() const;
+    float GetDuration() const;
+    glm::mat4 Evaluate(float time) const;
+
+private:
+    static glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+        float t);
+
+    std::vector<CameraKeyframe> keyframes_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "CaptureSinks.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <stb_image_write.h>
+
+#include "Profiler.hpp"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace {
+
+void ConvertToRgba(CapturedFrame& frame)
+{
+    if (frame.format != VK_FORMAT_B8G8R8A8_UNORM && frame.format != VK_FORMAT_B8G8R8A8_SRGB) {
+        return;
+    }
+
+    for (size_t i = 0; i < frame.pixels.size(); i += 4) {
+        std::swap(frame.pixels[i], frame.pixels[i + 2]);
+    }
+    frame.format = frame.format == VK_FORMAT_B8G8R8A8_SRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+}
+
+CaptureWriter::CaptureWriter(const std::string& name, uint32_t maxQueuedFrames, Write write) :
+    name_(name),
+    maxQueuedFrames_(maxQueuedFrames),
+    write_(std::move(write)),
+    thread_(&CaptureWriter::WriterLoop, this) {}
+
+CaptureWriter::~CaptureWriter()
+{
+    Stop();
+}
+
+void CaptureWriter::Consume(CapturedFrame&& frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= maxQueuedFrames_) {
+            droppedCount_++;
+            return;
+        }
+        queue_.push_back(std::move(frame));
+    }
+    condition_.notify_one();
+}
+
+void CaptureWriter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_one();
+    if (!thread_.joinable()) {
+        return;
+    }
+    thread_.join();
+
+    if (droppedCount_ > 0) {
+        std::cerr << name_ << " dropped " << droppedCount_ << " frames" << std::endl;
+    }
+}
+
+void CaptureWriter::WriterLoop()
+{
+    if (Profiler::Instance().IsEnabled()) {
+        Profiler::Instance().SetThreadName(name_);
+    }
+
+    while (true) {
+        CapturedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() {
+                return stopping_ || !queue_.empty();
+            });
+            if (queue_.empty()) {
+                return;
+            }
+            frame = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        PROFILE_SCOPE("WriteCapture");
+        write_(frame);
+    }
+}
+
+RawFileSink::RawFileSink(const std::string& path, uint32_t maxQueuedFrames) :
+    file_(path, std::ios::binary),
+    writer_("RawWriter", maxQueuedFrames, [this](CapturedFrame& frame) {
+        file_.write(reinterpret_cast<const char*>(frame.pixels.data()),
+            static_cast<std::streamsize>(frame.pixels.size()));
+    })
+{
+    if (!file_.is_open()) {
+        std::cerr << "Failed to open capture file: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+void RawFileSink::Consume(CapturedFrame&& frame)
+{
+    writer_.Consume(std::move(frame));
+}
+
+PngWriterSink::PngWriterSink(const std::string& directory, uint32_t maxQueuedFrames) :
+    directory_(directory),
+    writer_("PngWriter", maxQueuedFrames, [this](CapturedFrame& frame) { Write(frame); }) {}
+
+void PngWriterSink::Consume(CapturedFrame&& frame)
+{
+    writer_.Consume(std::move(frame));
+}
+
+void PngWriterSink::Write(CapturedFrame& frame) const
+{
+    ConvertToRgba(frame);
+    std::ostringstream path;
+    path << directory_ << "/frame_" << std::setw(6) << std::setfill('0') << frame.frameIndex << ".png";
+    if (!stbi_write_png(path.str().c_str(), static_cast<int>(frame.width), static_cast<int>(frame.height), 4,
+        frame.pixels.data(), static_cast<int>(frame.width * 4))) {
+        std::cerr << "Failed to write image: " << path.str() << std::endl;
+    }
+}
+
+PipeSink::PipeSink(const std::string& command, uint32_t maxQueuedFrames) :
+    pipe_(popen(command.c_str(), "w")),
+    writer_("PipeWriter", maxQueuedFrames, [this](CapturedFrame& frame) {
+        fwrite(frame.pixels.data(), 1, frame.pixels.size(), pipe_);
+    })
+{
+    if (pipe_ == nullptr) {
+        std::cerr << "Failed to open capture pipe: " << command << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+PipeSink::~PipeSink()
+{
+    writer_.Stop();
+    pclose(pipe_);
+}
+
+void PipeSink::Consume(CapturedFrame&& frame)
+{
+    writer_.Consume(std::move(frame));
+}
\ No newline at end of file
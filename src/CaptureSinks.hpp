@@ -0,0 +1,75 @@
+#ifndef CAPTURE_SINKS_HPP
+#define CAPTURE_SINKS_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "FrameCapture.hpp"
+
+class CaptureWriter {
+public:
+    using Write = std::function<void(CapturedFrame& frame)>;
+
+    CaptureWriter(const std::string& name, uint32_t maxQueuedFrames, Write write);
+    ~CaptureWriter();
+
+    void Consume(CapturedFrame&& frame);
+    void Stop();
+
+private:
+    void WriterLoop();
+
+    std::string name_;
+    uint32_t maxQueuedFrames_;
+    Write write_;
+    std::deque<CapturedFrame> queue_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_ = false;
+    uint32_t droppedCount_ = 0;
+    std::thread thread_;
+};
+
+class RawFileSink {
+public:
+    RawFileSink(const std::string& path, uint32_t maxQueuedFrames);
+
+    void Consume(CapturedFrame&& frame);
+
+private:
+    std::ofstream file_;
+    CaptureWriter writer_;
+};
+
+class PngWriterSink {
+public:
+    PngWriterSink(const std::string& directory, uint32_t maxQueuedFrames);
+
+    void Consume(CapturedFrame&& frame);
+
+private:
+    void Write(CapturedFrame& frame) const;
+
+    std::string directory_;
+    CaptureWriter writer_;
+};
+
+class PipeSink {
+public:
+    PipeSink(const std::string& command, uint32_t maxQueuedFrames);
+    ~PipeSink();
+
+    void Consume(CapturedFrame&& frame);
+
+private:
+    FILE* pipe_;
+    CaptureWriter writer_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,684 @@
+#include "CascadedShadowMaps.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Profiler.hpp"
+#include "Vertex.hpp"
+#include "VulkanContext.hpp"
+
+CascadedShadowMaps::CascadedShadowMaps(uint32_t resolution, float nearPlane, float farPlane,
+    const glm::vec3& lightDirection, ThreadPool* threadPool) :
+    resolution_(resolution),
+    nearPlane_(nearPlane),
+    farPlane_(farPlane),
+    lightDirection_(glm::normalize(lightDirection)),
+    culler_(threadPool),
+    totalStaticDraws_(CASCADE_COUNT, 0),
+    totalDynamicDraws_(CASCADE_COUNT, 0)
+{
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        auto fraction = static_cast<float>(i + 1) / static_cast<float>(CASCADE_COUNT);
+        auto uniformSplit = nearPlane_ + (farPlane_ - nearPlane_) * fraction;
+        auto logarithmicSplit = nearPlane_ * std::pow(farPlane_ / nearPlane_, fraction);
+        splitDepths_[i] = SPLIT_LAMBDA * logarithmicSplit + (1.0f - SPLIT_LAMBDA) * uniformSplit;
+    }
+    stats_.staticDraws.resize(CASCADE_COUNT, 0);
+    stats_.dynamicDraws.resize(CASCADE_COUNT, 0);
+
+    CreateImages();
+    CreateRenderPasses();
+    CreateFramebuffers();
+    CreateSampler();
+    CreateDescriptorSet();
+    CreatePipeline();
+}
+
+CascadedShadowMaps::~CascadedShadowMaps()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+    auto allocator = context.GetAllocator();
+
+    vkDestroyPipeline(device, pipeline_, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout_, nullptr);
+    vkDestroyShaderModule(device, shaderModule_, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool_, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout_, nullptr);
+    vmaDestroyBuffer(allocator, parameterBuffer_, parameterAllocation_);
+    vkDestroySampler(device, sampler_, nullptr);
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        vkDestroyFramebuffer(device, compositeFramebuffers_[i], nullptr);
+        vkDestroyFramebuffer(device, staticFramebuffers_[i], nullptr);
+        vkDestroyImageView(device, shadowLayerViews_[i], nullptr);
+        vkDestroyImageView(device, staticLayerViews_[i], nullptr);
+    }
+    vkDestroyRenderPass(device, compositeRenderPass_, nullptr);
+    vkDestroyRenderPass(device, staticRenderPass_, nullptr);
+    vkDestroyImageView(device, shadowImageView_, nullptr);
+    vmaDestroyImage(allocator, staticImage_, staticAllocation_);
+    vmaDestroyImage(allocator, shadowImage_, shadowAllocation_);
+}
+
+void CascadedShadowMaps::SetLightDirection(const glm::vec3& lightDirection)
+{
+    lightDirection_ = glm::normalize(lightDirection);
+}
+
+void CascadedShadowMaps::MarkDynamic(uint32_t batch, uint32_t instance)
+{
+    if (batch >= dynamicCasters_.size()) {
+        dynamicCasters_.resize(batch + 1);
+    }
+    auto& flags = dynamicCasters_[batch];
+    if (instance >= flags.size()) {
+        flags.resize(instance + 1, 0);
+    }
+    if (flags[instance] == 0) {
+        flags[instance] = 1;
+        dynamicCasterCount_++;
+        Invalidate();
+    }
+}
+
+void CascadedShadowMaps::Record(VkCommandBuffer commandBuffer,
+    const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches, const glm::mat4& model,
+    const glm::mat4& view, const glm::mat4& projection)
+{
+    PROFILE_SCOPE("RecordShadowMaps");
+
+    UpdateCasterFlags(instanceBatches);
+    FitCascades(model, view, projection);
+
+    ShadowParameters parameters{};
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        parameters.lightViewProjections[i] = cascades_[i].viewProjection;
+        parameters.splitDepths[i] = splitDepths_[i];
+    }
+    parameters.lightDirection = glm::vec4(glm::normalize(glm::mat3(model) * -lightDirection_), 0.0f);
+    parameters.lightColor = glm::vec4(1.0f, 0.95f, 0.9f, 1.0f);
+    parameters.cameraPosition = glm::inverse(view)[3];
+    parameters.depthRange = glm::vec2(nearPlane_, farPlane_);
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+        nullptr, 0, nullptr, 0, nullptr);
+    vkCmdUpdateBuffer(commandBuffer, parameterBuffer_, 0, sizeof(parameters), &parameters);
+
+    VkMemoryBarrier parameterBarrier{};
+    parameterBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    parameterBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    parameterBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1,
+        &parameterBarrier, 0, nullptr, 0, nullptr);
+
+    VkClearValue clearValue{};
+    clearValue.depthStencil = {1.0f, 0};
+
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = {resolution_, resolution_};
+
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(resolution_);
+    viewport.height = static_cast<float>(resolution_);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = {resolution_, resolution_};
+
+    VkImageMemoryBarrier layerBarrier{};
+    layerBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    layerBarrier.srcAccessMask = 0;
+    layerBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    layerBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    layerBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    layerBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    layerBarrier.image = shadowImage_;
+
+    VkImageCopy copyRegion{};
+    copyRegion.srcSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1};
+    copyRegion.dstSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1};
+    copyRegion.extent = {resolution_, resolution_, 1};
+
+    stats_.cacheHits = 0;
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        auto& cascade = cascades_[i];
+        stats_.staticDraws[i] = 0;
+        stats_.dynamicDraws[i] = 0;
+        if (cascade.refresh) {
+            renderPassInfo.renderPass = staticRenderPass_;
+            renderPassInfo.framebuffer = staticFramebuffers_[i];
+            renderPassInfo.clearValueCount = 1;
+            renderPassInfo.pClearValues = &clearValue;
+            vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+            stats_.staticDraws[i] = DrawCasters(commandBuffer, instanceBatches, cascade, false);
+            vkCmdEndRenderPass(commandBuffer);
+            cascade.valid = cascade.valid && allResident_;
+            refreshes_++;
+        } else {
+            stats_.cacheHits++;
+        }
+
+        if (cascade.composed && !cascade.refresh && dynamicCasterCount_ == 0 && cascade.dynamicDraws == 0) {
+            continue;
+        }
+
+        layerBarrier.oldLayout = cascade.composed ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL :
+            VK_IMAGE_LAYOUT_UNDEFINED;
+        layerBarrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, i, 1};
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &layerBarrier);
+
+        copyRegion.srcSubresource.baseArrayLayer = i;
+        copyRegion.dstSubresource.baseArrayLayer = i;
+        vkCmdCopyImage(commandBuffer, staticImage_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, shadowImage_,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+        renderPassInfo.renderPass = compositeRenderPass_;
+        renderPassInfo.framebuffer = compositeFramebuffers_[i];
+        renderPassInfo.clearValueCount = 0;
+        renderPassInfo.pClearValues = nullptr;
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        if (dynamicCasterCount_ > 0) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+            stats_.dynamicDraws[i] = DrawCasters(commandBuffer, instanceBatches, cascade, true);
+        }
+        vkCmdEndRenderPass(commandBuffer);
+
+        cascade.dynamicDraws = stats_.dynamicDraws[i];
+        cascade.composed = true;
+    }
+
+    frameCount_++;
+    cacheHits_ += stats_.cacheHits;
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        totalStaticDraws_[i] += stats_.staticDraws[i];
+        totalDynamicDraws_[i] += stats_.dynamicDraws[i];
+    }
+}
+
+VkDescriptorSetLayout CascadedShadowMaps::GetDescriptorSetLayout() const
+{
+    return descriptorSetLayout_;
+}
+
+VkDescriptorSet CascadedShadowMaps::GetDescriptorSet() const
+{
+    return descriptorSet_;
+}
+
+const ShadowStats& CascadedShadowMaps::GetStats() const
+{
+    return stats_;
+}
+
+void CascadedShadowMaps::PrintStats() const
+{
+    if (frameCount_ == 0) {
+        return;
+    }
+
+    auto frames = static_cast<double>(frameCount_);
+    std::cout << "Shadow maps: " << CASCADE_COUNT << " cascades of " << resolution_ << "x" << resolution_
+        << ", cache hit rate " << static_cast<double>(cacheHits_) / (frames * CASCADE_COUNT) * 100.0 << "%, "
+        << refreshes_ << " static refreshes, " << invalidations_ << " invalidations, " << dynamicCasterCount_
+        << " dynamic casters" << std::endl;
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        std::cout << "  Cascade " << i << " (to " << splitDepths_[i] << "): "
+            << static_cast<double>(totalStaticDraws_[i]) / frames << " static + "
+            << static_cast<double>(totalDynamicDraws_[i]) / frames << " dynamic casters per frame" << std::endl;
+    }
+}
+
+void CascadedShadowMaps::CreateImages()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    VkImageCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    createInfo.imageType = VK_IMAGE_TYPE_2D;
+    createInfo.extent = {resolution_, resolution_, 1};
+    createInfo.mipLevels = 1;
+    createInfo.arrayLayers = CASCADE_COUNT;
+    createInfo.format = VK_FORMAT_D32_SFLOAT;
+    createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocationInfo{};
+    allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+    createInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    VULKAN_CHECK(vmaCreateImage(context.GetAllocator(), &createInfo, &allocationInfo, &shadowImage_,
+        &shadowAllocation_, nullptr));
+    createInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    VULKAN_CHECK(vmaCreateImage(context.GetAllocator(), &createInfo, &allocationInfo, &staticImage_,
+        &staticAllocation_, nullptr));
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = shadowImage_;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = VK_FORMAT_D32_SFLOAT;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, CASCADE_COUNT};
+    VULKAN_CHECK(vkCreateImageView(device, &viewInfo, nullptr, &shadowImageView_));
+
+    shadowLayerViews_.resize(CASCADE_COUNT);
+    staticLayerViews_.resize(CASCADE_COUNT);
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, i, 1};
+        viewInfo.image = shadowImage_;
+        VULKAN_CHECK(vkCreateImageView(device, &viewInfo, nullptr, &shadowLayerViews_[i]));
+        viewInfo.image = staticImage_;
+        VULKAN_CHECK(vkCreateImageView(device, &viewInfo, nullptr, &staticLayerViews_[i]));
+    }
+}
+
+void CascadedShadowMaps::CreateRenderPasses()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = VK_FORMAT_D32_SFLOAT;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 0;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+    std::vector<VkSubpassDependency> subpassDependencies(2);
+    subpassDependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    subpassDependencies[0].dstSubpass = 0;
+    subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    subpassDependencies[0].srcAccessMask = 0;
+    subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    subpassDependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    subpassDependencies[1].srcSubpass = 0;
+    subpassDependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    subpassDependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    subpassDependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    subpassDependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    VkRenderPassCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    createInfo.attachmentCount = 1;
+    createInfo.pAttachments = &depthAttachment;
+    createInfo.subpassCount = 1;
+    createInfo.pSubpasses = &subpass;
+    createInfo.dependencyCount = static_cast<uint32_t>(subpassDependencies.size());
+    createInfo.pDependencies = subpassDependencies.data();
+    VULKAN_CHECK(vkCreateRenderPass(device, &createInfo, nullptr, &staticRenderPass_));
+
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    subpassDependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    subpassDependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    VULKAN_CHECK(vkCreateRenderPass(device, &createInfo, nullptr, &compositeRenderPass_));
+}
+
+void CascadedShadowMaps::CreateFramebuffers()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+
+    VkFramebufferCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    createInfo.attachmentCount = 1;
+    createInfo.width = resolution_;
+    createInfo.height = resolution_;
+    createInfo.layers = 1;
+
+    staticFramebuffers_.resize(CASCADE_COUNT);
+    compositeFramebuffers_.resize(CASCADE_COUNT);
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        createInfo.renderPass = staticRenderPass_;
+        createInfo.pAttachments = &staticLayerViews_[i];
+        VULKAN_CHECK(vkCreateFramebuffer(device, &createInfo, nullptr, &staticFramebuffers_[i]));
+        createInfo.renderPass = compositeRenderPass_;
+        createInfo.pAttachments = &shadowLayerViews_[i];
+        VULKAN_CHECK(vkCreateFramebuffer(device, &createInfo, nullptr, &compositeFramebuffers_[i]));
+    }
+}
+
+void CascadedShadowMaps::CreateSampler()
+{
+    VkSamplerCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    createInfo.magFilter = VK_FILTER_LINEAR;
+    createInfo.minFilter = VK_FILTER_LINEAR;
+    createInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    createInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    createInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    createInfo.anisotropyEnable = VK_FALSE;
+    createInfo.maxAnisotropy = 1.0f;
+    createInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    createInfo.unnormalizedCoordinates = VK_FALSE;
+    createInfo.compareEnable = VK_TRUE;
+    createInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    createInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    createInfo.mipLodBias = 0.0f;
+    createInfo.minLod = 0.0f;
+    createInfo.maxLod = 0.0f;
+    VULKAN_CHECK(vkCreateSampler(VulkanContext::Instance().GetDevice(), &createInfo, nullptr, &sampler_));
+}
+
+void CascadedShadowMaps::CreateDescriptorSet()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    context.CreateBuffer(sizeof(ShadowParameters),
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, {}, parameterBuffer_,
+        parameterAllocation_);
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VULKAN_CHECK(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout_));
+
+    std::vector<VkDescriptorPoolSize> poolSizes = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1}
+    };
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    VULKAN_CHECK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool_));
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = descriptorPool_;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &descriptorSetLayout_;
+    VULKAN_CHECK(vkAllocateDescriptorSets(device, &allocateInfo, &descriptorSet_));
+
+    VkDescriptorBufferInfo bufferInfo{parameterBuffer_, 0, VK_WHOLE_SIZE};
+    VkDescriptorImageInfo imageInfo{sampler_, shadowImageView_, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+    std::vector<VkWriteDescriptorSet> writeDescriptorSets(2);
+    writeDescriptorSets[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSets[0].dstSet = descriptorSet_;
+    writeDescriptorSets[0].dstBinding = 0;
+    writeDescriptorSets[0].dstArrayElement = 0;
+    writeDescriptorSets[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    writeDescriptorSets[0].descriptorCount = 1;
+    writeDescriptorSets[0].pBufferInfo = &bufferInfo;
+    writeDescriptorSets[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSets[1].dstSet = descriptorSet_;
+    writeDescriptorSets[1].dstBinding = 1;
+    writeDescriptorSets[1].dstArrayElement = 0;
+    writeDescriptorSets[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writeDescriptorSets[1].descriptorCount = 1;
+    writeDescriptorSets[1].pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0,
+        nullptr);
+}
+
+void CascadedShadowMaps::CreatePipeline()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    shaderModule_ = context.CreateShaderModule("shader/shadow.vert.spv");
+
+    VkPipelineShaderStageCreateInfo shaderStageInfo{};
+    shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStageInfo.module = shaderModule_;
+    shaderStageInfo.pName = "main";
+
+    std::vector<VkVertexInputBindingDescription> vertexBindingDescriptions = {
+        Vertex::GetPositionBindingDescription(),
+        InstanceBatch::GetBindingDescription()
+    };
+    auto vertexAttributeDescriptions = Vertex::GetPositionAttributeDescriptions();
+    auto instanceAttributeDescriptions = InstanceBatch::GetAttributeDescriptions();
+    vertexAttributeDescriptions.insert(vertexAttributeDescriptions.end(), instanceAttributeDescriptions.begin(),
+        instanceAttributeDescriptions.end());
+
+    VkPipelineVertexInputStateCreateInfo vertexInputStateInfo{};
+    vertexInputStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputStateInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexBindingDescriptions.size());
+    vertexInputStateInfo.pVertexBindingDescriptions = vertexBindingDescriptions.data();
+    vertexInputStateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributeDescriptions.size());
+    vertexInputStateInfo.pVertexAttributeDescriptions = vertexAttributeDescriptions.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateInfo{};
+    inputAssemblyStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssemblyStateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssemblyStateInfo.primitiveRestartEnable = VK_FALSE;
+
+    VkPipelineViewportStateCreateInfo viewportStateInfo{};
+    viewportStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportStateInfo.viewportCount = 1;
+    viewportStateInfo.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizerStateInfo{};
+    rasterizerStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizerStateInfo.depthClampEnable = VK_FALSE;
+    rasterizerStateInfo.rasterizerDiscardEnable = VK_FALSE;
+    rasterizerStateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizerStateInfo.lineWidth = 1.0f;
+    rasterizerStateInfo.cullMode = VK_CULL_MODE_NONE;
+    rasterizerStateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizerStateInfo.depthBiasEnable = VK_TRUE;
+    rasterizerStateInfo.depthBiasConstantFactor = DEPTH_BIAS_CONSTANT;
+    rasterizerStateInfo.depthBiasSlopeFactor = DEPTH_BIAS_SLOPE;
+
+    VkPipelineMultisampleStateCreateInfo multisamplingStateInfo{};
+    multisamplingStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisamplingStateInfo.sampleShadingEnable = VK_FALSE;
+    multisamplingStateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencilStateInfo{};
+    depthStencilStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencilStateInfo.depthTestEnable = VK_TRUE;
+    depthStencilStateInfo.depthWriteEnable = VK_TRUE;
+    depthStencilStateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencilStateInfo.depthBoundsTestEnable = VK_FALSE;
+    depthStencilStateInfo.stencilTestEnable = VK_FALSE;
+
+    std::vector<VkDynamicState> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicStateInfo{};
+    dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicStateInfo.pDynamicStates = dynamicStates.data();
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(glm::mat4);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    VULKAN_CHECK(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayout_));
+
+    VkGraphicsPipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    createInfo.stageCount = 1;
+    createInfo.pStages = &shaderStageInfo;
+    createInfo.pVertexInputState = &vertexInputStateInfo;
+    createInfo.pInputAssemblyState = &inputAssemblyStateInfo;
+    createInfo.pViewportState = &viewportStateInfo;
+    createInfo.pRasterizationState = &rasterizerStateInfo;
+    createInfo.pMultisampleState = &multisamplingStateInfo;
+    createInfo.pDepthStencilState = &depthStencilStateInfo;
+    createInfo.pDynamicState = &dynamicStateInfo;
+    createInfo.layout = pipelineLayout_;
+    createInfo.renderPass = staticRenderPass_;
+    createInfo.subpass = 0;
+    VULKAN_CHECK(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline_));
+}
+
+void CascadedShadowMaps::UpdateCasterFlags(const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches)
+{
+    if (dynamicCasters_.size() < instanceBatches.size()) {
+        dynamicCasters_.resize(instanceBatches.size());
+    }
+    allResident_ = true;
+    for (uint32_t i = 0; i < instanceBatches.size(); i++) {
+        auto instanceCount = instanceBatches[i]->GetInstanceCount();
+        allResident_ = allResident_ && instanceBatches[i]->GetResidentCount() == instanceCount;
+        if (dynamicCasters_[i].size() < instanceCount) {
+            dynamicCasters_[i].resize(instanceCount, 0);
+            Invalidate();
+        }
+    }
+}
+
+void CascadedShadowMaps::FitCascades(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection)
+{
+    auto inverseViewProjection = glm::inverse(projection * view * model);
+    std::array<glm::vec3, 8> frustumCorners;
+    for (uint32_t i = 0; i < frustumCorners.size(); i++) {
+        auto corner = inverseViewProjection * glm::vec4((i & 1) != 0 ? 1.0f : -1.0f, (i & 2) != 0 ? 1.0f : -1.0f,
+            (i & 4) != 0 ? 1.0f : 0.0f, 1.0f);
+        frustumCorners[i] = glm::vec3(corner) / corner.w;
+    }
+
+    auto splitNear = nearPlane_;
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        auto splitFar = splitDepths_[i];
+        auto nearFraction = (splitNear - nearPlane_) / (farPlane_ - nearPlane_);
+        auto farFraction = (splitFar - nearPlane_) / (farPlane_ - nearPlane_);
+
+        std::array<glm::vec3, 8> sliceCorners;
+        auto center = glm::vec3(0.0f);
+        for (uint32_t j = 0; j < 4; j++) {
+            sliceCorners[j] = glm::mix(frustumCorners[j], frustumCorners[j + 4], nearFraction);
+            sliceCorners[j + 4] = glm::mix(frustumCorners[j], frustumCorners[j + 4], farFraction);
+            center += sliceCorners[j] + sliceCorners[j + 4];
+        }
+        center /= 8.0f;
+        auto radius = 0.0f;
+        for (const auto& corner : sliceCorners) {
+            radius = std::max(radius, glm::distance(corner, center));
+        }
+
+        auto& cascade = cascades_[i];
+        cascade.refresh = !cascade.valid || glm::dot(cascade.lightDirection, lightDirection_) < LIGHT_REFRESH_COS ||
+            glm::distance(center, cascade.center) + radius > cascade.radius;
+        if (cascade.refresh) {
+            FitCascade(cascade, center, radius * (1.0f + CASCADE_PADDING));
+        }
+        splitNear = splitFar;
+    }
+}
+
+void CascadedShadowMaps::FitCascade(Cascade& cascade, const glm::vec3& center, float radius)
+{
+    auto up = std::abs(lightDirection_.z) > 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+    auto lightRotation = glm::lookAt(glm::vec3(0.0f), lightDirection_, up);
+    auto texelSize = 2.0f * radius / static_cast<float>(resolution_);
+    auto lightCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+    lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+    lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+    auto snappedCenter = glm::vec3(glm::inverse(lightRotation) * glm::vec4(lightCenter, 1.0f));
+
+    auto eye = snappedCenter - lightDirection_ * (radius + CASTER_DISTANCE);
+    auto lightView = glm::lookAt(eye, snappedCenter, up);
+    auto lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius + CASTER_DISTANCE);
+
+    cascade.viewProjection = lightProjection * lightView;
+    cascade.center = snappedCenter;
+    cascade.lightDirection = lightDirection_;
+    cascade.radius = radius;
+    cascade.valid = true;
+}
+
+void CascadedShadowMaps::Invalidate()
+{
+    for (auto& cascade : cascades_) {
+        cascade.valid = false;
+    }
+    invalidations_++;
+}
+
+uint32_t CascadedShadowMaps::DrawCasters(VkCommandBuffer commandBuffer,
+    const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches, const Cascade& cascade, bool dynamicCasters)
+{
+    vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4),
+        &cascade.viewProjection);
+
+    uint32_t drawCount = 0;
+    culler_.BeginFrame(cascade.viewProjection);
+    for (uint32_t i = 0; i < instanceBatches.size(); i++) {
+        const auto& instanceBatch = *instanceBatches[i];
+        const auto& flags = dynamicCasters_[i];
+        auto residentCount = instanceBatch.GetResidentCount();
+        culler_.Cull(instanceBatch.GetBounds(), visibleInstances_);
+        visibleInstances_.erase(std::remove_if(visibleInstances_.begin(), visibleInstances_.end(),
+            [&flags, dynamicCasters, residentCount](uint32_t instance) {
+                return instance >= residentCount || (flags[instance] != 0) != dynamicCasters;
+            }), visibleInstances_.end());
+        if (visibleInstances_.empty()) {
+            continue;
+        }
+
+        const auto& mesh = instanceBatch.GetMesh();
+        auto buffer = instanceBatch.GetBuffer();
+        VkDeviceSize offset = 0;
+        mesh->BindBuffers(commandBuffer, VertexStream::Position);
+        vkCmdBindVertexBuffers(commandBuffer, 1, 1, &buffer, &offset);
+        size_t consumed = 0;
+        while (consumed < visibleInstances_.size()) {
+            auto first = visibleInstances_[consumed];
+            uint32_t count = 1;
+            while (consumed + count < visibleInstances_.size() &&
+                visibleInstances_[consumed + count] == first + count) {
+                count++;
+            }
+            mesh->Draw(commandBuffer, count, first);
+            consumed += count;
+        }
+        drawCount += static_cast<uint32_t>(visibleInstances_.size());
+    }
+    return drawCount;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef CASCADED_SHADOW_MAPS_HPP
+#define CASCADED_SHADOW_MAPS_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "FrustumCuller.hpp"
+#include "InstanceBatch.hpp"
+#include "ThreadPool.hpp"
+
+struct ShadowStats {
+    std::vector<uint32_t> staticDraws, dynamicDraws;
+    uint32_t cacheHits = 0;
+};
+
+class CascadedShadowMaps {
+public:
+    CascadedShadowMaps(uint32_t resolution, float nearPlane, float farPlane, const glm::vec3& lightDirection,
+        ThreadPool* threadPool);
+    ~CascadedShadowMaps();
+
+    CascadedShadowMaps(const CascadedShadowMaps&) = delete;
+    CascadedShadowMaps& operator=(const CascadedShadowMaps&) = delete;
+
+    void SetLightDirection(const glm::vec3& lightDirection);
+    void MarkDynamic(uint32_t batch, uint32_t instance);
+    void Record(VkCommandBuffer commandBuffer, const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches,
+        const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection);
+    VkDescriptorSetLayout GetDescriptorSetLayout() const;
+    VkDescriptorSet GetDescriptorSet() const;
+    const ShadowStats& GetStats() const;
+    void PrintStats() const;
+
+private:
+    static constexpr uint32_t CASCADE_COUNT = 4;
+
+    struct Cascade {
+        glm::mat4 viewProjection;
+        glm::vec3 center, lightDirection;
+        float radius;
+        bool valid = false, refresh = false, composed = false;
+        uint32_t dynamicDraws = 0;
+    };
+
+    struct ShadowParameters {
+        glm::mat4 lightViewProjections[CASCADE_COUNT];
+        glm::vec4 splitDepths;
+        glm::vec4 lightDirection;
+        glm::vec4 lightColor;
+        glm::vec4 cameraPosition;
+        glm::vec2 depthRange;
+        glm::vec2 padding;
+    };
+
+    const float SPLIT_LAMBDA = 0.75f;
+    const float CASCADE_PADDING = 0.25f;
+    const float CASTER_DISTANCE = 32.0f;
+    const float LIGHT_REFRESH_COS = 0.99996f;
+    const float DEPTH_BIAS_CONSTANT = 1.25f;
+    const float DEPTH_BIAS_SLOPE = 1.75f;
+
+    void CreateImages();
+    void CreateRenderPasses();
+    void CreateFramebuffers();
+    void CreateSampler();
+    void CreateDescriptorSet();
+    void CreatePipeline();
+    void UpdateCasterFlags(const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches);
+    void FitCascades(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection);
+    void FitCascade(Cascade& cascade, const glm::vec3& center, float radius);
+    void Invalidate();
+    uint32_t DrawCasters(VkCommandBuffer commandBuffer,
+        const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches, const Cascade& cascade,
+        bool dynamicCasters);
+
+    uint32_t resolution_;
+    float nearPlane_, farPlane_;
+    glm::vec3 lightDirection_;
+    std::array<float, CASCADE_COUNT> splitDepths_;
+    std::array<Cascade, CASCADE_COUNT> cascades_;
+    FrustumCuller culler_;
+    std::vector<uint32_t> visibleInstances_;
+    std::vector<std::vector<uint8_t>> dynamicCasters_;
+    uint32_t dynamicCasterCount_ = 0;
+    bool allResident_ = true;
+    VkImage shadowImage_, staticImage_;
+    VmaAllocation shadowAllocation_, staticAllocation_;
+    VkImageView shadowImageView_;
+    std::vector<VkImageView> shadowLayerViews_, staticLayerViews_;
+    VkRenderPass staticRenderPass_, compositeRenderPass_;
+    std::vector<VkFramebuffer> staticFramebuffers_, compositeFramebuffers_;
+    VkSampler sampler_;
+    VkBuffer parameterBuffer_;
+    VmaAllocation parameterAllocation_;
+    VkDescriptorSetLayout descriptorSetLayout_;
+    VkDescriptorPool descriptorPool_;
+    VkDescriptorSet descriptorSet_;
+    VkShaderModule shaderModule_;
+    VkPipelineLayout pipelineLayout_;
+    VkPipeline pipeline_;
+    ShadowStats stats_;
+    uint64_t frameCount_ = 0, cacheHits_ = 0, refreshes_ = 0, invalidations_ = 0;
+    std::vector<uint64_t> totalStaticDraws_, totalDynamicDraws_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,360 @@
+#include "ClusteredLighting.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+Light Light::CreatePoint(const glm::vec3& position, float range, const glm::vec3& color, float intensity)
+{
+    return {glm::vec4(position, range), glm::vec4(color, intensity), glm::vec4(0.0f, 0.0f, -1.0f, -1.0f),
+        glm::vec4(-1.0f, static_cast<float>(LightType::Point), 0.0f, 0.0f)};
+}
+
+Light Light::CreateSpot(const glm::vec3& position, float range, const glm::vec3& color, float intensity,
+    const glm::vec3& direction, float innerAngle, float outerAngle)
+{
+    return {glm::vec4(position, range), glm::vec4(color, intensity),
+        glm::vec4(glm::normalize(direction), glm::cos(outerAngle)),
+        glm::vec4(glm::cos(innerAngle), static_cast<float>(LightType::Spot), 0.0f, 0.0f)};
+}
+
+ClusteredLighting::ClusteredLighting(uint32_t maxLights, uint32_t slotCount) :
+    maxLights_(std::max(maxLights, 1u)),
+    slotCount_(slotCount),
+    frameIndices_(slotCount, 0),
+    lightCounts_(slotCount, 0),
+    pending_(slotCount, false)
+{
+    auto& context = VulkanContext::Instance();
+    auto properties = context.GetPhysicalDeviceProperties();
+    timestampsSupported_ = properties.limits.timestampComputeAndGraphics == VK_TRUE;
+    timestampPeriod_ = static_cast<double>(properties.limits.timestampPeriod);
+    auto alignment = properties.limits.minStorageBufferOffsetAlignment;
+    counterStride_ = (sizeof(ClusterCounters) + alignment - 1) / alignment * alignment;
+    if (timestampsSupported_) {
+        VkQueryPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = slotCount_ * 2;
+        VULKAN_CHECK(vkCreateQueryPool(context.GetDevice(), &createInfo, nullptr, &queryPool_));
+    }
+
+    CreateBuffers();
+    CreateDescriptorSetLayouts();
+    CreateDescriptorSet();
+    CreatePipeline();
+}
+
+ClusteredLighting::~ClusteredLighting()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+    auto allocator = context.GetAllocator();
+
+    vkDestroyPipeline(device, pipeline_, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout_, nullptr);
+    vkDestroyShaderModule(device, shaderModule_, nullptr);
+    vkDestroyDescriptorPool(device, descriptorPool_, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout_, nullptr);
+    vkDestroyDescriptorSetLayout(device, cullDescriptorSetLayout_, nullptr);
+    vmaUnmapMemory(allocator, counterAllocation_);
+    vmaDestroyBuffer(allocator, counterBuffer_, counterAllocation_);
+    vmaDestroyBuffer(allocator, parameterBuffer_, parameterAllocation_);
+    vmaDestroyBuffer(allocator, clusterLightBuffer_, clusterLightAllocation_);
+    vmaDestroyBuffer(allocator, clusterCountBuffer_, clusterCountAllocation_);
+    vmaDestroyBuffer(allocator, lightBuffer_, lightAllocation_);
+    if (queryPool_ != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device, queryPool_, nullptr);
+    }
+}
+
+void ClusteredLighting::Record(VkCommandBuffer commandBuffer, FrameScheduler& frameScheduler,
+    DescriptorAllocator& descriptorAllocator, const std::vector<Light>& lights, ClusterParameters parameters,
+    uint32_t frameIndex)
+{
+    PROFILE_SCOPE("RecordLightCulling");
+
+    auto device = VulkanContext::Instance().GetDevice();
+    auto slot = frameScheduler.GetFrameSlot();
+    const auto& frame = frameScheduler.GetFrame(slot);
+
+    auto lightCount = std::min(static_cast<uint32_t>(lights.size()), maxLights_);
+    VkBuffer uploadBuffer;
+    VkDeviceSize uploadOffset;
+    void* uploadData;
+    auto uploadSize = sizeof(Light) * lightCount;
+    auto uploaded = lightCount > 0 && frameScheduler.AllocateUpload(uploadSize, uploadBuffer, uploadOffset,
+        uploadData);
+    if (uploaded) {
+        memcpy(uploadData, lights.data(), uploadSize);
+    } else {
+        lightCount = 0;
+    }
+    parameters.lightCount = lightCount;
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    vkCmdUpdateBuffer(commandBuffer, parameterBuffer_, 0, sizeof(parameters), &parameters);
+    vkCmdFillBuffer(commandBuffer, counterBuffer_, counterStride_ * slot, sizeof(ClusterCounters), 0);
+    if (uploaded) {
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = uploadOffset;
+        copyRegion.dstOffset = 0;
+        copyRegion.size = uploadSize;
+        vkCmdCopyBuffer(commandBuffer, uploadBuffer, lightBuffer_, 1, &copyRegion);
+    }
+
+    VkMemoryBarrier uploadBarrier{};
+    uploadBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    uploadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    uploadBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+        VK_ACCESS_UNIFORM_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+        &uploadBarrier, 0, nullptr, 0, nullptr);
+
+    auto descriptorSet = descriptorAllocator.AllocateFrame(slot, cullDescriptorSetLayout_);
+    std::vector<VkDescriptorBufferInfo> bufferInfos = {
+        {frameScheduler.GetUniformBuffer(), frame.uniformOffset, frameScheduler.GetUniformSize()},
+        {lightBuffer_, 0, VK_WHOLE_SIZE},
+        {clusterCountBuffer_, 0, VK_WHOLE_SIZE},
+        {clusterLightBuffer_, 0, VK_WHOLE_SIZE},
+        {parameterBuffer_, 0, VK_WHOLE_SIZE},
+        {counterBuffer_, counterStride_ * slot, sizeof(ClusterCounters)}
+    };
+    std::vector<VkWriteDescriptorSet> writeDescriptorSets(bufferInfos.size());
+    for (uint32_t i = 0; i < writeDescriptorSets.size(); i++) {
+        auto& writeDescriptorSet = writeDescriptorSets[i];
+        writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSet.dstSet = descriptorSet;
+        writeDescriptorSet.dstBinding = i;
+        writeDescriptorSet.dstArrayElement = 0;
+        writeDescriptorSet.descriptorType = i == 0 || i == 4 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER :
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSet.descriptorCount = 1;
+        writeDescriptorSet.pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0,
+        nullptr);
+
+    if (timestampsSupported_) {
+        vkCmdResetQueryPool(commandBuffer, queryPool_, slot * 2, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, slot * 2);
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_, 0, 1, &descriptorSet, 0,
+        nullptr);
+    vkCmdDispatch(commandBuffer, CLUSTER_COUNT, 1, 1);
+
+    if (timestampsSupported_) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queryPool_, slot * 2 + 1);
+    }
+
+    VkMemoryBarrier cullBarrier{};
+    cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &cullBarrier, 0, nullptr, 0,
+        nullptr);
+
+    frameIndices_[slot] = frameIndex;
+    lightCounts_[slot] = lightCount;
+    pending_[slot] = true;
+}
+
+bool ClusteredLighting::Resolve(uint32_t slot, uint32_t& frameIndex, LightCullStats& stats)
+{
+    if (slot >= slotCount_ || !pending_[slot]) {
+        return false;
+    }
+
+    stats.milliseconds = 0.0;
+    if (timestampsSupported_) {
+        uint64_t timestamps[2];
+        auto result = vkGetQueryPoolResults(VulkanContext::Instance().GetDevice(), queryPool_, slot * 2, 2,
+            sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) {
+            return false;
+        }
+        stats.milliseconds = static_cast<double>(timestamps[1] - timestamps[0]) * timestampPeriod_ / 1e6;
+    }
+
+    auto allocator = VulkanContext::Instance().GetAllocator();
+    vmaInvalidateAllocation(allocator, counterAllocation_, counterStride_ * slot, sizeof(ClusterCounters));
+    const auto& counters = *reinterpret_cast<const ClusterCounters*>(counterData_ + counterStride_ * slot);
+    stats.lightCount = lightCounts_[slot];
+    stats.clusterCount = CLUSTER_COUNT;
+    stats.occupiedClusters = counters.occupiedClusters;
+    stats.assignedLights = counters.assignedLights;
+    stats.maxLights = counters.maxLights;
+    stats.overflowClusters = counters.overflowClusters;
+    frameIndex = frameIndices_[slot];
+    pending_[slot] = false;
+
+    resolvedCount_++;
+    totalMilliseconds_ += stats.milliseconds;
+    totalOccupiedClusters_ += stats.occupiedClusters;
+    totalAssignedLights_ += stats.assignedLights;
+    totalOverflowClusters_ += stats.overflowClusters;
+    peakLightsPerCluster_ = std::max(peakLightsPerCluster_, stats.maxLights);
+    return true;
+}
+
+VkDescriptorSetLayout ClusteredLighting::GetDescriptorSetLayout() const
+{
+    return descriptorSetLayout_;
+}
+
+VkDescriptorSet ClusteredLighting::GetDescriptorSet() const
+{
+    return descriptorSet_;
+}
+
+uint32_t ClusteredLighting::GetMaxLights() const
+{
+    return maxLights_;
+}
+
+void ClusteredLighting::PrintStats() const
+{
+    if (resolvedCount_ == 0) {
+        return;
+    }
+
+    auto occupied = static_cast<double>(totalOccupiedClusters_) / static_cast<double>(resolvedCount_);
+    std::cout << "Clustered lighting: " << CLUSTER_COUNT_X << "x" << CLUSTER_COUNT_Y << "x" << CLUSTER_COUNT_Z
+        << " clusters, light cull mean " << totalMilliseconds_ / static_cast<double>(resolvedCount_) << " ms"
+        << std::endl;
+    std::cout << "  Occupancy: " << occupied / CLUSTER_COUNT * 100.0 << "% clusters, "
+        << (totalOccupiedClusters_ == 0 ? 0.0 :
+            static_cast<double>(totalAssignedLights_) / static_cast<double>(totalOccupiedClusters_))
+        << " lights per occupied cluster, peak " << peakLightsPerCluster_ << ", "
+        << totalOverflowClusters_ << " overflowed clusters" << std::endl;
+}
+
+void ClusteredLighting::CreateBuffers()
+{
+    auto& context = VulkanContext::Instance();
+
+    context.CreateBuffer(sizeof(Light) * maxLights_,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, {}, lightBuffer_, lightAllocation_);
+    context.CreateBuffer(sizeof(uint32_t) * CLUSTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, {},
+        clusterCountBuffer_, clusterCountAllocation_);
+    context.CreateBuffer(sizeof(uint32_t) * CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, {}, clusterLightBuffer_, clusterLightAllocation_);
+    context.CreateBuffer(sizeof(ClusterParameters),
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, {}, parameterBuffer_,
+        parameterAllocation_);
+    context.CreateBuffer(counterStride_ * slotCount_,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT, counterBuffer_, counterAllocation_);
+
+    void* counterData;
+    vmaMapMemory(context.GetAllocator(), counterAllocation_, &counterData);
+    counterData_ = static_cast<uint8_t*>(counterData);
+}
+
+void ClusteredLighting::CreateDescriptorSetLayouts()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+
+    std::vector<VkDescriptorSetLayoutBinding> cullBindings(6);
+    for (uint32_t i = 0; i < cullBindings.size(); i++) {
+        cullBindings[i].binding = i;
+        cullBindings[i].descriptorType = i == 0 || i == 4 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER :
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        cullBindings[i].descriptorCount = 1;
+        cullBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    createInfo.bindingCount = static_cast<uint32_t>(cullBindings.size());
+    createInfo.pBindings = cullBindings.data();
+    VULKAN_CHECK(vkCreateDescriptorSetLayout(device, &createInfo, nullptr, &cullDescriptorSetLayout_));
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings(4);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == 3 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+
+    createInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    createInfo.pBindings = bindings.data();
+    VULKAN_CHECK(vkCreateDescriptorSetLayout(device, &createInfo, nullptr, &descriptorSetLayout_));
+}
+
+void ClusteredLighting::CreateDescriptorSet()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+
+    std::vector<VkDescriptorPoolSize> poolSizes = {
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}
+    };
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    VULKAN_CHECK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool_));
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = descriptorPool_;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &descriptorSetLayout_;
+    VULKAN_CHECK(vkAllocateDescriptorSets(device, &allocateInfo, &descriptorSet_));
+
+    std::vector<VkDescriptorBufferInfo> bufferInfos = {
+        {lightBuffer_, 0, VK_WHOLE_SIZE},
+        {clusterCountBuffer_, 0, VK_WHOLE_SIZE},
+        {clusterLightBuffer_, 0, VK_WHOLE_SIZE},
+        {parameterBuffer_, 0, VK_WHOLE_SIZE}
+    };
+    std::vector<VkWriteDescriptorSet> writeDescriptorSets(bufferInfos.size());
+    for (uint32_t i = 0; i < writeDescriptorSets.size(); i++) {
+        auto& writeDescriptorSet = writeDescriptorSets[i];
+        writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSet.dstSet = descriptorSet_;
+        writeDescriptorSet.dstBinding = i;
+        writeDescriptorSet.dstArrayElement = 0;
+        writeDescriptorSet.descriptorType = i == 3 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER :
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSet.descriptorCount = 1;
+        writeDescriptorSet.pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0,
+        nullptr);
+}
+
+void ClusteredLighting::CreatePipeline()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    shaderModule_ = context.CreateShaderModule("shader/light_cull.comp.spv");
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &cullDescriptorSetLayout_;
+    VULKAN_CHECK(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayout_));
+
+    VkComputePipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    createInfo.stage.module = shaderModule_;
+    createInfo.stage.pName = "main";
+    createInfo.layout = pipelineLayout_;
+    VULKAN_CHECK(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline_));
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef CLUSTERED_LIGHTING_HPP
+#define CLUSTERED_LIGHTING_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "DescriptorAllocator.hpp"
+#include "FrameScheduler.hpp"
+
+enum class LightType : uint32_t {
+    Point,
+    Spot
+};
+
+struct Light {
+    glm::vec4 positionRange;
+    glm::vec4 colorIntensity;
+    glm::vec4 directionCosOuter;
+    glm::vec4 parameters;
+
+    static Light CreatePoint(const glm::vec3& position, float range, const glm::vec3& color, float intensity);
+    static Light CreateSpot(const glm::vec3& position, float range, const glm::vec3& color, float intensity,
+        const glm::vec3& direction, float innerAngle, float outerAngle);
+};
+
+struct ClusterParameters {
+    glm::vec4 cameraPosition;
+    glm::vec2 screenSize;
+    float nearPlane, farPlane;
+    uint32_t lightCount, padding[3];
+};
+
+struct LightCullStats {
+    uint32_t lightCount, clusterCount, occupiedClusters, assignedLights, maxLights, overflowClusters;
+    double milliseconds;
+};
+
+class ClusteredLighting {
+public:
+    ClusteredLighting(uint32_t maxLights, uint32_t slotCount);
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    void Record(VkCommandBuffer commandBuffer, FrameScheduler& frameScheduler,
+        DescriptorAllocator& descriptorAllocator, const std::vector<Light>& lights, ClusterParameters parameters,
+        uint32_t frameIndex);
+    bool Resolve(uint32_t slot, uint32_t& frameIndex, LightCullStats& stats);
+    VkDescriptorSetLayout GetDescriptorSetLayout() const;
+    VkDescriptorSet GetDescriptorSet() const;
+    uint32_t GetMaxLights() const;
+    void PrintStats() const;
+
+private:
+    struct ClusterCounters {
+        uint32_t occupiedClusters, assignedLights, maxLights, overflowClusters;
+    };
+
+    static constexpr uint32_t CLUSTER_COUNT_X = 16;
+    static constexpr uint32_t CLUSTER_COUNT_Y = 9;
+    static constexpr uint32_t CLUSTER_COUNT_Z = 24;
+    static constexpr uint32_t CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+    static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+
+    void CreateBuffers();
+    void CreateDescriptorSetLayouts();
+    void CreateDescriptorSet();
+    void CreatePipeline();
+
+    uint32_t maxLights_, slotCount_;
+    VkDeviceSize counterStride_;
+    bool timestampsSupported_;
+    double timestampPeriod_;
+    VkQueryPool queryPool_ = VK_NULL_HANDLE;
+    std::vector<uint32_t> frameIndices_, lightCounts_;
+    std::vector<bool> pending_;
+    VkBuffer lightBuffer_, clusterCountBuffer_, clusterLightBuffer_, parameterBuffer_, counterBuffer_;
+    VmaAllocation lightAllocation_, clusterCountAllocation_, clusterLightAllocation_, parameterAllocation_,
+        counterAllocation_;
+    uint8_t* counterData_;
+    VkDescriptorSetLayout cullDescriptorSetLayout_, descriptorSetLayout_;
+    VkDescriptorPool descriptorPool_;
+    VkDescriptorSet descriptorSet_;
+    VkShaderModule shaderModule_;
+    VkPipelineLayout pipelineLayout_;
+    VkPipeline pipeline_;
+    uint64_t resolvedCount_ = 0;
+    double totalMilliseconds_ = 0.0;
+    uint64_t totalOccupiedClusters_ = 0, totalAssignedLights_ = 0, totalOverflowClusters_ = 0;
+    uint32_t peakLightsPerCluster_ = 0;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "DeletionQueue.hpp"
+
+DeletionQueue::~DeletionQueue()
+{
+    Flush();
+}
+
+void DeletionQueue::Push(uint64_t frameNumber, Deleter deleter)
+{
+    entries_.push_back({frameNumber, std::move(deleter)});
+}
+
+void DeletionQueue::Collect(uint64_t completedFrame)
+{
+    while (!entries_.empty() && entries_.front().frameNumber <= completedFrame) {
+        auto deleter = std::move(entries_.front().deleter);
+        entries_.pop_front();
+        deleter();
+    }
+}
+
+void DeletionQueue::Flush()
+{
+    while (!entries_.empty()) {
+        auto deleter = std::move(entries_.front().deleter);
+        entries_.pop_front();
+        deleter();
+    }
+}
+
+uint32_t DeletionQueue::GetPendingCount() const
+{
+    return static_cast<uint32_t>(entries_.size());
+}
\ No newline at end of file
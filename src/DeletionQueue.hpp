@@ -0,0 +1,32 @@
+#ifndef DELETION_QUEUE_HPP
+#define DELETION_QUEUE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+class DeletionQueue {
+public:
+    using Deleter = std::function<void()>;
+
+    DeletionQueue() = default;
+    ~DeletionQueue();
+
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+    void Push(uint64_t frameNumber, Deleter deleter);
+    void Collect(uint64_t completedFrame);
+    void Flush();
+    uint32_t GetPendingCount() const;
+
+private:
+    struct Entry {
+        uint64_t frameNumber;
+        Deleter deleter;
+    };
+
+    std::deque<Entry> entries_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "DescriptorAllocator.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "VulkanContext.hpp"
+
+size_t DescriptorSetKeyHash::operator()(const DescriptorSetKey& key) const
+{
+    auto hash = std::hash<uint64_t>()(reinterpret_cast<uint64_t>(key.layout));
+    auto combine = [&hash](uint64_t value) {
+        hash ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    for (const auto& binding : key.bindings) {
+        combine((static_cast<uint64_t>(binding.binding) << 32) | binding.arrayElement);
+        combine(static_cast<uint64_t>(binding.type));
+        combine(binding.handle);
+        combine(binding.offset);
+        combine(binding.range);
+        combine(binding.sampler);
+        combine(static_cast<uint64_t>(binding.imageLayout));
+    }
+    return hash;
+}
+
+DescriptorAllocator::DescriptorAllocator(uint32_t framesInFlight) :
+    frameChains_(framesInFlight)
+{
+    persistentChain_.setsPerPool = INITIAL_SETS_PER_POOL;
+    for (auto& chain : frameChains_) {
+        chain.setsPerPool = INITIAL_SETS_PER_POOL;
+    }
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    DestroyChain(persistentChain_);
+    for (auto& chain : frameChains_) {
+        DestroyChain(chain);
+    }
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(VkDescriptorSetLayout layout)
+{
+    return Allocate(persistentChain_, layout);
+}
+
+VkDescriptorSet DescriptorAllocator::AllocateFrame(uint32_t frameSlot, VkDescriptorSetLayout layout)
+{
+    return Allocate(frameChains_[frameSlot], layout);
+}
+
+VkDescriptorSet DescriptorAllocator::GetCached(VkDescriptorSetLayout layout, std::vector<VkWriteDescriptorSet>& writes)
+{
+    DescriptorSetKey key{};
+    key.layout = layout;
+    for (const auto& write : writes) {
+        for (uint32_t i = 0; i < write.descriptorCount; i++) {
+            DescriptorSetKey::Binding binding{};
+            binding.binding = write.dstBinding;
+            binding.arrayElement = write.dstArrayElement + i;
+            binding.type = write.descriptorType;
+            if (write.pBufferInfo != nullptr) {
+                binding.handle = reinterpret_cast<uint64_t>(write.pBufferInfo[i].buffer);
+                binding.offset = write.pBufferInfo[i].offset;
+                binding.range = write.pBufferInfo[i].range;
+            } else if (write.pImageInfo != nullptr) {
+                binding.handle = reinterpret_cast<uint64_t>(write.pImageInfo[i].imageView);
+                binding.sampler = reinterpret_cast<uint64_t>(write.pImageInfo[i].sampler);
+                binding.imageLayout = write.pImageInfo[i].imageLayout;
+            }
+            key.bindings.push_back(binding);
+        }
+    }
+    std::sort(key.bindings.begin(), key.bindings.end(), [](const auto& a, const auto& b) {
+        return a.binding < b.binding || (a.binding == b.binding && a.arrayElement < b.arrayElement);
+    });
+
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) {
+        stats_.cacheHits++;
+        return iter->second.descriptorSet;
+    }
+
+    stats_.cacheMisses++;
+    VkDescriptorPool pool;
+    auto descriptorSet = Allocate(persistentChain_, layout, &pool);
+    for (auto& write : writes) {
+        write.dstSet = descriptorSet;
+    }
+    vkUpdateDescriptorSets(VulkanContext::Instance().GetDevice(), static_cast<uint32_t>(writes.size()),
+        writes.data(), 0, nullptr);
+    cache_.emplace(std::move(key), CachedSet{descriptorSet, pool});
+    return descriptorSet;
+}
+
+void DescriptorAllocator::ResetFrame(uint32_t frameSlot)
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    auto& chain = frameChains_[frameSlot];
+    if (chain.current != VK_NULL_HANDLE) {
+        chain.usedPools.push_back(chain.current);
+        chain.current = VK_NULL_HANDLE;
+    }
+    for (auto pool : chain.usedPools) {
+        EvictPool(pool);
+        VULKAN_CHECK(vkResetDescriptorPool(device, pool, 0));
+        chain.freePools.push_back(pool);
+        stats_.poolResets++;
+    }
+    chain.usedPools.clear();
+}
+
+const DescriptorAllocatorStats& DescriptorAllocator::GetStats() const
+{
+    return stats_;
+}
+
+void DescriptorAllocator::PrintStats() const
+{
+    auto lookups = stats_.cacheHits + stats_.cacheMisses;
+    std::cout << "Descriptor sets: " << stats_.allocations << " allocations, " << stats_.poolsCreated
+        << " pools created, " << stats_.poolResets << " pool resets";
+    if (lookups > 0) {
+        std::cout << ", cache hit rate " << 100.0 * static_cast<double>(stats_.cacheHits) / static_cast<double>(lookups)
+            << "% of " << lookups << " lookups";
+    }
+    std::cout << std::endl;
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(PoolChain& chain, VkDescriptorSetLayout layout,
+    VkDescriptorPool* pool)
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    if (chain.current == VK_NULL_HANDLE) {
+        chain.current = AcquirePool(chain);
+    }
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = chain.current;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet descriptorSet;
+    auto result = vkAllocateDescriptorSets(device, &allocateInfo, &descriptorSet);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        chain.usedPools.push_back(chain.current);
+        chain.current = AcquirePool(chain);
+        allocateInfo.descriptorPool = chain.current;
+        result = vkAllocateDescriptorSets(device, &allocateInfo, &descriptorSet);
+    }
+    VULKAN_CHECK(result);
+
+    if (pool != nullptr) {
+        *pool = chain.current;
+    }
+    stats_.allocations++;
+    return descriptorSet;
+}
+
+VkDescriptorPool DescriptorAllocator::AcquirePool(PoolChain& chain)
+{
+    if (!chain.freePools.empty()) {
+        auto pool = chain.freePools.back();
+        chain.freePools.pop_back();
+        return pool;
+    }
+
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    for (const auto& [type, ratio] : POOL_SIZE_RATIOS) {
+        poolSizes.push_back({type, static_cast<uint32_t>(ratio * static_cast<float>(chain.setsPerPool))});
+    }
+
+    VkDescriptorPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    createInfo.maxSets = chain.setsPerPool;
+    createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    createInfo.pPoolSizes = poolSizes.data();
+
+    VkDescriptorPool pool;
+    VULKAN_CHECK(vkCreateDescriptorPool(VulkanContext::Instance().GetDevice(), &createInfo, nullptr, &pool));
+    chain.setsPerPool = std::min(chain.setsPerPool * 2, MAX_SETS_PER_POOL);
+    stats_.poolsCreated++;
+    return pool;
+}
+
+void DescriptorAllocator::DestroyChain(PoolChain& chain)
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    if (chain.current != VK_NULL_HANDLE) {
+        EvictPool(chain.current);
+        vkDestroyDescriptorPool(device, chain.current, nullptr);
+    }
+    for (auto pool : chain.usedPools) {
+        EvictPool(pool);
+        vkDestroyDescriptorPool(device, pool, nullptr);
+    }
+    for (auto pool : chain.freePools) {
+        vkDestroyDescriptorPool(device, pool, nullptr);
+    }
+}
+
+void DescriptorAllocator::EvictPool(VkDescriptorPool pool)
+{
+    std::erase_if(cache_, [pool](const auto& entry) {
+        return entry.second.pool == pool;
+    });
+}
\ No newline at end of file
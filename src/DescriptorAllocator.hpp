@@ -0,0 +1,85 @@
+#ifndef DESCRIPTOR_ALLOCATOR_HPP
+#define DESCRIPTOR_ALLOCATOR_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+struct DescriptorSetKey {
+    struct Binding {
+        uint32_t binding, arrayElement;
+        VkDescriptorType type;
+        uint64_t handle, offset, range;
+        uint64_t sampler;
+        VkImageLayout imageLayout;
+
+        bool operator==(const Binding& other) const = default;
+    };
+
+    VkDescriptorSetLayout layout;
+    std::vector<Binding> bindings;
+
+    bool operator==(const DescriptorSetKey& other) const = default;
+};
+
+struct DescriptorSetKeyHash {
+    size_t operator()(const DescriptorSetKey& key) const;
+};
+
+struct DescriptorAllocatorStats {
+    uint64_t allocations = 0, poolsCreated = 0, poolResets = 0, cacheHits = 0, cacheMisses = 0;
+};
+
+class DescriptorAllocator {
+public:
+    DescriptorAllocator(uint32_t framesInFlight);
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+    VkDescriptorSet AllocateFrame(uint32_t frameSlot, VkDescriptorSetLayout layout);
+    VkDescriptorSet GetCached(VkDescriptorSetLayout layout, std::vector<VkWriteDescriptorSet>& writes);
+    void ResetFrame(uint32_t frameSlot);
+    const DescriptorAllocatorStats& GetStats() const;
+    void PrintStats() const;
+
+private:
+    struct PoolChain {
+        VkDescriptorPool current = VK_NULL_HANDLE;
+        std::vector<VkDescriptorPool> usedPools, freePools;
+        uint32_t setsPerPool;
+    };
+
+    struct CachedSet {
+        VkDescriptorSet descriptorSet;
+        VkDescriptorPool pool;
+    };
+
+    const uint32_t INITIAL_SETS_PER_POOL = 64;
+    const uint32_t MAX_SETS_PER_POOL = 4096;
+    const std::vector<std::pair<VkDescriptorType, float>> POOL_SIZE_RATIOS = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 0.5f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f}
+    };
+
+    VkDescriptorSet Allocate(PoolChain& chain, VkDescriptorSetLayout layout, VkDescriptorPool* pool = nullptr);
+    VkDescriptorPool AcquirePool(PoolChain& chain);
+    void DestroyChain(PoolChain& chain);
+    void EvictPool(VkDescriptorPool pool);
+
+    PoolChain persistentChain_;
+    std::vector<PoolChain> frameChains_;
+    std::unordered_map<DescriptorSetKey, CachedSet, DescriptorSetKeyHash> cache_;
+    DescriptorAllocatorStats stats_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "FrameCapture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+FrameCapture::FrameCapture(uint32_t slotCount, Sink sink) :
+    sink_(std::move(sink)),
+    slots_(slotCount) {}
+
+FrameCapture::~FrameCapture()
+{
+    DestroySlots();
+}
+
+void FrameCapture::Resize(uint32_t width, uint32_t height, VkFormat format)
+{
+    width_ = width;
+    height_ = height;
+    format_ = format;
+    frameSize_ = static_cast<VkDeviceSize>(width) * height * 4;
+
+    for (auto& slot : slots_) {
+        if (!slot.pending) {
+            DestroySlot(slot);
+            CreateSlot(slot);
+        }
+    }
+}
+
+bool FrameCapture::Record(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, uint32_t frameIndex,
+    uint64_t submitFrame)
+{
+    auto& slot = slots_[nextSlot_];
+    if (slot.pending) {
+        droppedCount_++;
+        return false;
+    }
+    if (slot.width != width_ || slot.height != height_ || slot.format != format_) {
+        DestroySlot(slot);
+        CreateSlot(slot);
+    }
+    nextSlot_ = (nextSlot_ + 1) % static_cast<uint32_t>(slots_.size());
+
+    VkImageMemoryBarrier imageBarrier{};
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = image;
+    imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageBarrier.subresourceRange.baseMipLevel = 0;
+    imageBarrier.subresourceRange.levelCount = 1;
+    imageBarrier.subresourceRange.baseArrayLayer = 0;
+    imageBarrier.subresourceRange.layerCount = 1;
+
+    if (layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        imageBarrier.oldLayout = layout;
+        imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+    }
+
+    VkBufferImageCopy copy{};
+    copy.bufferOffset = 0;
+    copy.bufferRowLength = 0;
+    copy.bufferImageHeight = 0;
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.mipLevel = 0;
+    copy.imageSubresource.baseArrayLayer = 0;
+    copy.imageSubresource.layerCount = 1;
+    copy.imageOffset = {0, 0, 0};
+    copy.imageExtent = {slot.width, slot.height, 1};
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer, 1, &copy);
+
+    if (layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        imageBarrier.newLayout = layout;
+        imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        imageBarrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &imageBarrier);
+    }
+
+    VkBufferMemoryBarrier bufferBarrier{};
+    bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.buffer = slot.buffer;
+    bufferBarrier.offset = 0;
+    bufferBarrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1,
+        &bufferBarrier, 0, nullptr);
+
+    slot.submitFrame = submitFrame;
+    slot.frameIndex = frameIndex;
+    slot.recordTime = std::chrono::steady_clock::now();
+    slot.pending = true;
+    return true;
+}
+
+void FrameCapture::Poll(uint64_t completedFrame, uint32_t currentFrameIndex)
+{
+    PROFILE_SCOPE("PollCapture");
+
+    for (uint32_t i = 0; i < slots_.size(); i++) {
+        auto& slot = slots_[(nextSlot_ + i) % slots_.size()];
+        if (slot.pending && slot.submitFrame <= completedFrame) {
+            Deliver(slot, currentFrameIndex);
+        }
+    }
+}
+
+void FrameCapture::Flush(uint32_t currentFrameIndex)
+{
+    for (uint32_t i = 0; i < slots_.size(); i++) {
+        auto& slot = slots_[(nextSlot_ + i) % slots_.size()];
+        if (slot.pending) {
+            Deliver(slot, currentFrameIndex);
+        }
+    }
+}
+
+void FrameCapture::PrintStats() const
+{
+    std::cout << "Capture: " << capturedCount_ << " frames captured, " << droppedCount_ << " dropped" << std::endl;
+    if (capturedCount_ > 0) {
+        std::cout << "  Readback latency: mean " << totalLatencyMs_ / capturedCount_ << " ms, max " << maxLatencyMs_
+            << " ms, max " << maxLatencyFrames_ << " frames" << std::endl;
+    }
+}
+
+void FrameCapture::CreateSlot(Slot& slot)
+{
+    auto& context = VulkanContext::Instance();
+    context.CreateBuffer(frameSize_, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+        slot.buffer, slot.allocation);
+    vmaMapMemory(context.GetAllocator(), slot.allocation, &slot.data);
+    slot.width = width_;
+    slot.height = height_;
+    slot.format = format_;
+}
+
+void FrameCapture::DestroySlot(Slot& slot)
+{
+    if (slot.buffer != VK_NULL_HANDLE) {
+        auto allocator = VulkanContext::Instance().GetAllocator();
+        vmaUnmapMemory(allocator, slot.allocation);
+        vmaDestroyBuffer(allocator, slot.buffer, slot.allocation);
+    }
+    slot = Slot{};
+}
+
+void FrameCapture::DestroySlots()
+{
+    for (auto& slot : slots_) {
+        DestroySlot(slot);
+    }
+    nextSlot_ = 0;
+}
+
+void FrameCapture::Deliver(Slot& slot, uint32_t currentFrameIndex)
+{
+    vmaInvalidateAllocation(VulkanContext::Instance().GetAllocator(), slot.allocation, 0, VK_WHOLE_SIZE);
+
+    CapturedFrame frame;
+    frame.frameIndex = slot.frameIndex;
+    frame.width = slot.width;
+    frame.height = slot.height;
+    frame.format = slot.format;
+    frame.pixels.resize(static_cast<size_t>(slot.width) * slot.height * 4);
+    memcpy(frame.pixels.data(), slot.data, frame.pixels.size());
+    slot.pending = false;
+
+    auto latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+        slot.recordTime).count();
+    capturedCount_++;
+    totalLatencyMs_ += latencyMs;
+    maxLatencyMs_ = std::max(maxLatencyMs_, latencyMs);
+    maxLatencyFrames_ = std::max(maxLatencyFrames_, currentFrameIndex - slot.frameIndex);
+
+    sink_(std::move(frame));
+}
\ No newline at end of file
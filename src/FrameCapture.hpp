@@ -0,0 +1,62 @@
+#ifndef FRAME_CAPTURE_HPP
+#define FRAME_CAPTURE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+struct CapturedFrame {
+    uint32_t frameIndex;
+    uint32_t width, height;
+    VkFormat format;
+    std::vector<uint8_t> pixels;
+};
+
+class FrameCapture {
+public:
+    using Sink = std::function<void(CapturedFrame&&)>;
+
+    FrameCapture(uint32_t slotCount, Sink sink);
+    ~FrameCapture();
+
+    void Resize(uint32_t width, uint32_t height, VkFormat format);
+    bool Record(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, uint32_t frameIndex,
+        uint64_t submitFrame);
+    void Poll(uint64_t completedFrame, uint32_t currentFrameIndex);
+    void Flush(uint32_t currentFrameIndex);
+    void PrintStats() const;
+
+private:
+    struct Slot {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        void* data = nullptr;
+        uint64_t submitFrame = 0;
+        uint32_t frameIndex = 0;
+        uint32_t width = 0, height = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        std::chrono::steady_clock::time_point recordTime;
+        bool pending = false;
+    };
+
+    void CreateSlot(Slot& slot);
+    void DestroySlot(Slot& slot);
+    void DestroySlots();
+    void Deliver(Slot& slot, uint32_t currentFrameIndex);
+
+    Sink sink_;
+    std::vector<Slot> slots_;
+    uint32_t nextSlot_ = 0;
+    uint32_t width_ = 0, height_ = 0;
+    VkFormat format_ = VK_FORMAT_UNDEFINED;
+    VkDeviceSize frameSize_ = 0;
+    uint32_t capturedCount_ = 0, droppedCount_ = 0;
+    uint32_t maxLatencyFrames_ = 0;
+    double totalLatencyMs_ = 0.0, maxLatencyMs_ = 0.0;
+};
+
+#endif
\ No newline at end of file
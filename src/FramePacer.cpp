@@ -0,0 +1,130 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include "Profiler.hpp"
+
+namespace {
+
+constexpr double SMOOTHING = 0.1;
+constexpr double DELAY_MARGIN_MS = 1.0;
+
+double ToMilliseconds(FramePacer::Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}
+
+FramePacer::FramePacer(LatencyMode mode, float frameRateCap) :
+    mode_(mode),
+    framePeriod_(frameRateCap > 0.0f ?
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRateCap)) :
+        Clock::duration::zero()),
+    nextFrameTime_(Clock::now()),
+    inputTime_(Clock::now()) {}
+
+void FramePacer::WaitForNextFrame()
+{
+    if (framePeriod_ == Clock::duration::zero()) {
+        return;
+    }
+
+    PROFILE_SCOPE("FrameRateCap");
+
+    auto now = Clock::now();
+    nextFrameTime_ += framePeriod_;
+    if (nextFrameTime_ < now - framePeriod_) {
+        nextFrameTime_ = now;
+    }
+    SleepUntil(nextFrameTime_);
+}
+
+void FramePacer::DelayInput(uint64_t outstandingFrames)
+{
+    if (mode_ != LatencyMode::LowLatency || outstandingFrames == 0) {
+        return;
+    }
+
+    auto delayMs = static_cast<double>(outstandingFrames) * gpuTimeMs_ - recordTimeMs_ - DELAY_MARGIN_MS;
+    if (delayMs <= 0.0) {
+        return;
+    }
+
+    PROFILE_SCOPE("LatencyDelay");
+
+    totalDelayMs_ += delayMs;
+    SleepUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(delayMs)));
+}
+
+void FramePacer::MarkInput()
+{
+    inputTime_ = Clock::now();
+}
+
+void FramePacer::MarkSubmit(uint32_t frameIndex, uint64_t frameNumber)
+{
+    auto now = Clock::now();
+    recordTimeMs_ += SMOOTHING * (ToMilliseconds(now - inputTime_) - recordTimeMs_);
+    pendingFrames_.push_back({frameIndex, frameNumber, inputTime_});
+}
+
+void FramePacer::AddGpuTime(double milliseconds)
+{
+    gpuTimeMs_ += SMOOTHING * (milliseconds - gpuTimeMs_);
+}
+
+void FramePacer::ResolveLatency(uint64_t completedFrame, const LatencyCallback& callback)
+{
+    auto now = Clock::now();
+    while (!pendingFrames_.empty() && pendingFrames_.front().frameNumber <= completedFrame) {
+        const auto& frame = pendingFrames_.front();
+        auto latencyMs = ToMilliseconds(now - frame.inputTime);
+        latencyCount_++;
+        totalLatencyMs_ += latencyMs;
+        maxLatencyMs_ = std::max(maxLatencyMs_, latencyMs);
+        if (callback) {
+            callback(frame.frameIndex, latencyMs);
+        }
+        pendingFrames_.pop_front();
+    }
+}
+
+void FramePacer::PrintStats() const
+{
+    if (latencyCount_ == 0) {
+        return;
+    }
+
+    std::cout << "Input-to-GPU-complete latency: mean " << totalLatencyMs_ / latencyCount_ << " ms, max "
+        << maxLatencyMs_ << " ms over " << latencyCount_ << " frames" << std::endl;
+    if (mode_ == LatencyMode::LowLatency) {
+        std::cout << "  Input delay: mean " << totalDelayMs_ / latencyCount_ << " ms, GPU estimate " << gpuTimeMs_
+            << " ms" << std::endl;
+    }
+}
+
+void FramePacer::SleepUntil(Clock::time_point target)
+{
+    auto remainingMs = ToMilliseconds(target - Clock::now());
+    while (remainingMs > sleepEstimateMs_) {
+        auto start = Clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto observedMs = ToMilliseconds(Clock::now() - start);
+        remainingMs -= observedMs;
+
+        sleepCount_++;
+        auto delta = observedMs - sleepMeanMs_;
+        sleepMeanMs_ += delta / static_cast<double>(sleepCount_);
+        sleepM2_ += delta * (observedMs - sleepMeanMs_);
+        sleepEstimateMs_ = sleepMeanMs_ + std::sqrt(sleepM2_ / static_cast<double>(sleepCount_ - 1));
+    }
+
+    while (Clock::now() < target) {
+        std::this_thread::yield();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+#include "RendererConfig.hpp"
+
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using LatencyCallback = std::function<void(uint32_t frameIndex, double milliseconds)>;
+
+    FramePacer(LatencyMode mode, float frameRateCap);
+
+    void WaitForNextFrame();
+    void DelayInput(uint64_t outstandingFrames);
+    void MarkInput();
+    void MarkSubmit(uint32_t frameIndex, uint64_t frameNumber);
+    void AddGpuTime(double milliseconds);
+    void ResolveLatency(uint64_t completedFrame, const LatencyCallback& callback);
+    void PrintStats() const;
+
+private:
+    struct PendingFrame {
+        uint32_t frameIndex;
+        uint64_t frameNumber;
+        Clock::time_point inputTime;
+    };
+
+    void SleepUntil(Clock::time_point target);
+
+    LatencyMode mode_;
+    Clock::duration framePeriod_;
+    Clock::time_point nextFrameTime_;
+    Clock::time_point inputTime_;
+    std::deque<PendingFrame> pendingFrames_;
+    double gpuTimeMs_ = 0.0, recordTimeMs_ = 0.0;
+    double sleepEstimateMs_ = 1.0, sleepMeanMs_ = 1.0, sleepM2_ = 0.0;
+    uint64_t sleepCount_ = 1;
+    uint32_t latencyCount_ = 0;
+    double totalLatencyMs_ = 0.0, maxLatencyMs_ = 0.0, totalDelayMs_ = 0.0;
+};
+
+#endif
\ No newline at end of file
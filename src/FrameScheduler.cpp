@@ -0,0 +1,255 @@
+#include "FrameScheduler.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+FrameScheduler::FrameScheduler(uint32_t framesInFlight, VkDeviceSize uniformSize, VkDeviceSize uploadSize) :
+    frames_(std::max(framesInFlight, 1u)),
+    uploadSize_(uploadSize)
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+    useTimelineSemaphore_ = context.GetDeviceFeatures().timelineSemaphore;
+
+    if (useTimelineSemaphore_) {
+        VkSemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+        VULKAN_CHECK(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &timelineSemaphore_));
+    }
+
+    auto alignment = context.GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
+    uniformSize_ = alignment > 0 ? (uniformSize + alignment - 1) / alignment * alignment : uniformSize;
+    context.CreateBuffer(uniformSize_ * frames_.size(), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT, uniformBuffer_, uniformAllocation_);
+    vmaMapMemory(context.GetAllocator(), uniformAllocation_, &uniformData_);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = context.GetQueueFamilyIndices().graphicsFamilyIndex;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for (uint32_t i = 0; i < frames_.size(); i++) {
+        auto& frame = frames_[i];
+        VULKAN_CHECK(vkCreateCommandPool(device, &poolInfo, nullptr, &frame.commandPool));
+
+        VkCommandBufferAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = frame.commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        VULKAN_CHECK(vkAllocateCommandBuffers(device, &allocateInfo, &frame.commandBuffer));
+
+        VULKAN_CHECK(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore));
+        VULKAN_CHECK(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.renderFinishedSemaphore));
+        frame.fence = VK_NULL_HANDLE;
+        if (!useTimelineSemaphore_) {
+            VULKAN_CHECK(vkCreateFence(device, &fenceInfo, nullptr, &frame.fence));
+        }
+
+        frame.uniformOffset = uniformSize_ * i;
+        frame.uniformData = static_cast<uint8_t*>(uniformData_) + frame.uniformOffset;
+
+        void* uploadData;
+        context.CreateBuffer(uploadSize_, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT, frame.uploadBuffer, frame.uploadAllocation);
+        vmaMapMemory(context.GetAllocator(), frame.uploadAllocation, &uploadData);
+        frame.uploadData = static_cast<uint8_t*>(uploadData);
+    }
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    for (auto& frame : frames_) {
+        vmaUnmapMemory(context.GetAllocator(), frame.uploadAllocation);
+        vmaDestroyBuffer(context.GetAllocator(), frame.uploadBuffer, frame.uploadAllocation);
+        if (frame.fence != VK_NULL_HANDLE) {
+            vkDestroyFence(device, frame.fence, nullptr);
+        }
+        vkDestroySemaphore(device, frame.renderFinishedSemaphore, nullptr);
+        vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+        vkDestroyCommandPool(device, frame.commandPool, nullptr);
+    }
+
+    vmaUnmapMemory(context.GetAllocator(), uniformAllocation_);
+    vmaDestroyBuffer(context.GetAllocator(), uniformBuffer_, uniformAllocation_);
+
+    if (timelineSemaphore_ != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device, timelineSemaphore_, nullptr);
+    }
+}
+
+uint32_t FrameScheduler::GetFramesInFlight() const
+{
+    return static_cast<uint32_t>(frames_.size());
+}
+
+uint32_t FrameScheduler::GetFrameSlot() const
+{
+    return frameSlot_;
+}
+
+uint64_t FrameScheduler::GetFrameNumber() const
+{
+    return frameNumber_;
+}
+
+bool FrameScheduler::UsesTimelineSemaphore() const
+{
+    return useTimelineSemaphore_;
+}
+
+VkBuffer FrameScheduler::GetUniformBuffer() const
+{
+    return uniformBuffer_;
+}
+
+VkDeviceSize FrameScheduler::GetUniformSize() const
+{
+    return uniformSize_;
+}
+
+FrameResources& FrameScheduler::GetFrame(uint32_t slot)
+{
+    return frames_[slot];
+}
+
+void FrameScheduler::FlushUniforms(const FrameResources& frame)
+{
+    vmaFlushAllocation(VulkanContext::Instance().GetAllocator(), uniformAllocation_, frame.uniformOffset, uniformSize_);
+}
+
+bool FrameScheduler::AllocateUpload(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset, void*& data)
+{
+    auto& frame = frames_[frameSlot_];
+    auto alignedOffset = (frame.uploadOffset + 15) & ~static_cast<VkDeviceSize>(15);
+    if (alignedOffset + size > uploadSize_) {
+        return false;
+    }
+
+    buffer = frame.uploadBuffer;
+    offset = alignedOffset;
+    data = frame.uploadData + alignedOffset;
+    frame.uploadOffset = alignedOffset + size;
+    return true;
+}
+
+FrameResources& FrameScheduler::BeginFrame()
+{
+    PROFILE_SCOPE("WaitForFrame");
+
+    auto& frame = frames_[frameSlot_];
+    WaitForFrame(frame);
+    VULKAN_CHECK(vkResetCommandPool(VulkanContext::Instance().GetDevice(), frame.commandPool, 0));
+    frame.uploadOffset = 0;
+    return frame;
+}
+
+void FrameScheduler::Submit(VkQueue queue, VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage,
+    VkSemaphore signalSemaphore)
+{
+    PROFILE_SCOPE("QueueSubmit");
+
+    auto& frame = frames_[frameSlot_];
+
+    std::vector<VkSemaphore> signalSemaphores;
+    std::vector<uint64_t> signalValues;
+    if (signalSemaphore != VK_NULL_HANDLE) {
+        signalSemaphores.push_back(signalSemaphore);
+        signalValues.push_back(0);
+    }
+    if (useTimelineSemaphore_) {
+        signalSemaphores.push_back(timelineSemaphore_);
+        signalValues.push_back(frameNumber_);
+    }
+    uint64_t waitValue = 0;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = waitSemaphore != VK_NULL_HANDLE ? 1 : 0;
+    timelineInfo.pWaitSemaphoreValues = &waitValue;
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = useTimelineSemaphore_ ? &timelineInfo : nullptr;
+    if (waitSemaphore != VK_NULL_HANDLE) {
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &waitSemaphore;
+        submitInfo.pWaitDstStageMask = &waitStage;
+    }
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    if (frame.uploadOffset > 0) {
+        vmaFlushAllocation(VulkanContext::Instance().GetAllocator(), frame.uploadAllocation, 0, frame.uploadOffset);
+    }
+    if (frame.fence != VK_NULL_HANDLE) {
+        vkResetFences(VulkanContext::Instance().GetDevice(), 1, &frame.fence);
+    }
+    VULKAN_CHECK(vkQueueSubmit(queue, 1, &submitInfo, frame.fence));
+    frame.submittedFrame = frameNumber_;
+}
+
+void FrameScheduler::EndFrame()
+{
+    frameNumber_++;
+    frameSlot_ = (frameSlot_ + 1) % static_cast<uint32_t>(frames_.size());
+}
+
+uint64_t FrameScheduler::GetCompletedFrame()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    if (useTimelineSemaphore_) {
+        VULKAN_CHECK(vkGetSemaphoreCounterValue(device, timelineSemaphore_, &completedFrame_));
+        return completedFrame_;
+    }
+
+    for (const auto& frame : frames_) {
+        if (frame.submittedFrame > completedFrame_ && vkGetFenceStatus(device, frame.fence) == VK_SUCCESS) {
+            completedFrame_ = frame.submittedFrame;
+        }
+    }
+    return completedFrame_;
+}
+
+void FrameScheduler::WaitForFrame(const FrameResources& frame)
+{
+    if (frame.submittedFrame <= completedFrame_) {
+        return;
+    }
+
+    auto device = VulkanContext::Instance().GetDevice();
+    if (useTimelineSemaphore_) {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timelineSemaphore_;
+        waitInfo.pValues = &frame.submittedFrame;
+        VULKAN_CHECK(vkWaitSemaphores(device, &waitInfo, std::numeric_limits<uint64_t>::max()));
+    } else {
+        VULKAN_CHECK(vkWaitForFences(device, 1, &frame.fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+    }
+    completedFrame_ = std::max(completedFrame_, frame.submittedFrame);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef FRAME_SCHEDULER_HPP
+#define FRAME_SCHEDULER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+struct FrameResources {
+    VkCommandPool commandPool;
+    VkCommandBuffer commandBuffer;
+    VkSemaphore imageAvailableSemaphore, renderFinishedSemaphore;
+    VkFence fence;
+    VkDeviceSize uniformOffset;
+    void* uniformData;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    VkBuffer uploadBuffer;
+    VmaAllocation uploadAllocation;
+    uint8_t* uploadData;
+    VkDeviceSize uploadOffset = 0;
+    uint64_t submittedFrame = 0;
+};
+
+class FrameScheduler {
+public:
+    FrameScheduler(uint32_t framesInFlight, VkDeviceSize uniformSize, VkDeviceSize uploadSize);
+    ~FrameScheduler();
+
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    uint32_t GetFramesInFlight() const;
+    uint32_t GetFrameSlot() const;
+    uint64_t GetFrameNumber() const;
+    bool UsesTimelineSemaphore() const;
+    VkBuffer GetUniformBuffer() const;
+    VkDeviceSize GetUniformSize() const;
+    FrameResources& GetFrame(uint32_t slot);
+    void FlushUniforms(const FrameResources& frame);
+    bool AllocateUpload(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset, void*& data);
+    FrameResources& BeginFrame();
+    void Submit(VkQueue queue, VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage, VkSemaphore signalSemaphore);
+    void EndFrame();
+    uint64_t GetCompletedFrame();
+
+private:
+    void WaitForFrame(const FrameResources& frame);
+
+    std::vector<FrameResources> frames_;
+    uint32_t frameSlot_ = 0;
+    uint64_t frameNumber_ = 1;
+    uint64_t completedFrame_ = 0;
+    bool useTimelineSemaphore_;
+    VkSemaphore timelineSemaphore_ = VK_NULL_HANDLE;
+    VkDeviceSize uniformSize_;
+    VkDeviceSize uploadSize_;
+    VkBuffer uniformBuffer_;
+    VmaAllocation uniformAllocation_;
+    void* uniformData_;
+};
+
+#endif
\ No newline at end of file
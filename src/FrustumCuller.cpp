@@ -0,0 +1,169 @@
+#include "FrustumCuller.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "Profiler.hpp"
+
+uint32_t BoundsArray::GetCount() const
+{
+    return static_cast<uint32_t>(centerX.size());
+}
+
+void BoundsArray::Resize(uint32_t count)
+{
+    centerX.resize(count);
+    centerY.resize(count);
+    centerZ.resize(count);
+    extentX.resize(count);
+    extentY.resize(count);
+    extentZ.resize(count);
+}
+
+void BoundsArray::Set(uint32_t index, const glm::vec3& center, const glm::vec3& extent)
+{
+    centerX[index] = center.x;
+    centerY[index] = center.y;
+    centerZ[index] = center.z;
+    extentX[index] = extent.x;
+    extentY[index] = extent.y;
+    extentZ[index] = extent.z;
+}
+
+FrustumCuller::FrustumCuller(ThreadPool* threadPool) :
+    threadPool_(threadPool) {}
+
+void FrustumCuller::BeginFrame(const glm::mat4& viewProjection)
+{
+    auto rows = glm::transpose(viewProjection);
+    planes_ = {rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[2], rows[3] - rows[2]};
+    stats_ = {};
+}
+
+void FrustumCuller::Cull(const BoundsArray& bounds, std::vector<uint32_t>& visible)
+{
+    PROFILE_SCOPE("CullInstances");
+
+    auto start = std::chrono::steady_clock::now();
+    auto count = bounds.GetCount();
+    visible.clear();
+    if (threadPool_ == nullptr || count < PARALLEL_CHUNK_SIZE * 2) {
+        visible.reserve(count);
+        CullRange(bounds, 0, count, visible);
+    } else {
+        auto chunkCount = (count + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+        if (chunkVisible_.size() < chunkCount) {
+            chunkVisible_.resize(chunkCount);
+        }
+        threadPool_->ParallelFor(chunkCount, [this, &bounds, count](uint32_t chunk, uint32_t) {
+            auto begin = chunk * PARALLEL_CHUNK_SIZE;
+            auto& chunkVisible = chunkVisible_[chunk];
+            chunkVisible.clear();
+            chunkVisible.reserve(PARALLEL_CHUNK_SIZE);
+            CullRange(bounds, begin, std::min(begin + PARALLEL_CHUNK_SIZE, count), chunkVisible);
+        });
+
+        size_t visibleCount = 0;
+        for (uint32_t i = 0; i < chunkCount; i++) {
+            visibleCount += chunkVisible_[i].size();
+        }
+        visible.reserve(visibleCount);
+        for (uint32_t i = 0; i < chunkCount; i++) {
+            visible.insert(visible.end(), chunkVisible_[i].begin(), chunkVisible_[i].end());
+        }
+    }
+
+    stats_.tested += count;
+    stats_.visible += static_cast<uint32_t>(visible.size());
+    stats_.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+const CullStats& FrustumCuller::GetStats() const
+{
+    return stats_;
+}
+
+void FrustumCuller::CullRange(const BoundsArray& bounds, uint32_t begin, uint32_t end,
+    std::vector<uint32_t>& visible) const
+{
+    auto i = begin;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= end; i += 8) {
+        auto centerX = _mm256_loadu_ps(&bounds.centerX[i]);
+        auto centerY = _mm256_loadu_ps(&bounds.centerY[i]);
+        auto centerZ = _mm256_loadu_ps(&bounds.centerZ[i]);
+        auto extentX = _mm256_loadu_ps(&bounds.extentX[i]);
+        auto extentY = _mm256_loadu_ps(&bounds.extentY[i]);
+        auto extentZ = _mm256_loadu_ps(&bounds.extentZ[i]);
+
+        auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const auto& plane : planes_) {
+            auto distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), centerX),
+                    _mm256_mul_ps(_mm256_set1_ps(plane.y), centerY)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), centerZ), _mm256_set1_ps(plane.w)));
+            auto radius = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(glm::abs(plane.x)), extentX),
+                    _mm256_mul_ps(_mm256_set1_ps(glm::abs(plane.y)), extentY)),
+                _mm256_mul_ps(_mm256_set1_ps(glm::abs(plane.z)), extentZ));
+            inside = _mm256_and_ps(inside,
+                _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+        for (uint32_t j = 0; mask != 0; j++, mask >>= 1) {
+            if (mask & 1) {
+                visible.push_back(i + j);
+            }
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 4 <= end; i += 4) {
+        auto centerX = _mm_loadu_ps(&bounds.centerX[i]);
+        auto centerY = _mm_loadu_ps(&bounds.centerY[i]);
+        auto centerZ = _mm_loadu_ps(&bounds.centerZ[i]);
+        auto extentX = _mm_loadu_ps(&bounds.extentX[i]);
+        auto extentY = _mm_loadu_ps(&bounds.extentY[i]);
+        auto extentZ = _mm_loadu_ps(&bounds.extentZ[i]);
+
+        auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const auto& plane : planes_) {
+            auto distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), centerX), _mm_mul_ps(_mm_set1_ps(plane.y), centerY)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), centerZ), _mm_set1_ps(plane.w)));
+            auto radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(glm::abs(plane.x)), extentX),
+                    _mm_mul_ps(_mm_set1_ps(glm::abs(plane.y)), extentY)),
+                _mm_mul_ps(_mm_set1_ps(glm::abs(plane.z)), extentZ));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        auto mask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+        for (uint32_t j = 0; mask != 0; j++, mask >>= 1) {
+            if (mask & 1) {
+                visible.push_back(i + j);
+            }
+        }
+    }
+#endif
+
+    for (; i < end; i++) {
+        auto center = glm::vec3(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]);
+        auto extent = glm::vec3(bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]);
+        bool inside = true;
+        for (const auto& plane : planes_) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w + glm::dot(glm::abs(glm::vec3(plane)), extent) < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) {
+            visible.push_back(i);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef FRUSTUM_CULLER_HPP
+#define FRUSTUM_CULLER_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ThreadPool.hpp"
+
+struct BoundsArray {
+    std::vector<float> centerX, centerY, centerZ, extentX, extentY, extentZ;
+
+    uint32_t GetCount() const;
+    void Resize(uint32_t count);
+    void Set(uint32_t index, const glm::vec3& center, const glm::vec3& extent);
+};
+
+struct CullStats {
+    uint32_t tested = 0, visible = 0;
+    double milliseconds = 0.0;
+};
+
+class FrustumCuller {
+public:
+    FrustumCuller(ThreadPool* threadPool);
+
+    void BeginFrame(const glm::mat4& viewProjection);
+    void Cull(const BoundsArray& bounds, std::vector<uint32_t>& visible);
+    const CullStats& GetStats() const;
+
+private:
+    const uint32_t PARALLEL_CHUNK_SIZE = 16384;
+
+    void CullRange(const BoundsArray& bounds, uint32_t begin, uint32_t end, std::vector<uint32_t>& visible) const;
+
+    ThreadPool* threadPool_;
+    std::array<glm::vec4, 6> planes_;
+    std::vector<std::vector<uint32_t>> chunkVisible_;
+    CullStats stats_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "GltfModel.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+
+#include <cgltf.h>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Profiler.hpp"
+
+GltfModel::GltfModel(const std::string& path, TangentSpaceGenerator& tangentSpaceGenerator) :
+    path_(path),
+    file_(std::make_shared<MappedFile>(path))
+{
+    PROFILE_SCOPE("LoadGltf");
+
+    cgltf_options options{};
+    cgltf_data* data = nullptr;
+    auto result = cgltf_parse(&options, file_->GetData(), file_->GetSize(), &data);
+    if (result == cgltf_result_success && data->file_type != cgltf_file_type_glb) {
+        std::cerr << "Only binary glTF (.glb) files are supported: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (result == cgltf_result_success) {
+        for (cgltf_size i = 0; i < data->buffers_count; i++) {
+            if (data->buffers[i].uri != nullptr) {
+                std::cerr << "External glTF buffers are not supported: " << data->buffers[i].uri << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        result = cgltf_validate(data);
+    }
+    if (result == cgltf_result_success) {
+        result = cgltf_load_buffers(&options, data, path.c_str());
+    }
+    if (result != cgltf_result_success) {
+        std::cerr << "Load glTF failed: " << path << " (error " << static_cast<int32_t>(result) << ")" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    LoadMeshes(data, tangentSpaceGenerator);
+
+    auto scene = data->scene != nullptr ? data->scene : (data->scenes_count > 0 ? data->scenes : nullptr);
+    if (scene != nullptr) {
+        for (cgltf_size i = 0; i < scene->nodes_count; i++) {
+            AddNode(data, scene->nodes[i]);
+        }
+    } else {
+        for (cgltf_size i = 0; i < data->nodes_count; i++) {
+            if (data->nodes[i].parent == nullptr) {
+                AddNode(data, &data->nodes[i]);
+            }
+        }
+    }
+
+    stats_.meshes = static_cast<uint32_t>(data->meshes_count);
+    stats_.primitives = static_cast<uint32_t>(meshes_.size());
+    stats_.draws = static_cast<uint32_t>(draws_.size());
+    stats_.mappedBytes = file_->GetSize();
+
+    cgltf_free(data);
+    primitiveMeshes_.clear();
+    imageTextures_.clear();
+    materialTextures_.clear();
+}
+
+const std::vector<std::shared_ptr<Mesh>>& GltfModel::GetMeshes() const
+{
+    return meshes_;
+}
+
+const std::vector<ModelDraw>& GltfModel::GetDraws() const
+{
+    return draws_;
+}
+
+const ModelStats& GltfModel::GetStats() const
+{
+    return stats_;
+}
+
+void GltfModel::LoadMeshes(const cgltf_data* data, TangentSpaceGenerator& tangentSpaceGenerator)
+{
+    imageTextures_.resize(data->images_count);
+    materialTextures_.resize(data->materials_count);
+    primitiveMeshes_.resize(data->meshes_count);
+    for (cgltf_size i = 0; i < data->meshes_count; i++) {
+        const auto& mesh = data->meshes[i];
+        for (cgltf_size j = 0; j < mesh.primitives_count; j++) {
+            const auto& primitive = mesh.primitives[j];
+            if (primitive.type != cgltf_primitive_type_triangles || primitive.has_draco_mesh_compression) {
+                std::cerr << "Skipping unsupported primitive " << j << " of mesh " << i << std::endl;
+                continue;
+            }
+
+            const cgltf_accessor* positions = nullptr;
+            const cgltf_accessor* uvs = nullptr;
+            const cgltf_accessor* normals = nullptr;
+            const cgltf_accessor* tangents = nullptr;
+            for (cgltf_size k = 0; k < primitive.attributes_count; k++) {
+                const auto& attribute = primitive.attributes[k];
+                if (attribute.type == cgltf_attribute_type_position) {
+                    positions = attribute.data;
+                } else if (attribute.type == cgltf_attribute_type_texcoord && attribute.index == 0) {
+                    uvs = attribute.data;
+                } else if (attribute.type == cgltf_attribute_type_normal) {
+                    normals = attribute.data;
+                } else if (attribute.type == cgltf_attribute_type_tangent) {
+                    tangents = attribute.data;
+                }
+            }
+            if (positions == nullptr || positions->type != cgltf_type_vec3 ||
+                positions->component_type != cgltf_component_type_r_32f) {
+                std::cerr << "Skipping primitive " << j << " of mesh " << i << " without float3 positions" << std::endl;
+                continue;
+            }
+
+            MeshSource source;
+            source.file = file_;
+            source.vertexCount = static_cast<uint32_t>(positions->count);
+            source.positions = GetAccessor(positions);
+            if (uvs != nullptr && uvs->type == cgltf_type_vec2) {
+                source.uvs = GetAccessor(uvs);
+            }
+            if (normals != nullptr && normals->type == cgltf_type_vec3 &&
+                normals->component_type == cgltf_component_type_r_32f) {
+                source.normals = GetAccessor(normals);
+            }
+            if (tangents != nullptr && tangents->type == cgltf_type_vec4 &&
+                tangents->component_type == cgltf_component_type_r_32f) {
+                source.tangents = GetAccessor(tangents);
+            }
+            if (primitive.indices != nullptr) {
+                source.indexCount = static_cast<uint32_t>(primitive.indices->count);
+                source.indices = GetAccessor(primitive.indices);
+            } else {
+                source.indexCount = source.vertexCount;
+            }
+
+            if (positions->has_min && positions->has_max) {
+                source.bounds = {glm::make_vec3(positions->min), glm::make_vec3(positions->max)};
+            } else {
+                source.bounds = {glm::vec3(std::numeric_limits<float>::max()),
+                    glm::vec3(std::numeric_limits<float>::lowest())};
+                for (uint32_t k = 0; k < source.vertexCount; k++) {
+                    glm::vec3 position;
+                    memcpy(&position, source.positions.data + source.positions.stride * k, sizeof(position));
+                    source.bounds.min = glm::min(source.bounds.min, position);
+                    source.bounds.max = glm::max(source.bounds.max, position);
+                }
+            }
+
+            auto meshIndex = static_cast<uint32_t>(meshes_.size());
+            source.tangentCachePath = path_ + "." + std::to_string(meshIndex) + ".tspace";
+            source.tangentCacheKey = TangentSpaceGenerator::GetCacheKey(path_, meshIndex);
+            primitiveMeshes_[i].push_back(meshIndex);
+            meshes_.push_back(std::make_shared<Mesh>(std::move(source), GetMaterialTexture(data, primitive.material),
+                tangentSpaceGenerator));
+        }
+    }
+}
+
+void GltfModel::AddNode(const cgltf_data* data, const cgltf_node* node)
+{
+    if (node->mesh != nullptr) {
+        float matrix[16];
+        cgltf_node_transform_world(node, matrix);
+        auto transform = glm::make_mat4(matrix);
+        for (auto mesh : primitiveMeshes_[node->mesh - data->meshes]) {
+            draws_.push_back({mesh, transform});
+        }
+    }
+    for (cgltf_size i = 0; i < node->children_count; i++) {
+        AddNode(data, node->children[i]);
+    }
+}
+
+std::shared_ptr<Texture> GltfModel::GetMaterialTexture(const cgltf_data* data, const cgltf_material* material)
+{
+    if (material == nullptr) {
+        if (!defaultTexture_) {
+            defaultTexture_ = std::make_shared<Texture>(std::make_shared<Image>(glm::vec4(1.0f)));
+        }
+        return defaultTexture_;
+    }
+
+    auto& materialTexture = materialTextures_[material - data->materials];
+    if (materialTexture) {
+        return materialTexture;
+    }
+
+    const auto& pbr = material->pbr_metallic_roughness;
+    auto texture = material->has_pbr_metallic_roughness ? pbr.base_color_texture.texture : nullptr;
+    auto image = texture != nullptr ? texture->image : nullptr;
+    if (image == nullptr) {
+        auto color = material->has_pbr_metallic_roughness ? glm::make_vec4(pbr.base_color_factor) : glm::vec4(1.0f);
+        materialTexture = std::make_shared<Texture>(std::make_shared<Image>(color));
+        return materialTexture;
+    }
+
+    auto& imageTexture = imageTextures_[image - data->images];
+    if (!imageTexture) {
+        if (image->buffer_view != nullptr) {
+            auto view = image->buffer_view;
+            auto bytes = static_cast<const uint8_t*>(view->buffer->data) + view->offset;
+            imageTexture = std::make_shared<Texture>(std::make_shared<Image>(bytes, view->size));
+        } else if (image->uri != nullptr && std::string(image->uri).rfind("data:", 0) != 0) {
+            auto imagePath = std::filesystem::path(path_).parent_path() / image->uri;
+            imageTexture = std::make_shared<Texture>(std::make_shared<Image>(imagePath.string()));
+        } else {
+            std::cerr << "Unsupported glTF image source, using base color factor" << std::endl;
+            imageTexture = std::make_shared<Texture>(std::make_shared<Image>(glm::make_vec4(pbr.base_color_factor)));
+        }
+    }
+    materialTexture = imageTexture;
+    return materialTexture;
+}
+
+MeshAccessor GltfModel::GetAccessor(const cgltf_accessor* accessor) const
+{
+    if (accessor->is_sparse || accessor->buffer_view == nullptr) {
+        std::cerr << "Sparse glTF accessors are not supported: " << path_ << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    MeshAccessor meshAccessor;
+    const auto& view = *accessor->buffer_view;
+    meshAccessor.data = static_cast<const uint8_t*>(view.buffer->data) + view.offset + accessor->offset;
+    meshAccessor.stride = accessor->stride;
+    if (accessor->component_type == cgltf_component_type_r_8u) {
+        meshAccessor.componentType = ComponentType::UnsignedByte;
+    } else if (accessor->component_type == cgltf_component_type_r_16u) {
+        meshAccessor.componentType = ComponentType::UnsignedShort;
+    } else if (accessor->component_type == cgltf_component_type_r_32u) {
+        meshAccessor.componentType = ComponentType::UnsignedInt;
+    } else if (accessor->component_type == cgltf_component_type_r_32f) {
+        meshAccessor.componentType = ComponentType::Float;
+    } else {
+        std::cerr << "Unsupported glTF component type in " << path_ << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return meshAccessor;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef GLTF_MODEL_HPP
+#define GLTF_MODEL_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MappedFile.hpp"
+#include "Mesh.hpp"
+#include "TangentSpace.hpp"
+#include "Texture.hpp"
+
+struct cgltf_data;
+struct cgltf_node;
+struct cgltf_accessor;
+struct cgltf_material;
+
+struct ModelDraw {
+    uint32_t mesh;
+    glm::mat4 transform;
+};
+
+struct ModelStats {
+    uint32_t meshes = 0, primitives = 0, draws = 0;
+    uint64_t mappedBytes = 0;
+};
+
+class GltfModel {
+public:
+    GltfModel(const std::string& path, TangentSpaceGenerator& tangentSpaceGenerator);
+
+    const std::vector<std::shared_ptr<Mesh>>& GetMeshes() const;
+    const std::vector<ModelDraw>& GetDraws() const;
+    const ModelStats& GetStats() const;
+
+private:
+    void LoadMeshes(const cgltf_data* data, TangentSpaceGenerator& tangentSpaceGenerator);
+    void AddNode(const cgltf_data* data, const cgltf_node* node);
+    std::shared_ptr<Texture> GetMaterialTexture(const cgltf_data* data, const cgltf_material* material);
+    MeshAccessor GetAccessor(const cgltf_accessor* accessor) const;
+
+    std::string path_;
+    std::shared_ptr<const MappedFile> file_;
+    std::vector<std::shared_ptr<Mesh>> meshes_;
+    std::vector<std::vector<uint32_t>> primitiveMeshes_;
+    std::vector<std::shared_ptr<Texture>> imageTextures_, materialTextures_;
+    std::shared_ptr<Texture> defaultTexture_;
+    std::vector<ModelDraw> draws_;
+    ModelStats stats_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "GpuCuller.hpp"
+
+#include <algorithm>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+GpuCuller::GpuCuller(uint32_t maxBatches, bool occlusion) :
+    maxBatches_(std::max(maxBatches, 1u)),
+    occlusion_(occlusion),
+    commands_(maxBatches_ * (occlusion ? 2 : 1)),
+    visibleOffsets_(maxBatches_)
+{
+    CreateDescriptorSetLayout();
+    CreatePipeline();
+    descriptorSets_.resize(maxBatches_);
+
+    VulkanContext::Instance().CreateBuffer(sizeof(VkDrawIndexedIndirectCommand) * commands_.size(),
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        {}, indirectBuffer_, indirectAllocation_);
+}
+
+GpuCuller::~GpuCuller()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    if (visibleBuffer_ != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(context.GetAllocator(), visibleBuffer_, visibleAllocation_);
+    }
+    if (flagBuffer_ != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(context.GetAllocator(), flagBuffer_, flagAllocation_);
+    }
+    vmaDestroyBuffer(context.GetAllocator(), indirectBuffer_, indirectAllocation_);
+    vkDestroyPipeline(device, pipeline_, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout_, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout_, nullptr);
+    vkDestroyShaderModule(device, shaderModule_, nullptr);
+}
+
+void GpuCuller::Record(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection,
+    const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches, FrameScheduler& frameScheduler,
+    DescriptorAllocator& descriptorAllocator, DeletionQueue& deletionQueue, HiZPyramid* hiZPyramid)
+{
+    PROFILE_SCOPE("RecordCulling");
+
+    auto device = VulkanContext::Instance().GetDevice();
+    batchCount_ = std::min(static_cast<uint32_t>(instanceBatches.size()), maxBatches_);
+    viewProjection_ = viewProjection;
+
+    visibleCount_ = 0;
+    for (uint32_t i = 0; i < batchCount_; i++) {
+        const auto& mesh = instanceBatches[i]->GetMesh();
+        commands_[i] = {mesh->GetIndexCount(), 0, 0, 0, 0};
+        if (occlusion_) {
+            commands_[maxBatches_ + i] = commands_[i];
+        }
+        visibleOffsets_[i] = visibleCount_;
+        visibleCount_ += instanceBatches[i]->GetResidentCount();
+    }
+    if (visibleCount_ == 0) {
+        return;
+    }
+    if (visibleCount_ > visibleCapacity_) {
+        GrowVisibleBuffer(std::max(visibleCount_, visibleCapacity_ * 2), deletionQueue,
+            frameScheduler.GetFrameNumber());
+    }
+    if (occlusion_) {
+        hiZPyramid->Prepare(commandBuffer);
+    }
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 0,
+        nullptr);
+
+    UpdateCommands(commandBuffer, 0, batchCount_);
+    if (occlusion_) {
+        UpdateCommands(commandBuffer, maxBatches_, batchCount_);
+    }
+
+    VkMemoryBarrier updateBarrier{};
+    updateBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    updateBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    updateBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+        &updateBarrier, 0, nullptr, 0, nullptr);
+
+    uint32_t bindingCount = occlusion_ ? 5 : 3;
+    std::vector<VkDescriptorBufferInfo> bufferInfos(batchCount_ * 4);
+    VkDescriptorImageInfo imageInfo{};
+    std::vector<VkWriteDescriptorSet> writeDescriptorSets(batchCount_ * bindingCount);
+    if (occlusion_) {
+        imageInfo = {hiZPyramid->GetSampler(), hiZPyramid->GetImageView(), VK_IMAGE_LAYOUT_GENERAL};
+    }
+    for (uint32_t i = 0; i < batchCount_; i++) {
+        descriptorSets_[i] = descriptorAllocator.AllocateFrame(frameScheduler.GetFrameSlot(), descriptorSetLayout_);
+        bufferInfos[i * 4] = {instanceBatches[i]->GetBuffer(), 0, VK_WHOLE_SIZE};
+        bufferInfos[i * 4 + 1] = {visibleBuffer_, 0, VK_WHOLE_SIZE};
+        bufferInfos[i * 4 + 2] = {indirectBuffer_, 0, VK_WHOLE_SIZE};
+        bufferInfos[i * 4 + 3] = {flagBuffer_, 0, VK_WHOLE_SIZE};
+        for (uint32_t j = 0; j < bindingCount; j++) {
+            auto& writeDescriptorSet = writeDescriptorSets[i * bindingCount + j];
+            writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptorSet.dstSet = descriptorSets_[i];
+            writeDescriptorSet.dstBinding = j;
+            writeDescriptorSet.dstArrayElement = 0;
+            writeDescriptorSet.descriptorCount = 1;
+            if (j < 4) {
+                writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writeDescriptorSet.pBufferInfo = &bufferInfos[i * 4 + j];
+            } else {
+                writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                writeDescriptorSet.pImageInfo = &imageInfo;
+            }
+        }
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0,
+        nullptr);
+
+    if (occlusion_ && hiZPyramid->IsBuilt()) {
+        Dispatch(commandBuffer, instanceBatches, CullPhase::Early, hiZPyramid->GetLevelCount(),
+            glm::vec2(hiZPyramid->GetWidth(), hiZPyramid->GetHeight()));
+    } else {
+        Dispatch(commandBuffer, instanceBatches, CullPhase::Early, 0, glm::vec2(0.0f));
+    }
+}
+
+void GpuCuller::RecordLate(VkCommandBuffer commandBuffer,
+    const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches, const HiZPyramid& hiZPyramid)
+{
+    PROFILE_SCOPE("RecordLateCulling");
+
+    if (!occlusion_ || visibleCount_ == 0) {
+        return;
+    }
+
+    VkMemoryBarrier flagBarrier{};
+    flagBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    flagBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    flagBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &flagBarrier, 0, nullptr, 0, nullptr);
+
+    Dispatch(commandBuffer, instanceBatches, CullPhase::Late, hiZPyramid.GetLevelCount(),
+        glm::vec2(hiZPyramid.GetWidth(), hiZPyramid.GetHeight()));
+}
+
+void GpuCuller::Draw(VkCommandBuffer commandBuffer, uint32_t batchIndex, const InstanceBatch& instanceBatch,
+    CullPhase phase, VertexStream stream) const
+{
+    if (batchIndex >= batchCount_ || instanceBatch.GetResidentCount() == 0) {
+        return;
+    }
+    if (phase == CullPhase::Late && !occlusion_) {
+        return;
+    }
+
+    auto commandIndex = phase == CullPhase::Late ? maxBatches_ + batchIndex : batchIndex;
+    auto visibleOffset = phase == CullPhase::Late ? visibleCount_ + visibleOffsets_[batchIndex] :
+        visibleOffsets_[batchIndex];
+
+    instanceBatch.GetMesh()->BindBuffers(commandBuffer, stream);
+    VkDeviceSize offset = sizeof(glm::mat4) * visibleOffset;
+    vkCmdBindVertexBuffers(commandBuffer, 1, 1, &visibleBuffer_, &offset);
+    vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer_, sizeof(VkDrawIndexedIndirectCommand) * commandIndex, 1,
+        sizeof(VkDrawIndexedIndirectCommand));
+}
+
+void GpuCuller::UpdateCommands(VkCommandBuffer commandBuffer, uint32_t firstCommand, uint32_t commandCount)
+{
+    VkDeviceSize commandsOffset = sizeof(VkDrawIndexedIndirectCommand) * firstCommand;
+    VkDeviceSize commandsSize = sizeof(VkDrawIndexedIndirectCommand) * commandCount;
+    VkDeviceSize chunkSize = MAX_UPDATE_SIZE - MAX_UPDATE_SIZE % sizeof(VkDrawIndexedIndirectCommand);
+    for (VkDeviceSize offset = 0; offset < commandsSize; offset += chunkSize) {
+        vkCmdUpdateBuffer(commandBuffer, indirectBuffer_, commandsOffset + offset,
+            std::min(chunkSize, commandsSize - offset),
+            reinterpret_cast<const uint8_t*>(commands_.data()) + commandsOffset + offset);
+    }
+}
+
+void GpuCuller::Dispatch(VkCommandBuffer commandBuffer,
+    const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches, CullPhase phase, uint32_t pyramidLevels,
+    const glm::vec2& pyramidSize)
+{
+    auto late = phase == CullPhase::Late;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    for (uint32_t i = 0; i < batchCount_; i++) {
+        auto residentCount = instanceBatches[i]->GetResidentCount();
+        if (residentCount == 0) {
+            continue;
+        }
+
+        const auto& bounds = instanceBatches[i]->GetMesh()->GetBounds();
+        CullConstants constants{};
+        constants.viewProjection = viewProjection_;
+        constants.boundsMin = glm::vec4(bounds.min, 1.0f);
+        constants.boundsMax = glm::vec4(bounds.max, 1.0f);
+        constants.instanceCount = residentCount;
+        constants.commandIndex = late ? maxBatches_ + i : i;
+        constants.visibleOffset = late ? visibleCount_ + visibleOffsets_[i] : visibleOffsets_[i];
+        constants.flagOffset = visibleOffsets_[i];
+        constants.latePhase = late ? 1 : 0;
+        constants.pyramidLevels = pyramidLevels;
+        constants.pyramidSize = pyramidSize;
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_, 0, 1,
+            &descriptorSets_[i], 0, nullptr);
+        vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants),
+            &constants);
+        vkCmdDispatch(commandBuffer, (residentCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    VkMemoryBarrier cullBarrier{};
+    cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &cullBarrier, 0, nullptr, 0,
+        nullptr);
+}
+
+void GpuCuller::CreateDescriptorSetLayout()
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings(occlusion_ ? 5 : 3);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i < 4 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER :
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    createInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    createInfo.pBindings = bindings.data();
+    VULKAN_CHECK(vkCreateDescriptorSetLayout(VulkanContext::Instance().GetDevice(), &createInfo, nullptr,
+        &descriptorSetLayout_));
+}
+
+void GpuCuller::CreatePipeline()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    shaderModule_ = context.CreateShaderModule(occlusion_ ? "shader/cull_occlusion.comp.spv" :
+        "shader/cull.comp.spv");
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &descriptorSetLayout_;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    VULKAN_CHECK(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayout_));
+
+    VkComputePipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    createInfo.stage.module = shaderModule_;
+    createInfo.stage.pName = "main";
+    createInfo.layout = pipelineLayout_;
+    VULKAN_CHECK(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline_));
+}
+
+void GpuCuller::GrowVisibleBuffer(uint32_t capacity, DeletionQueue& deletionQueue, uint64_t frameNumber)
+{
+    if (visibleBuffer_ != VK_NULL_HANDLE) {
+        deletionQueue.Push(frameNumber, [oldBuffer = visibleBuffer_, oldAllocation = visibleAllocation_]() {
+            vmaDestroyBuffer(VulkanContext::Instance().GetAllocator(), oldBuffer, oldAllocation);
+        });
+    }
+
+    VulkanContext::Instance().CreateBuffer(sizeof(glm::mat4) * capacity * (occlusion_ ? 2 : 1),
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, {}, visibleBuffer_,
+        visibleAllocation_);
+    if (occlusion_) {
+        if (flagBuffer_ != VK_NULL_HANDLE) {
+            deletionQueue.Push(frameNumber, [oldBuffer = flagBuffer_, oldAllocation = flagAllocation_]() {
+                vmaDestroyBuffer(VulkanContext::Instance().GetAllocator(), oldBuffer, oldAllocation);
+            });
+        }
+        VulkanContext::Instance().CreateBuffer(sizeof(uint32_t) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, {},
+            flagBuffer_, flagAllocation_);
+    }
+    visibleCapacity_ = capacity;
+}
\ No newline at end of file
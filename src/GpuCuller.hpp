@@ -0,0 +1,78 @@
+#ifndef GPU_CULLER_HPP
+#define GPU_CULLER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "DeletionQueue.hpp"
+#include "DescriptorAllocator.hpp"
+#include "FrameScheduler.hpp"
+#include "HiZPyramid.hpp"
+#include "InstanceBatch.hpp"
+
+enum class CullPhase {
+    Early,
+    Late
+};
+
+class GpuCuller {
+public:
+    GpuCuller(uint32_t maxBatches, bool occlusion);
+    ~GpuCuller();
+
+    GpuCuller(const GpuCuller&) = delete;
+    GpuCuller& operator=(const GpuCuller&) = delete;
+
+    void Record(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection,
+        const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches, FrameScheduler& frameScheduler,
+        DescriptorAllocator& descriptorAllocator, DeletionQueue& deletionQueue, HiZPyramid* hiZPyramid);
+    void RecordLate(VkCommandBuffer commandBuffer, const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches,
+        const HiZPyramid& hiZPyramid);
+    void Draw(VkCommandBuffer commandBuffer, uint32_t batchIndex, const InstanceBatch& instanceBatch,
+        CullPhase phase, VertexStream stream = VertexStream::Full) const;
+
+private:
+    struct CullConstants {
+        glm::mat4 viewProjection;
+        glm::vec4 boundsMin, boundsMax;
+        uint32_t instanceCount, commandIndex, visibleOffset, flagOffset, latePhase, pyramidLevels;
+        glm::vec2 pyramidSize;
+    };
+
+    const uint32_t WORKGROUP_SIZE = 64;
+    const VkDeviceSize MAX_UPDATE_SIZE = 65536;
+
+    void CreateDescriptorSetLayout();
+    void CreatePipeline();
+    void GrowVisibleBuffer(uint32_t capacity, DeletionQueue& deletionQueue, uint64_t frameNumber);
+    void UpdateCommands(VkCommandBuffer commandBuffer, uint32_t firstCommand, uint32_t commandCount);
+    void Dispatch(VkCommandBuffer commandBuffer, const std::vector<std::unique_ptr<InstanceBatch>>& instanceBatches,
+        CullPhase phase, uint32_t pyramidLevels, const glm::vec2& pyramidSize);
+
+    uint32_t maxBatches_;
+    bool occlusion_;
+    VkShaderModule shaderModule_;
+    VkDescriptorSetLayout descriptorSetLayout_;
+    VkPipelineLayout pipelineLayout_;
+    VkPipeline pipeline_;
+    std::vector<VkDescriptorSet> descriptorSets_;
+    std::vector<VkDrawIndexedIndirectCommand> commands_;
+    std::vector<uint32_t> visibleOffsets_;
+    glm::mat4 viewProjection_;
+    uint32_t batchCount_ = 0;
+    uint32_t visibleCount_ = 0;
+    VkBuffer indirectBuffer_;
+    VmaAllocation indirectAllocation_;
+    VkBuffer visibleBuffer_ = VK_NULL_HANDLE;
+    VmaAllocation visibleAllocation_ = VK_NULL_HANDLE;
+    VkBuffer flagBuffer_ = VK_NULL_HANDLE;
+    VmaAllocation flagAllocation_ = VK_NULL_HANDLE;
+    uint32_t visibleCapacity_ = 0;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "GpuTimer.hpp"
+
+#include "VulkanContext.hpp"
+
+GpuTimer::GpuTimer(uint32_t slotCount) :
+    frameIndices_(slotCount, 0),
+    pending_(slotCount, false)
+{
+    auto& context = VulkanContext::Instance();
+    auto properties = context.GetPhysicalDeviceProperties();
+    supported_ = properties.limits.timestampComputeAndGraphics == VK_TRUE;
+    timestampPeriod_ = static_cast<double>(properties.limits.timestampPeriod);
+    if (!supported_) {
+        return;
+    }
+
+    VkQueryPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    createInfo.queryCount = slotCount * 2;
+    VULKAN_CHECK(vkCreateQueryPool(context.GetDevice(), &createInfo, nullptr, &queryPool_));
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (queryPool_ != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(VulkanContext::Instance().GetDevice(), queryPool_, nullptr);
+    }
+}
+
+void GpuTimer::Begin(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t frameIndex)
+{
+    if (!supported_) {
+        return;
+    }
+
+    vkCmdResetQueryPool(commandBuffer, queryPool_, slot * 2, 2);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, slot * 2);
+    frameIndices_[slot] = frameIndex;
+}
+
+void GpuTimer::End(VkCommandBuffer commandBuffer, uint32_t slot)
+{
+    if (!supported_) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_, slot * 2 + 1);
+    pending_[slot] = true;
+}
+
+bool GpuTimer::Resolve(uint32_t slot, uint32_t& frameIndex, double& milliseconds)
+{
+    if (!supported_ || !pending_[slot]) {
+        return false;
+    }
+
+    uint64_t timestamps[2];
+    auto result = vkGetQueryPoolResults(VulkanContext::Instance().GetDevice(), queryPool_, slot * 2, 2,
+        sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return false;
+    }
+
+    pending_[slot] = false;
+    frameIndex = frameIndices_[slot];
+    milliseconds = static_cast<double>(timestamps[1] - timestamps[0]) * timestampPeriod_ / 1e6;
+    return true;
+}
\ No newline at end of file
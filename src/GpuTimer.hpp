@@ -0,0 +1,26 @@
+#ifndef GPU_TIMER_HPP
+#define GPU_TIMER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+class GpuTimer {
+public:
+    GpuTimer(uint32_t slotCount);
+    ~GpuTimer();
+
+    void Begin(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t frameIndex);
+    void End(VkCommandBuffer commandBuffer, uint32_t slot);
+    bool Resolve(uint32_t slot, uint32_t& frameIndex, double& milliseconds);
+
+private:
+    bool supported_;
+    double timestampPeriod_;
+    VkQueryPool queryPool_ = VK_NULL_HANDLE;
+    std::vector<uint32_t> frameIndices_;
+    std::vector<bool> pending_;
+};
+
+#endif
\ No newline at end of file
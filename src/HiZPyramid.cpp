@@ -0,0 +1,297 @@
+#include "HiZPyramid.hpp"
+
+#include <algorithm>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+HiZPyramid::HiZPyramid(uint32_t depthWidth, uint32_t depthHeight)
+{
+    CreateDescriptorSetLayout();
+    CreatePipeline();
+    CreateSampler();
+    CreateImage(depthWidth, depthHeight);
+}
+
+HiZPyramid::~HiZPyramid()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+
+    DestroyImage();
+    vkDestroySampler(device, sampler_, nullptr);
+    vkDestroyPipeline(device, pipeline_, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout_, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout_, nullptr);
+    vkDestroyShaderModule(device, shaderModule_, nullptr);
+}
+
+void HiZPyramid::Resize(uint32_t depthWidth, uint32_t depthHeight, DeletionQueue& deletionQueue,
+    uint64_t frameNumber)
+{
+    deletionQueue.Push(frameNumber, [image = image_, allocation = allocation_, imageView = imageView_,
+        levelViews = levelViews_]() {
+        auto& context = VulkanContext::Instance();
+        for (auto levelView : levelViews) {
+            vkDestroyImageView(context.GetDevice(), levelView, nullptr);
+        }
+        vkDestroyImageView(context.GetDevice(), imageView, nullptr);
+        vmaDestroyImage(context.GetAllocator(), image, allocation);
+    });
+    CreateImage(depthWidth, depthHeight);
+}
+
+void HiZPyramid::Prepare(VkCommandBuffer commandBuffer)
+{
+    if (prepared_) {
+        return;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image_;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount_, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+        0, nullptr, 0, nullptr, 1, &barrier);
+    prepared_ = true;
+}
+
+void HiZPyramid::Build(VkCommandBuffer commandBuffer, VkImageView depthImageView, VkExtent2D depthExtent,
+    uint32_t frameSlot, DescriptorAllocator& descriptorAllocator)
+{
+    PROFILE_SCOPE("BuildHiZPyramid");
+
+    Prepare(commandBuffer);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    auto device = VulkanContext::Instance().GetDevice();
+    std::vector<VkDescriptorSet> descriptorSets(levelCount_);
+    std::vector<VkDescriptorImageInfo> imageInfos(levelCount_ * 2);
+    std::vector<VkWriteDescriptorSet> writeDescriptorSets(levelCount_ * 2);
+    for (uint32_t i = 0; i < levelCount_; i++) {
+        descriptorSets[i] = descriptorAllocator.AllocateFrame(frameSlot, descriptorSetLayout_);
+        if (i == 0) {
+            imageInfos[i * 2] = {sampler_, depthImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        } else {
+            imageInfos[i * 2] = {sampler_, levelViews_[i - 1], VK_IMAGE_LAYOUT_GENERAL};
+        }
+        imageInfos[i * 2 + 1] = {VK_NULL_HANDLE, levelViews_[i], VK_IMAGE_LAYOUT_GENERAL};
+        for (uint32_t j = 0; j < 2; j++) {
+            auto& writeDescriptorSet = writeDescriptorSets[i * 2 + j];
+            writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptorSet.dstSet = descriptorSets[i];
+            writeDescriptorSet.dstBinding = j;
+            writeDescriptorSet.dstArrayElement = 0;
+            writeDescriptorSet.descriptorType = j == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER :
+                VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writeDescriptorSet.descriptorCount = 1;
+            writeDescriptorSet.pImageInfo = &imageInfos[i * 2 + j];
+        }
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0,
+        nullptr);
+
+    VkImageMemoryBarrier levelBarrier{};
+    levelBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    levelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    levelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    levelBarrier.image = image_;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    auto sourceWidth = depthExtent.width, sourceHeight = depthExtent.height;
+    for (uint32_t i = 0; i < levelCount_; i++) {
+        auto destinationWidth = std::max(width_ >> i, 1u), destinationHeight = std::max(height_ >> i, 1u);
+        ReduceConstants constants{static_cast<int32_t>(sourceWidth), static_cast<int32_t>(sourceHeight),
+            static_cast<int32_t>(destinationWidth), static_cast<int32_t>(destinationHeight)};
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_, 0, 1,
+            &descriptorSets[i], 0, nullptr);
+        vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants),
+            &constants);
+        vkCmdDispatch(commandBuffer, (destinationWidth + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+            (destinationHeight + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+
+        levelBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &levelBarrier);
+        sourceWidth = destinationWidth;
+        sourceHeight = destinationHeight;
+    }
+    built_ = true;
+}
+
+bool HiZPyramid::IsBuilt() const
+{
+    return built_;
+}
+
+VkImageView HiZPyramid::GetImageView() const
+{
+    return imageView_;
+}
+
+VkSampler HiZPyramid::GetSampler() const
+{
+    return sampler_;
+}
+
+uint32_t HiZPyramid::GetWidth() const
+{
+    return width_;
+}
+
+uint32_t HiZPyramid::GetHeight() const
+{
+    return height_;
+}
+
+uint32_t HiZPyramid::GetLevelCount() const
+{
+    return levelCount_;
+}
+
+void HiZPyramid::CreateDescriptorSetLayout()
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    createInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    createInfo.pBindings = bindings.data();
+    VULKAN_CHECK(vkCreateDescriptorSetLayout(VulkanContext::Instance().GetDevice(), &createInfo, nullptr,
+        &descriptorSetLayout_));
+}
+
+void HiZPyramid::CreatePipeline()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+
+    shaderModule_ = context.CreateShaderModule("shader/hiz.comp.spv");
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(ReduceConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &descriptorSetLayout_;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    VULKAN_CHECK(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayout_));
+
+    VkComputePipelineCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    createInfo.stage.module = shaderModule_;
+    createInfo.stage.pName = "main";
+    createInfo.layout = pipelineLayout_;
+    VULKAN_CHECK(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &pipeline_));
+}
+
+void HiZPyramid::CreateSampler()
+{
+    VkSamplerCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    createInfo.magFilter = VK_FILTER_NEAREST;
+    createInfo.minFilter = VK_FILTER_NEAREST;
+    createInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    createInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    createInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    createInfo.anisotropyEnable = VK_FALSE;
+    createInfo.maxAnisotropy = 1.0f;
+    createInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    createInfo.unnormalizedCoordinates = VK_FALSE;
+    createInfo.compareEnable = VK_FALSE;
+    createInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    createInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    createInfo.mipLodBias = 0.0f;
+    createInfo.minLod = 0.0f;
+    createInfo.maxLod = VK_LOD_CLAMP_NONE;
+    VULKAN_CHECK(vkCreateSampler(VulkanContext::Instance().GetDevice(), &createInfo, nullptr, &sampler_));
+}
+
+void HiZPyramid::CreateImage(uint32_t depthWidth, uint32_t depthHeight)
+{
+    auto& context = VulkanContext::Instance();
+
+    width_ = 1;
+    while (width_ * 2 <= depthWidth) {
+        width_ *= 2;
+    }
+    height_ = 1;
+    while (height_ * 2 <= depthHeight) {
+        height_ *= 2;
+    }
+    levelCount_ = 1;
+    while ((std::max(width_, height_) >> levelCount_) > 0) {
+        levelCount_++;
+    }
+
+    VkImageCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    createInfo.imageType = VK_IMAGE_TYPE_2D;
+    createInfo.extent = {width_, height_, 1};
+    createInfo.mipLevels = levelCount_;
+    createInfo.arrayLayers = 1;
+    createInfo.format = VK_FORMAT_R32_SFLOAT;
+    createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    createInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocationInfo{};
+    allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    VULKAN_CHECK(vmaCreateImage(context.GetAllocator(), &createInfo, &allocationInfo, &image_, &allocation_,
+        nullptr));
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image_;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount_, 0, 1};
+    VULKAN_CHECK(vkCreateImageView(context.GetDevice(), &viewInfo, nullptr, &imageView_));
+
+    levelViews_.resize(levelCount_);
+    for (uint32_t i = 0; i < levelCount_; i++) {
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+        VULKAN_CHECK(vkCreateImageView(context.GetDevice(), &viewInfo, nullptr, &levelViews_[i]));
+    }
+
+    prepared_ = false;
+    built_ = false;
+}
+
+void HiZPyramid::DestroyImage()
+{
+    auto& context = VulkanContext::Instance();
+
+    for (auto levelView : levelViews_) {
+        vkDestroyImageView(context.GetDevice(), levelView, nullptr);
+    }
+    vkDestroyImageView(context.GetDevice(), imageView_, nullptr);
+    vmaDestroyImage(context.GetAllocator(), image_, allocation_);
+}
\ No newline at end of file
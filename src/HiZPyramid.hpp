@@ -0,0 +1,59 @@
+#ifndef HI_Z_PYRAMID_HPP
+#define HI_Z_PYRAMID_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "DeletionQueue.hpp"
+#include "DescriptorAllocator.hpp"
+
+class HiZPyramid {
+public:
+    HiZPyramid(uint32_t depthWidth, uint32_t depthHeight);
+    ~HiZPyramid();
+
+    HiZPyramid(const HiZPyramid&) = delete;
+    HiZPyramid& operator=(const HiZPyramid&) = delete;
+
+    void Resize(uint32_t depthWidth, uint32_t depthHeight, DeletionQueue& deletionQueue, uint64_t frameNumber);
+    void Prepare(VkCommandBuffer commandBuffer);
+    void Build(VkCommandBuffer commandBuffer, VkImageView depthImageView, VkExtent2D depthExtent,
+        uint32_t frameSlot, DescriptorAllocator& descriptorAllocator);
+    bool IsBuilt() const;
+    VkImageView GetImageView() const;
+    VkSampler GetSampler() const;
+    uint32_t GetWidth() const;
+    uint32_t GetHeight() const;
+    uint32_t GetLevelCount() const;
+
+private:
+    struct ReduceConstants {
+        int32_t sourceWidth, sourceHeight, destinationWidth, destinationHeight;
+    };
+
+    const uint32_t WORKGROUP_SIZE = 8;
+
+    void CreateDescriptorSetLayout();
+    void CreatePipeline();
+    void CreateSampler();
+    void CreateImage(uint32_t depthWidth, uint32_t depthHeight);
+    void DestroyImage();
+
+    VkShaderModule shaderModule_;
+    VkDescriptorSetLayout descriptorSetLayout_;
+    VkPipelineLayout pipelineLayout_;
+    VkPipeline pipeline_;
+    VkSampler sampler_;
+    VkImage image_;
+    VmaAllocation allocation_;
+    VkImageView imageView_;
+    std::vector<VkImageView> levelViews_;
+    uint32_t width_, height_, levelCount_;
+    bool prepared_ = false;
+    bool built_ = false;
+};
+
+#endif
\ No newline at end of file
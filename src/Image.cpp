@@ -1,11 +1,16 @@
 #include "Image.hpp"
 
+#include <cstdlib>
 #include <iostream>
 
 #include <stb_image.h>
 
+#include "Profiler.hpp"
+
 Image::Image(const std::string& path)
 {
+    PROFILE_SCOPE("LoadImage");
+
     pixels_ = stbi_load(path.c_str(), &width_, &height_, &channels_, STBI_rgb_alpha);
     if (pixels_ == nullptr) {
         std::cerr << "Failed to load image" << std::endl;
@@ -13,6 +18,29 @@ Image::Image(const std::string& path)
     }
 }
 
+Image::Image(const uint8_t* data, size_t size)
+{
+    PROFILE_SCOPE("DecodeImage");
+
+    pixels_ = stbi_load_from_memory(data, static_cast<int>(size), &width_, &height_, &channels_, STBI_rgb_alpha);
+    if (pixels_ == nullptr) {
+        std::cerr << "Failed to decode image: " << stbi_failure_reason() << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+Image::Image(const glm::vec4& color) :
+    width_(1),
+    height_(1),
+    channels_(4)
+{
+    auto texel = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    pixels_ = static_cast<unsigned char*>(malloc(4));
+    for (int32_t i = 0; i < 4; i++) {
+        pixels_[i] = static_cast<unsigned char>(texel[i]);
+    }
+}
+
 Image::~Image()
 {
     stbi_image_free(pixels_);
@@ -1,11 +1,17 @@
 #ifndef IMAGE_HPP
 #define IMAGE_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+#include <glm/glm.hpp>
+
 class Image {
 public:
     Image(const std::string& path);
+    Image(const uint8_t* data, size_t size);
+    Image(const glm::vec4& color);
     ~Image();
     int32_t GetWidth() const;
     int32_t GetHeight() const;
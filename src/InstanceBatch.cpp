@@ -0,0 +1,270 @@
+#include "InstanceBatch.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+InstanceBatch::InstanceBatch(std::shared_ptr<Mesh> mesh, uint32_t capacity) :
+    mesh_(std::move(mesh))
+{
+    transforms_.reserve(capacity);
+    dirty_.reserve(capacity);
+    dirtyInstances_.reserve(capacity);
+}
+
+InstanceBatch::~InstanceBatch()
+{
+    if (buffer_ != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(VulkanContext::Instance().GetAllocator(), buffer_, allocation_);
+    }
+}
+
+VkVertexInputBindingDescription InstanceBatch::GetBindingDescription()
+{
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 1;
+    bindingDescription.stride = sizeof(glm::mat4);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    return bindingDescription;
+}
+
+std::vector<VkVertexInputAttributeDescription> InstanceBatch::GetAttributeDescriptions()
+{
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions(4);
+    for (uint32_t i = 0; i < attributeDescriptions.size(); i++) {
+        attributeDescriptions[i].binding = 1;
+        attributeDescriptions[i].location = 2 + i;
+        attributeDescriptions[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[i].offset = sizeof(glm::vec4) * i;
+    }
+    return attributeDescriptions;
+}
+
+const std::shared_ptr<Mesh>& InstanceBatch::GetMesh() const
+{
+    return mesh_;
+}
+
+uint32_t InstanceBatch::GetInstanceCount() const
+{
+    return static_cast<uint32_t>(transforms_.size());
+}
+
+uint32_t InstanceBatch::GetResidentCount() const
+{
+    return residentCount_;
+}
+
+uint32_t InstanceBatch::GetDrawInstanceCount() const
+{
+    return visibleBuffer_ != VK_NULL_HANDLE ? visibleCount_ : residentCount_;
+}
+
+uint32_t InstanceBatch::GetTextureIndex() const
+{
+    return textureIndex_;
+}
+
+void InstanceBatch::SetTextureIndex(uint32_t textureIndex)
+{
+    textureIndex_ = textureIndex;
+}
+
+VkBuffer InstanceBatch::GetBuffer() const
+{
+    return buffer_;
+}
+
+const BoundsArray& InstanceBatch::GetBounds() const
+{
+    return bounds_;
+}
+
+uint32_t InstanceBatch::AddInstance(const glm::mat4& transform)
+{
+    auto instance = static_cast<uint32_t>(transforms_.size());
+    transforms_.push_back(transform);
+    dirty_.push_back(1);
+    dirtyInstances_.push_back(instance);
+    bounds_.Resize(instance + 1);
+    UpdateBounds(instance);
+    return instance;
+}
+
+void InstanceBatch::SetTransform(uint32_t instance, const glm::mat4& transform)
+{
+    transforms_[instance] = transform;
+    UpdateBounds(instance);
+    if (!dirty_[instance]) {
+        dirty_[instance] = 1;
+        dirtyInstances_.push_back(instance);
+    }
+}
+
+uint32_t InstanceBatch::RecordUpload(VkCommandBuffer commandBuffer, FrameScheduler& frameScheduler,
+    DeletionQueue& deletionQueue)
+{
+    if (dirtyInstances_.empty()) {
+        return 0;
+    }
+
+    PROFILE_SCOPE("UploadInstances");
+
+    auto instanceCount = static_cast<uint32_t>(transforms_.size());
+    if (instanceCount > capacity_) {
+        Grow(commandBuffer, std::max(instanceCount, capacity_ * 2), deletionQueue, frameScheduler.GetFrameNumber());
+    } else {
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+    }
+
+    std::sort(dirtyInstances_.begin(), dirtyInstances_.end());
+
+    copyRegions_.clear();
+    VkBuffer uploadBuffer = VK_NULL_HANDLE;
+    uint32_t uploadedCount = 0;
+    size_t consumed = 0;
+    while (consumed < dirtyInstances_.size()) {
+        auto first = dirtyInstances_[consumed];
+        uint32_t count = 1;
+        while (consumed + count < dirtyInstances_.size() && dirtyInstances_[consumed + count] == first + count) {
+            count++;
+        }
+
+        VkDeviceSize size = sizeof(glm::mat4) * count;
+        VkDeviceSize offset;
+        void* data;
+        if (!frameScheduler.AllocateUpload(size, uploadBuffer, offset, data)) {
+            break;
+        }
+        memcpy(data, &transforms_[first], static_cast<size_t>(size));
+        copyRegions_.push_back({offset, sizeof(glm::mat4) * first, size});
+        std::fill(dirty_.begin() + first, dirty_.begin() + first + count, 0);
+
+        residentCount_ = std::max(residentCount_, first + count);
+        uploadedCount += count;
+        consumed += count;
+    }
+    dirtyInstances_.erase(dirtyInstances_.begin(), dirtyInstances_.begin() + consumed);
+
+    if (copyRegions_.empty()) {
+        return 0;
+    }
+    vkCmdCopyBuffer(commandBuffer, uploadBuffer, buffer_, static_cast<uint32_t>(copyRegions_.size()),
+        copyRegions_.data());
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer_;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &barrier, 0,
+        nullptr);
+
+    return uploadedCount;
+}
+
+bool InstanceBatch::UploadVisible(FrameScheduler& frameScheduler, const std::vector<uint32_t>& visibleInstances)
+{
+    visibleBuffer_ = VK_NULL_HANDLE;
+    visibleCount_ = 0;
+    if (visibleInstances.empty()) {
+        return true;
+    }
+
+    void* data;
+    if (!frameScheduler.AllocateUpload(sizeof(glm::mat4) * visibleInstances.size(), visibleBuffer_, visibleOffset_,
+        data)) {
+        visibleBuffer_ = VK_NULL_HANDLE;
+        return false;
+    }
+
+    auto visibleTransforms = static_cast<glm::mat4*>(data);
+    for (auto instance : visibleInstances) {
+        visibleTransforms[visibleCount_++] = transforms_[instance];
+    }
+    return true;
+}
+
+void InstanceBatch::Draw(VkCommandBuffer commandBuffer, VertexStream stream, uint32_t firstInstance,
+    uint32_t instanceCount) const
+{
+    auto drawInstanceCount = GetDrawInstanceCount();
+    if (firstInstance >= drawInstanceCount) {
+        return;
+    }
+
+    mesh_->BindBuffers(commandBuffer, stream);
+    if (visibleBuffer_ != VK_NULL_HANDLE) {
+        vkCmdBindVertexBuffers(commandBuffer, 1, 1, &visibleBuffer_, &visibleOffset_);
+    } else {
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(commandBuffer, 1, 1, &buffer_, &offset);
+    }
+    mesh_->Draw(commandBuffer, std::min(instanceCount, drawInstanceCount - firstInstance), firstInstance);
+}
+
+void InstanceBatch::UpdateBounds(uint32_t instance)
+{
+    const auto& bounds = mesh_->GetBounds();
+    const auto& transform = transforms_[instance];
+    auto center = 0.5f * (bounds.max + bounds.min);
+    auto extent = 0.5f * (bounds.max - bounds.min);
+
+    auto worldCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+    auto worldExtent = glm::abs(glm::vec3(transform[0])) * extent.x + glm::abs(glm::vec3(transform[1])) * extent.y +
+        glm::abs(glm::vec3(transform[2])) * extent.z;
+    bounds_.Set(instance, worldCenter, worldExtent);
+}
+
+void InstanceBatch::Grow(VkCommandBuffer commandBuffer, uint32_t capacity, DeletionQueue& deletionQueue,
+    uint64_t frameNumber)
+{
+    VkBuffer buffer;
+    VmaAllocation allocation;
+    VulkanContext::Instance().CreateBuffer(sizeof(glm::mat4) * capacity,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT, {}, buffer, allocation);
+
+    if (buffer_ != VK_NULL_HANDLE) {
+        if (residentCount_ > 0) {
+            VkBufferMemoryBarrier sourceBarrier{};
+            sourceBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            sourceBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            sourceBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            sourceBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            sourceBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            sourceBarrier.buffer = buffer_;
+            sourceBarrier.offset = 0;
+            sourceBarrier.size = VK_WHOLE_SIZE;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                nullptr, 1, &sourceBarrier, 0, nullptr);
+
+            VkBufferCopy region{};
+            region.size = sizeof(glm::mat4) * residentCount_;
+            vkCmdCopyBuffer(commandBuffer, buffer_, buffer, 1, &region);
+
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1,
+                &barrier, 0, nullptr, 0, nullptr);
+        }
+
+        deletionQueue.Push(frameNumber, [oldBuffer = buffer_, oldAllocation = allocation_]() {
+            vmaDestroyBuffer(VulkanContext::Instance().GetAllocator(), oldBuffer, oldAllocation);
+        });
+    }
+
+    buffer_ = buffer;
+    allocation_ = allocation;
+    capacity_ = capacity;
+}
\ No newline at end of file
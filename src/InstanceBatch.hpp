@@ -0,0 +1,63 @@
+#ifndef INSTANCE_BATCH_HPP
+#define INSTANCE_BATCH_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "DeletionQueue.hpp"
+#include "FrameScheduler.hpp"
+#include "FrustumCuller.hpp"
+#include "Mesh.hpp"
+
+class InstanceBatch {
+public:
+    InstanceBatch(std::shared_ptr<Mesh> mesh, uint32_t capacity);
+    ~InstanceBatch();
+
+    InstanceBatch(const InstanceBatch&) = delete;
+    InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+    static VkVertexInputBindingDescription GetBindingDescription();
+    static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
+
+    const std::shared_ptr<Mesh>& GetMesh() const;
+    uint32_t GetInstanceCount() const;
+    uint32_t GetResidentCount() const;
+    uint32_t GetDrawInstanceCount() const;
+    uint32_t GetTextureIndex() const;
+    void SetTextureIndex(uint32_t textureIndex);
+    VkBuffer GetBuffer() const;
+    const BoundsArray& GetBounds() const;
+    uint32_t AddInstance(const glm::mat4& transform);
+    void SetTransform(uint32_t instance, const glm::mat4& transform);
+    uint32_t RecordUpload(VkCommandBuffer commandBuffer, FrameScheduler& frameScheduler, DeletionQueue& deletionQueue);
+    bool UploadVisible(FrameScheduler& frameScheduler, const std::vector<uint32_t>& visibleInstances);
+    void Draw(VkCommandBuffer commandBuffer, VertexStream stream = VertexStream::Full, uint32_t firstInstance = 0,
+        uint32_t instanceCount = UINT32_MAX) const;
+
+private:
+    void UpdateBounds(uint32_t instance);
+    void Grow(VkCommandBuffer commandBuffer, uint32_t capacity, DeletionQueue& deletionQueue, uint64_t frameNumber);
+
+    std::shared_ptr<Mesh> mesh_;
+    std::vector<glm::mat4> transforms_;
+    BoundsArray bounds_;
+    std::vector<uint8_t> dirty_;
+    std::vector<uint32_t> dirtyInstances_;
+    std::vector<VkBufferCopy> copyRegions_;
+    VkBuffer buffer_ = VK_NULL_HANDLE;
+    VmaAllocation allocation_ = VK_NULL_HANDLE;
+    uint32_t capacity_ = 0;
+    uint32_t residentCount_ = 0;
+    uint32_t textureIndex_ = 0;
+    VkBuffer visibleBuffer_ = VK_NULL_HANDLE;
+    VkDeviceSize visibleOffset_ = 0;
+    uint32_t visibleCount_ = 0;
+};
+
+#endif
\ No newline at end of file
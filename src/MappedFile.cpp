@@ -0,0 +1,95 @@
+#include "MappedFile.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Profiler.hpp"
+
+MappedFile::MappedFile(const std::string& path)
+{
+    PROFILE_SCOPE("MapFile");
+
+#ifdef _WIN32
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER size{};
+    if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size)) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr) {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+#else
+    auto file = open(path.c_str(), O_RDONLY);
+    struct stat status{};
+    if (file < 0 || fstat(file, &status) != 0) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    size_ = static_cast<size_t>(status.st_size);
+    if (size_ == 0) {
+        close(file);
+        return;
+    }
+    auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(data);
+#endif
+    if (data_ == nullptr) {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+    }
+    if (file_ != nullptr && file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_);
+    }
+#else
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+}
+
+const uint8_t* MappedFile::GetData() const
+{
+    return data_;
+}
+
+size_t MappedFile::GetSize() const
+{
+    return size_;
+}
\ No newline at end of file
@@ -1,12 +1,54 @@
 #include "Mesh.hpp"
 
-#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <unordered_map>
 
+#include <glm/gtc/packing.hpp>
 #include <tiny_obj_loader.h>
 
-Mesh::Mesh(const std::string& meshPath, const std::string& texturePath)
+#include "Profiler.hpp"
+
+namespace {
+
+struct ObjVertexKey {
+    int32_t position, uv, normal;
+
+    bool operator==(const ObjVertexKey& other) const
+    {
+        return position == other.position && uv == other.uv && normal == other.normal;
+    }
+};
+
+struct ObjVertexKeyHash {
+    size_t operator()(const ObjVertexKey& key) const
+    {
+        size_t hash = 0;
+        for (auto value : {key.position, key.uv, key.normal}) {
+            hash ^= std::hash<int32_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+glm::vec2 EncodeOctahedral(const glm::vec3& direction)
 {
+    auto projected = glm::vec2(direction) / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+    if (direction.z < 0.0f) {
+        auto sign = glm::vec2(projected.x >= 0.0f ? 1.0f : -1.0f, projected.y >= 0.0f ? 1.0f : -1.0f);
+        projected = (1.0f - glm::abs(glm::vec2(projected.y, projected.x))) * sign;
+    }
+    return projected;
+}
+
+}
+
+Mesh::Mesh(const std::string& meshPath, const std::string& texturePath, TangentSpaceGenerator& tangentSpaceGenerator)
+{
+    PROFILE_SCOPE("LoadMesh");
+
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
@@ -16,104 +58,336 @@ Mesh::Mesh(const std::string& meshPath, const std::string& texturePath)
         exit(EXIT_FAILURE);
     }
 
+    std::unordered_map<ObjVertexKey, uint32_t, ObjVertexKeyHash> uniqueVertices;
+    auto providedNormals = true;
     for (const auto& shape : shapes) {
         for (const auto& index : shape.mesh.indices) {
-            Vertex vertex;
-            vertex.position = glm::vec3(attrib.vertices[3 * index.vertex_index],
-                attrib.vertices[3 * index.vertex_index + 1], attrib.vertices[3 * index.vertex_index + 2]);
-            vertex.uv = glm::vec2(attrib.texcoords[2 * index.texcoord_index],
-                1.0f - attrib.texcoords[2 * index.texcoord_index + 1]);
-            vertices_.push_back(vertex);
-            indices_.push_back(indices_.size());
+            ObjVertexKey key{index.vertex_index, index.texcoord_index, index.normal_index};
+            auto [entry, inserted] = uniqueVertices.emplace(key, static_cast<uint32_t>(vertices_.size()));
+            if (inserted) {
+                Vertex vertex{};
+                vertex.position = glm::vec3(attrib.vertices[3 * index.vertex_index],
+                    attrib.vertices[3 * index.vertex_index + 1], attrib.vertices[3 * index.vertex_index + 2]);
+                if (index.texcoord_index >= 0) {
+                    vertex.uv = glm::vec2(attrib.texcoords[2 * index.texcoord_index],
+                        1.0f - attrib.texcoords[2 * index.texcoord_index + 1]);
+                }
+                if (index.normal_index >= 0) {
+                    vertex.normal = glm::vec3(attrib.normals[3 * index.normal_index],
+                        attrib.normals[3 * index.normal_index + 1], attrib.normals[3 * index.normal_index + 2]);
+                } else {
+                    providedNormals = false;
+                }
+                vertices_.push_back(vertex);
+            }
+            indices_.push_back(entry->second);
         }
     }
 
-    texture_ = std::make_shared<Image>(texturePath);
+    bounds_ = {glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest())};
+    for (const auto& vertex : vertices_) {
+        bounds_.min = glm::min(bounds_.min, vertex.position);
+        bounds_.max = glm::max(bounds_.max, vertex.position);
+    }
+
+    vertexCount_ = static_cast<uint32_t>(vertices_.size());
+    indexCount_ = static_cast<uint32_t>(indices_.size());
+    texture_ = std::make_shared<Texture>(std::make_shared<Image>(texturePath));
+
+    GenerateTangentSpace(tangentSpaceGenerator, providedNormals, meshPath + ".tspace",
+        TangentSpaceGenerator::GetCacheKey(meshPath, 0));
+    for (uint32_t i = 0; i < vertexCount_; i++) {
+        vertices_[i].normal = normals_[i];
+        vertices_[i].tangent = tangents_[i];
+    }
+    normals_ = std::vector<glm::vec3>();
+    tangents_ = std::vector<glm::vec4>();
+}
+
+Mesh::Mesh(MeshSource source, std::shared_ptr<Texture> texture, TangentSpaceGenerator& tangentSpaceGenerator) :
+    source_(std::move(source)),
+    texture_(std::move(texture)),
+    bounds_(source_.bounds),
+    vertexCount_(source_.vertexCount),
+    indexCount_(source_.indexCount)
+{
+    if (source_.normals.data == nullptr || source_.tangents.data == nullptr) {
+        GenerateTangentSpace(tangentSpaceGenerator, source_.normals.data != nullptr, source_.tangentCachePath,
+            source_.tangentCacheKey);
+    }
 }
 
 Mesh::~Mesh()
 {
     const auto& context = VulkanContext::Instance();
-    auto device = context.GetDevice();
     auto allocator = context.GetAllocator();
 
-    vkDestroySampler(device, textureSampler_, nullptr);
-    vkDestroyImageView(device, textureImageView_, nullptr);
-    vmaDestroyImage(allocator, textureImage_, textureAllocation_);
-
     vmaDestroyBuffer(allocator, indexBuffer_, indexAllocation_);
+    vmaDestroyBuffer(allocator, positionBuffer_, positionAllocation_);
     vmaDestroyBuffer(allocator, vertexBuffer_, vertexAllocation_);
 }
 
+void Mesh::SetVertexPool(VkBuffer vertexPool, VmaAllocation vertexPoolAllocation, uint32_t baseVertex)
+{
+    vertexPool_ = vertexPool;
+    vertexPoolAllocation_ = vertexPoolAllocation;
+    baseVertex_ = baseVertex;
+}
+
 void Mesh::Bind()
 {
+    PROFILE_SCOPE("BindMesh");
+
     CreateVertexBuffer();
     CreateIndexBuffer();
-    CreateTextureImage();
-    CreateTextureImageView();
-    CreateTextureSampler();
+    texture_->Bind();
+    source_ = MeshSource();
+    normals_ = std::vector<glm::vec3>();
+    tangents_ = std::vector<glm::vec4>();
+}
+
+const std::shared_ptr<Texture>& Mesh::GetTexture() const
+{
+    return texture_;
 }
 
 VkDescriptorImageInfo Mesh::GetTextureInfo() const
 {
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = textureImageView_;
-    imageInfo.sampler = textureSampler_;
-    return imageInfo;
+    return texture_->GetImageInfo();
+}
+
+const BoundingBox& Mesh::GetBounds() const
+{
+    return bounds_;
+}
+
+uint32_t Mesh::GetVertexCount() const
+{
+    return vertexCount_;
+}
+
+uint32_t Mesh::GetIndexCount() const
+{
+    return indexCount_;
+}
+
+PulledVertexConstants Mesh::GetPulledVertexConstants() const
+{
+    PulledVertexConstants constants{};
+    constants.positionOffset = bounds_.min;
+    constants.baseVertex = baseVertex_;
+    constants.positionScale = (bounds_.max - bounds_.min) / 65535.0f;
+    return constants;
 }
 
 void Mesh::Render(VkCommandBuffer commandBuffer) const
+{
+    BindBuffers(commandBuffer);
+    Draw(commandBuffer, 1);
+}
+
+void Mesh::BindBuffers(VkCommandBuffer commandBuffer, VertexStream stream) const
 {
     VkDeviceSize offsets = 0;
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer_, &offsets);
-    vkCmdBindIndexBuffer(commandBuffer, indexBuffer_, 0, VK_INDEX_TYPE_UINT32);
+    if (stream != VertexStream::Pulled) {
+        auto vertexBuffer = stream == VertexStream::Position ? positionBuffer_ : vertexBuffer_;
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offsets);
+    }
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer_, 0, indexType_);
+}
+
+void Mesh::Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const
+{
+    vkCmdDrawIndexed(commandBuffer, GetIndexCount(), instanceCount, 0, 0, firstInstance);
+}
+
+void Mesh::GenerateTangentSpace(TangentSpaceGenerator& tangentSpaceGenerator, bool providedNormals,
+    const std::string& cachePath, uint64_t cacheKey)
+{
+    std::vector<glm::vec3> positions(vertexCount_), normals(providedNormals ? vertexCount_ : 0);
+    std::vector<glm::vec2> uvs(vertexCount_);
+    for (uint32_t i = 0; i < vertexCount_; i++) {
+        auto vertex = ReadVertex(i);
+        positions[i] = vertex.position;
+        uvs[i] = vertex.uv;
+        if (providedNormals) {
+            normals[i] = vertex.normal;
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    if (source_.positions.data != nullptr) {
+        indices.resize(indexCount_);
+        for (uint32_t i = 0; i < indexCount_; i++) {
+            indices[i] = ReadIndex(i);
+        }
+    }
 
-    vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices_.size()), 1, 0, 0, 0);
+    TangentSpaceInput input;
+    input.positions = positions.data();
+    input.uvs = uvs.data();
+    input.normals = providedNormals ? normals.data() : nullptr;
+    input.indices = indices.empty() ? indices_.data() : indices.data();
+    input.vertexCount = vertexCount_;
+    input.indexCount = indexCount_;
+    tangentSpaceGenerator.GenerateCached(input, cachePath, cacheKey, normals_, tangents_);
 }
 
 void Mesh::CreateVertexBuffer()
 {
-    VulkanContext::Instance().CreateAndCopyBuffer(vertices_, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer_,
-        vertexAllocation_);
+    auto& context = VulkanContext::Instance();
+    if (vertexPool_ != VK_NULL_HANDLE) {
+        context.UploadBuffer(vertexPool_, vertexPoolAllocation_, sizeof(PackedVertex) * baseVertex_,
+            sizeof(PackedVertex) * vertexCount_,
+            [this](void* stagingData) { WritePackedVertices(static_cast<PackedVertex*>(stagingData)); });
+    } else if (source_.positions.data == nullptr) {
+        context.CreateAndCopyBuffer(vertices_, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer_, vertexAllocation_);
+    } else {
+        context.CreateAndUploadBuffer(sizeof(Vertex) * vertexCount_, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            [this](void* stagingData) { WriteVertices(static_cast<Vertex*>(stagingData)); }, vertexBuffer_,
+            vertexAllocation_);
+    }
+    context.CreateAndUploadBuffer(sizeof(glm::vec3) * vertexCount_, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        [this](void* stagingData) { WritePositions(static_cast<glm::vec3*>(stagingData)); }, positionBuffer_,
+        positionAllocation_);
 }
 
 void Mesh::CreateIndexBuffer()
 {
-    VulkanContext::Instance().CreateAndCopyBuffer(indices_, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer_,
-        indexAllocation_);
+    auto& context = VulkanContext::Instance();
+    if (source_.positions.data == nullptr) {
+        context.CreateAndCopyBuffer(indices_, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer_, indexAllocation_);
+        return;
+    }
+
+    const auto& indices = source_.indices;
+    auto wideIndices = indices.data == nullptr || indices.componentType == ComponentType::UnsignedInt;
+    indexType_ = wideIndices ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+    auto indexSize = wideIndices ? sizeof(uint32_t) : sizeof(uint16_t);
+    context.CreateAndUploadBuffer(indexSize * indexCount_, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        [this](void* stagingData) { WriteIndices(stagingData); }, indexBuffer_, indexAllocation_);
+}
+
+void Mesh::WriteVertices(Vertex* vertices) const
+{
+    for (uint32_t i = 0; i < vertexCount_; i++) {
+        vertices[i] = ReadVertex(i);
+    }
+}
+
+void Mesh::WritePackedVertices(PackedVertex* vertices) const
+{
+    auto extent = bounds_.max - bounds_.min;
+    auto scale = glm::vec3(extent.x > 0.0f ? 65535.0f / extent.x : 0.0f, extent.y > 0.0f ? 65535.0f / extent.y : 0.0f,
+        extent.z > 0.0f ? 65535.0f / extent.z : 0.0f);
+    for (uint32_t i = 0; i < vertexCount_; i++) {
+        auto vertex = ReadVertex(i);
+        auto quantized = glm::clamp((vertex.position - bounds_.min) * scale + 0.5f, 0.0f, 65535.0f);
+        for (int32_t j = 0; j < 3; j++) {
+            vertices[i].position[j] = static_cast<uint16_t>(quantized[j]);
+        }
+        vertices[i].tangentSign = vertex.tangent.w < 0.0f ? 0 : 1;
+        vertices[i].uv = glm::packHalf2x16(vertex.uv);
+        vertices[i].normal = glm::packSnorm2x16(EncodeOctahedral(vertex.normal));
+        vertices[i].tangent = glm::packSnorm2x16(EncodeOctahedral(glm::vec3(vertex.tangent)));
+    }
+}
+
+void Mesh::WritePositions(glm::vec3* positions) const
+{
+    const auto& source = source_.positions;
+    if (source.data == nullptr) {
+        for (uint32_t i = 0; i < vertexCount_; i++) {
+            positions[i] = vertices_[i].position;
+        }
+    } else if (source.stride == sizeof(glm::vec3)) {
+        memcpy(positions, source.data, sizeof(glm::vec3) * vertexCount_);
+    } else {
+        for (uint32_t i = 0; i < vertexCount_; i++) {
+            memcpy(&positions[i], source.data + source.stride * i, sizeof(glm::vec3));
+        }
+    }
 }
 
-void Mesh::CreateTextureImage()
+void Mesh::WriteIndices(void* indices) const
 {
-    VulkanContext::Instance().CreateAndCopyImage(texture_->GetWidth(), texture_->GetHeight(), texture_->GetChannels(),
-        texture_->GetPixels(), VK_IMAGE_USAGE_SAMPLED_BIT, textureImage_, textureAllocation_);
+    const auto& source = source_.indices;
+    if (source.data == nullptr) {
+        auto sequential = static_cast<uint32_t*>(indices);
+        for (uint32_t i = 0; i < indexCount_; i++) {
+            sequential[i] = i;
+        }
+    } else if (source.componentType == ComponentType::UnsignedByte) {
+        auto widened = static_cast<uint16_t*>(indices);
+        for (uint32_t i = 0; i < indexCount_; i++) {
+            widened[i] = source.data[source.stride * i];
+        }
+    } else {
+        memcpy(indices, source.data, source.stride * indexCount_);
+    }
 }
 
-void Mesh::CreateTextureImageView()
+Vertex Mesh::ReadVertex(uint32_t vertex) const
 {
-    textureImageView_ = VulkanContext::Instance().CreateImageView(textureImage_, VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_ASPECT_COLOR_BIT);
+    if (source_.positions.data == nullptr) {
+        return vertices_[vertex];
+    }
+
+    Vertex result;
+    const auto& positions = source_.positions;
+    memcpy(&result.position, positions.data + positions.stride * vertex, sizeof(glm::vec3));
+    result.uv = source_.uvs.data != nullptr ? ReadUv(vertex) : glm::vec2(0.0f);
+    if (!normals_.empty()) {
+        result.normal = normals_[vertex];
+        result.tangent = tangents_[vertex];
+        return result;
+    }
+
+    const auto& normals = source_.normals;
+    const auto& tangents = source_.tangents;
+    result.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+    result.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+    if (normals.data != nullptr) {
+        memcpy(&result.normal, normals.data + normals.stride * vertex, sizeof(glm::vec3));
+    }
+    if (tangents.data != nullptr) {
+        memcpy(&result.tangent, tangents.data + tangents.stride * vertex, sizeof(glm::vec4));
+    }
+    return result;
 }
 
-void Mesh::CreateTextureSampler()
+glm::vec2 Mesh::ReadUv(uint32_t vertex) const
 {
-    VkSamplerCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    createInfo.magFilter = VK_FILTER_LINEAR;
-    createInfo.minFilter = VK_FILTER_LINEAR;
-    createInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    createInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    createInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    createInfo.anisotropyEnable = VK_TRUE;
-    createInfo.maxAnisotropy = 16;
-    createInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    createInfo.unnormalizedCoordinates = VK_FALSE;
-    createInfo.compareEnable = VK_FALSE;
-    createInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-    createInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    createInfo.mipLodBias = 0.0f;
-    createInfo.minLod = 0.0f;
-    createInfo.maxLod = 0.0f;
-    VULKAN_CHECK(vkCreateSampler(VulkanContext::Instance().GetDevice(), &createInfo, nullptr, &textureSampler_));
+    const auto& uvs = source_.uvs;
+    auto element = uvs.data + uvs.stride * vertex;
+    if (uvs.componentType == ComponentType::UnsignedByte) {
+        return glm::vec2(element[0], element[1]) / 255.0f;
+    } else if (uvs.componentType == ComponentType::UnsignedShort) {
+        uint16_t uv[2];
+        memcpy(uv, element, sizeof(uv));
+        return glm::vec2(uv[0], uv[1]) / 65535.0f;
+    }
+    glm::vec2 uv;
+    memcpy(&uv, element, sizeof(uv));
+    return uv;
+}
+
+uint32_t Mesh::ReadIndex(uint32_t index) const
+{
+    const auto& indices = source_.indices;
+    if (indices.data == nullptr) {
+        return index;
+    }
+
+    auto element = indices.data + indices.stride * index;
+    if (indices.componentType == ComponentType::UnsignedByte) {
+        return element[0];
+    } else if (indices.componentType == ComponentType::UnsignedShort) {
+        uint16_t value;
+        memcpy(&value, element, sizeof(value));
+        return value;
+    }
+    uint32_t value;
+    memcpy(&value, element, sizeof(value));
+    return value;
 }
\ No newline at end of file
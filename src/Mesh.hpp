@@ -1,40 +1,105 @@
 #ifndef MESH_HPP
 #define MESH_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "Image.hpp"
+#include "MappedFile.hpp"
+#include "TangentSpace.hpp"
+#include "Texture.hpp"
 #include "Vertex.hpp"
 #include "VulkanContext.hpp"
 
+struct BoundingBox {
+    glm::vec3 min, max;
+};
+
+enum class VertexStream {
+    Full,
+    Position,
+    Pulled
+};
+
+enum class ComponentType {
+    Float,
+    UnsignedByte,
+    UnsignedShort,
+    UnsignedInt
+};
+
+struct MeshAccessor {
+    const uint8_t* data = nullptr;
+    size_t stride = 0;
+    ComponentType componentType = ComponentType::Float;
+};
+
+struct MeshSource {
+    std::shared_ptr<const MappedFile> file;
+    uint32_t vertexCount = 0, indexCount = 0;
+    MeshAccessor positions, uvs, normals, tangents, indices;
+    BoundingBox bounds;
+    std::string tangentCachePath;
+    uint64_t tangentCacheKey = 0;
+};
+
+struct PulledVertexConstants {
+    glm::vec3 positionOffset;
+    uint32_t baseVertex;
+    glm::vec3 positionScale;
+    uint32_t padding;
+};
+
 class Mesh {
 public:
-    Mesh(const std::string& meshPath, const std::string& texturePath);
+    Mesh(const std::string& meshPath, const std::string& texturePath, TangentSpaceGenerator& tangentSpaceGenerator);
+    Mesh(MeshSource source, std::shared_ptr<Texture> texture, TangentSpaceGenerator& tangentSpaceGenerator);
     ~Mesh();
 
+    void SetVertexPool(VkBuffer vertexPool, VmaAllocation vertexPoolAllocation, uint32_t baseVertex);
     void Bind();
+    const std::shared_ptr<Texture>& GetTexture() const;
     VkDescriptorImageInfo GetTextureInfo() const;
+    const BoundingBox& GetBounds() const;
+    uint32_t GetVertexCount() const;
+    uint32_t GetIndexCount() const;
+    PulledVertexConstants GetPulledVertexConstants() const;
     void Render(VkCommandBuffer commandBuffer) const;
+    void BindBuffers(VkCommandBuffer commandBuffer, VertexStream stream = VertexStream::Full) const;
+    void Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance = 0) const;
 
 private:
+    void GenerateTangentSpace(TangentSpaceGenerator& tangentSpaceGenerator, bool providedNormals,
+        const std::string& cachePath, uint64_t cacheKey);
     void CreateVertexBuffer();
     void CreateIndexBuffer();
-    void CreateTextureImage();
-    void CreateTextureImageView();
-    void CreateTextureSampler();
+    void WriteVertices(Vertex* vertices) const;
+    void WritePackedVertices(PackedVertex* vertices) const;
+    void WritePositions(glm::vec3* positions) const;
+    void WriteIndices(void* indices) const;
+    Vertex ReadVertex(uint32_t vertex) const;
+    glm::vec2 ReadUv(uint32_t vertex) const;
+    uint32_t ReadIndex(uint32_t index) const;
 
     std::vector<Vertex> vertices_;
     std::vector<uint32_t> indices_;
-    std::shared_ptr<Image> texture_;
+    std::vector<glm::vec3> normals_;
+    std::vector<glm::vec4> tangents_;
+    MeshSource source_;
+    std::shared_ptr<Texture> texture_;
+    BoundingBox bounds_;
+    uint32_t vertexCount_, indexCount_;
+    VkIndexType indexType_ = VK_INDEX_TYPE_UINT32;
+    VkBuffer vertexPool_ = VK_NULL_HANDLE;
+    VmaAllocation vertexPoolAllocation_ = VK_NULL_HANDLE;
+    uint32_t baseVertex_ = 0;
 
-    VkBuffer vertexBuffer_, indexBuffer_;
-    VmaAllocation vertexAllocation_, indexAllocation_, textureAllocation_;
-    VkImage textureImage_;
-    VkImageView textureImageView_;
-    VkSampler textureSampler_;
+    VkBuffer vertexBuffer_ = VK_NULL_HANDLE, positionBuffer_ = VK_NULL_HANDLE, indexBuffer_ = VK_NULL_HANDLE;
+    VmaAllocation vertexAllocation_ = VK_NULL_HANDLE, positionAllocation_ = VK_NULL_HANDLE,
+        indexAllocation_ = VK_NULL_HANDLE;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "ParallelCommandRecorder.hpp"
+
+#include <algorithm>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+ParallelCommandRecorder::ParallelCommandRecorder(ThreadPool& threadPool, uint32_t frameCount,
+    uint32_t minItemsPerTask) :
+    threadPool_(threadPool),
+    minItemsPerTask_(std::max(minItemsPerTask, 1u))
+{
+    auto& context = VulkanContext::Instance();
+    auto threadCount = std::max(threadPool_.GetThreadCount(), 1u);
+
+    VkCommandPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    createInfo.queueFamilyIndex = context.GetQueueFamilyIndices().graphicsFamilyIndex;
+
+    pools_.resize(frameCount);
+    for (auto& framePools : pools_) {
+        framePools.resize(threadCount);
+        for (auto& threadCommandPool : framePools) {
+            VULKAN_CHECK(vkCreateCommandPool(context.GetDevice(), &createInfo, nullptr, &threadCommandPool.pool));
+        }
+    }
+}
+
+ParallelCommandRecorder::~ParallelCommandRecorder()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    for (auto& framePools : pools_) {
+        for (auto& threadCommandPool : framePools) {
+            vkDestroyCommandPool(device, threadCommandPool.pool, nullptr);
+        }
+    }
+}
+
+void ParallelCommandRecorder::ResetFrame(uint32_t frame)
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    for (auto& threadCommandPool : pools_[frame]) {
+        VULKAN_CHECK(vkResetCommandPool(device, threadCommandPool.pool, 0));
+        threadCommandPool.usedCount = 0;
+    }
+}
+
+const std::vector<VkCommandBuffer>& ParallelCommandRecorder::Record(uint32_t frame, uint32_t itemCount,
+    const VkCommandBufferInheritanceInfo& inheritanceInfo, const RecordFunction& record)
+{
+    auto threadCount = static_cast<uint32_t>(pools_[frame].size());
+    auto taskCount = std::clamp((itemCount + minItemsPerTask_ - 1) / minItemsPerTask_, 1u, threadCount * 2);
+    auto itemsPerTask = (itemCount + taskCount - 1) / taskCount;
+
+    recorded_.assign(taskCount, VK_NULL_HANDLE);
+    threadPool_.ParallelFor(taskCount, [&](uint32_t taskIndex, uint32_t threadIndex) {
+        PROFILE_SCOPE("RecordSecondaryCommandBuffer");
+
+        auto commandBuffer = AllocateCommandBuffer(pools_[frame][threadIndex]);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+            VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        VULKAN_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+        auto begin = std::min(taskIndex * itemsPerTask, itemCount);
+        auto end = std::min(begin + itemsPerTask, itemCount);
+        record(commandBuffer, begin, end);
+
+        VULKAN_CHECK(vkEndCommandBuffer(commandBuffer));
+        recorded_[taskIndex] = commandBuffer;
+    });
+
+    return recorded_;
+}
+
+VkCommandBuffer ParallelCommandRecorder::AllocateCommandBuffer(ThreadCommandPool& threadCommandPool)
+{
+    if (threadCommandPool.usedCount == threadCommandPool.commandBuffers.size()) {
+        VkCommandBufferAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = threadCommandPool.pool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        VULKAN_CHECK(vkAllocateCommandBuffers(VulkanContext::Instance().GetDevice(), &allocateInfo, &commandBuffer));
+        threadCommandPool.commandBuffers.push_back(commandBuffer);
+    }
+    return threadCommandPool.commandBuffers[threadCommandPool.usedCount++];
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef PARALLEL_COMMAND_RECORDER_HPP
+#define PARALLEL_COMMAND_RECORDER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "ThreadPool.hpp"
+
+class ParallelCommandRecorder {
+public:
+    using RecordFunction = std::function<void(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end)>;
+
+    ParallelCommandRecorder(ThreadPool& threadPool, uint32_t frameCount, uint32_t minItemsPerTask);
+    ~ParallelCommandRecorder();
+
+    void ResetFrame(uint32_t frame);
+    const std::vector<VkCommandBuffer>& Record(uint32_t frame, uint32_t itemCount,
+        const VkCommandBufferInheritanceInfo& inheritanceInfo, const RecordFunction& record);
+
+private:
+    struct ThreadCommandPool {
+        VkCommandPool pool;
+        std::vector<VkCommandBuffer> commandBuffers;
+        uint32_t usedCount = 0;
+    };
+
+    VkCommandBuffer AllocateCommandBuffer(ThreadCommandPool& threadCommandPool);
+
+    ThreadPool& threadPool_;
+    uint32_t minItemsPerTask_;
+    std::vector<std::vector<ThreadCommandPool>> pools_;
+    std::vector<VkCommandBuffer> recorded_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+void WriteJsonString(std::ostream& out, const std::string& value)
+{
+    out << '"';
+    for (auto c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}
+
+thread_local Profiler::ThreadBuffer* Profiler::threadBuffer_ = nullptr;
+
+Profiler& Profiler::Instance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+uint64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    auto& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer.threadName = name;
+}
+
+void Profiler::Record(const char* name, uint64_t begin, uint64_t end)
+{
+    auto& buffer = GetThreadBuffer();
+    auto head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % RING_CAPACITY] = {name, begin, end};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::ExportChromeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open trace file: " << path << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto origin = std::numeric_limits<uint64_t>::max();
+    for (const auto& buffer : buffers_) {
+        auto head = buffer->head.load(std::memory_order_acquire);
+        auto count = std::min<uint64_t>(head, RING_CAPACITY);
+        for (auto i = head - count; i < head; i++) {
+            origin = std::min(origin, buffer->events[i % RING_CAPACITY].begin);
+        }
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : buffers_) {
+        if (!first) {
+            file << ",";
+        }
+        first = false;
+        file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":";
+        WriteJsonString(file, buffer->threadName);
+        file << "}}";
+
+        auto head = buffer->head.load(std::memory_order_acquire);
+        auto count = std::min<uint64_t>(head, RING_CAPACITY);
+        for (auto i = head - count; i < head; i++) {
+            const auto& event = buffer->events[i % RING_CAPACITY];
+            file << ",\n{\"name\":";
+            WriteJsonString(file, event.name);
+            file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << static_cast<double>(event.begin - origin) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.end - event.begin) / 1000.0 << "}";
+        }
+    }
+    file << "\n]}\n";
+}
+
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+{
+    if (threadBuffer_ == nullptr) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->events.resize(RING_CAPACITY);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->threadId = static_cast<uint32_t>(buffers_.size());
+        buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+        threadBuffer_ = buffer.get();
+        buffers_.push_back(std::move(buffer));
+    }
+    return *threadBuffer_;
+}
\ No newline at end of file
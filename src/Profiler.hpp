@@ -0,0 +1,82 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t begin, end;
+};
+
+class Profiler {
+public:
+    static Profiler& Instance();
+    static uint64_t Now();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    void SetThreadName(const std::string& name);
+    void Record(const char* name, uint64_t begin, uint64_t end);
+    void ExportChromeTrace(const std::string& path);
+
+private:
+    static constexpr uint32_t RING_CAPACITY = 1 << 16;
+
+    struct ThreadBuffer {
+        uint32_t threadId;
+        std::string threadName;
+        std::vector<ProfileEvent> events;
+        std::atomic<uint64_t> head = 0;
+    };
+
+    Profiler() = default;
+    ~Profiler() = default;
+
+    Profiler(const Profiler&) = delete;
+    Profiler(const Profiler&&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&&) = delete;
+
+    ThreadBuffer& GetThreadBuffer();
+
+    static thread_local ThreadBuffer* threadBuffer_;
+
+    std::atomic<bool> enabled_ = false;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) :
+        name_(Profiler::Instance().IsEnabled() ? name : nullptr),
+        begin_(name_ != nullptr ? Profiler::Now() : 0) {}
+
+    ~ProfileScope()
+    {
+        if (name_ != nullptr) {
+            Profiler::Instance().Record(name_, begin_, Profiler::Now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t begin_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,794 @@
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+RenderGraph::~RenderGraph()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+    for (const auto& [key, framebuffer] : framebuffers_) {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+    for (const auto& resource : resources_) {
+        if (resource.transient && resource.image != VK_NULL_HANDLE) {
+            vkDestroyImageView(device, resource.imageView, nullptr);
+            vkDestroyImage(device, resource.image, nullptr);
+        }
+    }
+    for (auto allocation : allocations_) {
+        vmaFreeMemory(context.GetAllocator(), allocation);
+    }
+    for (const auto& [key, renderPass] : renderPasses_) {
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    }
+    DestroyQueryPool();
+}
+
+uint32_t RenderGraph::ImportImage(const std::string& name, VkFormat format)
+{
+    return AddResource(name, true, false, format);
+}
+
+uint32_t RenderGraph::CreateImage(const std::string& name, VkFormat format)
+{
+    return AddResource(name, true, true, format);
+}
+
+uint32_t RenderGraph::ImportBuffer(const std::string& name)
+{
+    return AddResource(name, false, false, VK_FORMAT_UNDEFINED);
+}
+
+void RenderGraph::BindImage(uint32_t resource, VkImage image, VkImageView imageView, VkImageLayout layout)
+{
+    auto& imported = resources_[resource];
+    imported.image = image;
+    imported.imageView = imageView;
+    imported.state = ResourceState{};
+    imported.state.layout = layout;
+}
+
+void RenderGraph::BindBuffer(uint32_t resource, VkBuffer buffer)
+{
+    resources_[resource].buffer = buffer;
+    resources_[resource].state = ResourceState{};
+}
+
+void RenderGraph::SetOutput(uint32_t resource, VkImageLayout finalLayout)
+{
+    resources_[resource].output = true;
+    resources_[resource].finalLayout = finalLayout;
+}
+
+uint32_t RenderGraph::AddPass(const std::string& name, ExecuteCallback callback)
+{
+    Pass pass;
+    pass.name = name;
+    pass.callback = std::move(callback);
+    passes_.push_back(std::move(pass));
+    return static_cast<uint32_t>(passes_.size() - 1);
+}
+
+void RenderGraph::WriteColor(uint32_t pass, uint32_t resource, const VkClearColorValue* clearValue)
+{
+    Attachment attachment;
+    attachment.resource = resource;
+    if (clearValue) {
+        attachment.clear = true;
+        attachment.clearValue.color = *clearValue;
+    }
+    passes_[pass].colorAttachments.push_back(attachment);
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, true, attachment.clear);
+}
+
+void RenderGraph::WriteDepth(uint32_t pass, uint32_t resource, const VkClearDepthStencilValue* clearValue)
+{
+    auto& attachment = passes_[pass].depthAttachment;
+    attachment.resource = resource;
+    if (clearValue) {
+        attachment.clear = true;
+        attachment.clearValue.depthStencil = *clearValue;
+    }
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, true,
+        attachment.clear);
+}
+
+void RenderGraph::ReadTexture(uint32_t pass, uint32_t resource, VkPipelineStageFlags stageMask)
+{
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, stageMask, VK_ACCESS_SHADER_READ_BIT, false);
+}
+
+void RenderGraph::ReadStorage(uint32_t pass, uint32_t resource, VkPipelineStageFlags stageMask)
+{
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_GENERAL, stageMask, VK_ACCESS_SHADER_READ_BIT, false);
+}
+
+void RenderGraph::WriteStorage(uint32_t pass, uint32_t resource, VkPipelineStageFlags stageMask)
+{
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_GENERAL, stageMask, VK_ACCESS_SHADER_READ_BIT |
+        VK_ACCESS_SHADER_WRITE_BIT, true);
+}
+
+void RenderGraph::ReadIndirect(uint32_t pass, uint32_t resource)
+{
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT, false);
+}
+
+void RenderGraph::ReadTransfer(uint32_t pass, uint32_t resource)
+{
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT, false);
+}
+
+void RenderGraph::WriteTransfer(uint32_t pass, uint32_t resource)
+{
+    AddAccess(pass, resource, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT, true);
+}
+
+void RenderGraph::SetSideEffects(uint32_t pass)
+{
+    passes_[pass].sideEffects = true;
+}
+
+void RenderGraph::SetSecondaryCommandBuffers(uint32_t pass)
+{
+    passes_[pass].secondaryCommandBuffers = true;
+}
+
+void RenderGraph::SetRenderArea(uint32_t pass, VkExtent2D renderArea)
+{
+    passes_[pass].renderArea = renderArea;
+}
+
+void RenderGraph::Compile(VkExtent2D extent, DeletionQueue& deletionQueue, uint64_t frameNumber)
+{
+    PROFILE_SCOPE("CompileRenderGraph");
+
+    Release(deletionQueue, frameNumber);
+    extent_ = extent;
+    for (auto& pass : passes_) {
+        pass.renderArea = extent_;
+    }
+
+    CullPasses();
+    CreateTransientImages();
+    CreateRenderPasses();
+    stats_.passCount = static_cast<uint32_t>(passes_.size());
+}
+
+void RenderGraph::EnableTimestamps(uint32_t slotCount)
+{
+    DestroyQueryPool();
+
+    auto& context = VulkanContext::Instance();
+    auto properties = context.GetPhysicalDeviceProperties();
+    if (properties.limits.timestampComputeAndGraphics != VK_TRUE) {
+        return;
+    }
+    timestampPeriod_ = static_cast<double>(properties.limits.timestampPeriod);
+    timestampFrames_.assign(slotCount, 0);
+    timestampsPending_.assign(slotCount, false);
+
+    VkQueryPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    createInfo.queryCount = slotCount * static_cast<uint32_t>(passes_.size() + 1);
+    VULKAN_CHECK(vkCreateQueryPool(context.GetDevice(), &createInfo, nullptr, &queryPool_));
+}
+
+void RenderGraph::Execute(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t frameIndex)
+{
+    PROFILE_SCOPE("ExecuteRenderGraph");
+
+    for (auto& resource : resources_) {
+        resource.touched = !resource.transient;
+    }
+
+    auto queryCount = static_cast<uint32_t>(passes_.size() + 1);
+    if (queryPool_ != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, queryPool_, slot * queryCount, queryCount);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, slot * queryCount);
+        timestampFrames_[slot] = frameIndex;
+        timestampsPending_[slot] = true;
+    }
+
+    for (uint32_t i = 0; i < passes_.size(); i++) {
+        auto& pass = passes_[i];
+        if (queryPool_ != VK_NULL_HANDLE && i > 0) {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_,
+                slot * queryCount + i);
+        }
+        if (pass.culled) {
+            continue;
+        }
+
+        BarrierBatch batch;
+        for (const auto& access : pass.accesses) {
+            AddBarrier(resources_[access.resource], access, batch);
+        }
+        FlushBarriers(commandBuffer, batch);
+
+        RenderPassContext context{commandBuffer, pass.renderPass, VK_NULL_HANDLE, pass.renderArea};
+        if (pass.renderPass == VK_NULL_HANDLE) {
+            pass.callback(context);
+            continue;
+        }
+
+        context.framebuffer = GetFramebuffer(pass);
+        std::vector<VkClearValue> clearValues;
+        for (const auto& attachment : pass.colorAttachments) {
+            clearValues.push_back(attachment.clearValue);
+        }
+        if (pass.depthAttachment.resource != UINT32_MAX) {
+            clearValues.push_back(pass.depthAttachment.clearValue);
+        }
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = pass.renderPass;
+        renderPassInfo.framebuffer = context.framebuffer;
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = pass.renderArea;
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, pass.secondaryCommandBuffers ?
+            VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+        pass.callback(context);
+        vkCmdEndRenderPass(commandBuffer);
+    }
+
+    BarrierBatch batch;
+    for (auto& resource : resources_) {
+        auto& state = resource.state;
+        if (!resource.output || !resource.isImage || state.layout == resource.finalLayout) {
+            continue;
+        }
+
+        auto srcStageMask = state.writeStageMask | state.readStageMask;
+        auto dstStageMask = VulkanContext::GetLayoutStageMask(resource.finalLayout);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = state.writeAccessMask;
+        barrier.dstAccessMask = VulkanContext::GetLayoutAccessMask(resource.finalLayout);
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = resource.finalLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = resource.image;
+        barrier.subresourceRange = {VulkanContext::GetFormatAspectMask(resource.format), 0,
+            VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+        batch.imageBarriers.push_back(barrier);
+        batch.srcStageMask |= srcStageMask != 0 ? srcStageMask : dstStageMask;
+        batch.dstStageMask |= dstStageMask;
+
+        state = ResourceState{};
+        state.layout = resource.finalLayout;
+        state.writeStageMask = dstStageMask;
+    }
+    FlushBarriers(commandBuffer, batch);
+    if (queryPool_ != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_,
+            slot * queryCount + queryCount - 1);
+    }
+    stats_.frameCount++;
+}
+
+bool RenderGraph::ResolveTimestamps(uint32_t slot, uint32_t& frameIndex, std::vector<double>& passMilliseconds)
+{
+    if (queryPool_ == VK_NULL_HANDLE || !timestampsPending_[slot]) {
+        return false;
+    }
+
+    auto queryCount = static_cast<uint32_t>(passes_.size() + 1);
+    std::vector<uint64_t> timestamps(queryCount);
+    auto result = vkGetQueryPoolResults(VulkanContext::Instance().GetDevice(), queryPool_, slot * queryCount,
+        queryCount, sizeof(uint64_t) * timestamps.size(), timestamps.data(), sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return false;
+    }
+
+    timestampsPending_[slot] = false;
+    frameIndex = timestampFrames_[slot];
+    passMilliseconds.resize(passes_.size());
+    for (uint32_t i = 0; i < passes_.size(); i++) {
+        passMilliseconds[i] = static_cast<double>(timestamps[i + 1] - timestamps[i]) * timestampPeriod_ / 1e6;
+    }
+    return true;
+}
+
+uint32_t RenderGraph::GetPassCount() const
+{
+    return static_cast<uint32_t>(passes_.size());
+}
+
+const std::string& RenderGraph::GetPassName(uint32_t pass) const
+{
+    return passes_[pass].name;
+}
+
+bool RenderGraph::IsPassCulled(uint32_t pass) const
+{
+    return passes_[pass].culled;
+}
+
+VkRenderPass RenderGraph::GetRenderPass(uint32_t pass) const
+{
+    return passes_[pass].renderPass;
+}
+
+VkImage RenderGraph::GetImage(uint32_t resource) const
+{
+    return resources_[resource].image;
+}
+
+VkImageView RenderGraph::GetImageView(uint32_t resource) const
+{
+    return resources_[resource].imageView;
+}
+
+const RenderGraphStats& RenderGraph::GetStats() const
+{
+    return stats_;
+}
+
+void RenderGraph::PrintStats() const
+{
+    if (stats_.frameCount == 0) {
+        return;
+    }
+
+    auto frames = static_cast<double>(stats_.frameCount);
+    std::cout << "Render graph: " << stats_.passCount << " passes (" << stats_.culledPasses << " culled), "
+        << stats_.transientImages << " transient images in " << stats_.transientBytes / (1024 * 1024) << " MiB ("
+        << stats_.aliasedBytes / (1024 * 1024) << " MiB saved by aliasing), "
+        << static_cast<double>(stats_.barrierBatches) / frames << " barrier batches and "
+        << static_cast<double>(stats_.imageBarriers) / frames << " image barriers per frame" << std::endl;
+    for (const auto& pass : passes_) {
+        if (pass.culled) {
+            std::cout << "  Culled pass: " << pass.name << std::endl;
+        }
+    }
+}
+
+uint32_t RenderGraph::AddResource(const std::string& name, bool isImage, bool transient, VkFormat format)
+{
+    Resource resource;
+    resource.name = name;
+    resource.isImage = isImage;
+    resource.transient = transient;
+    resource.format = format;
+    resources_.push_back(std::move(resource));
+    return static_cast<uint32_t>(resources_.size() - 1);
+}
+
+void RenderGraph::AddAccess(uint32_t pass, uint32_t resource, VkImageLayout layout, VkPipelineStageFlags stageMask,
+    VkAccessFlags accessMask, bool write, bool clear)
+{
+    passes_[pass].accesses.push_back({resource, layout, stageMask, accessMask, write, clear});
+}
+
+void RenderGraph::Release(DeletionQueue& deletionQueue, uint64_t frameNumber)
+{
+    std::vector<VkFramebuffer> framebuffers;
+    for (const auto& [key, framebuffer] : framebuffers_) {
+        framebuffers.push_back(framebuffer);
+    }
+    std::vector<VkImage> images;
+    std::vector<VkImageView> imageViews;
+    for (auto& resource : resources_) {
+        if (resource.transient && resource.image != VK_NULL_HANDLE) {
+            images.push_back(resource.image);
+            imageViews.push_back(resource.imageView);
+        }
+        if (resource.transient) {
+            resource.image = VK_NULL_HANDLE;
+            resource.imageView = VK_NULL_HANDLE;
+            resource.state = ResourceState{};
+            resource.aliases.clear();
+        }
+    }
+    if (!framebuffers.empty() || !images.empty() || !allocations_.empty()) {
+        deletionQueue.Push(frameNumber, [framebuffers, images, imageViews, allocations = allocations_]() {
+            auto& context = VulkanContext::Instance();
+            auto device = context.GetDevice();
+            for (auto framebuffer : framebuffers) {
+                vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+            for (uint32_t i = 0; i < images.size(); i++) {
+                vkDestroyImageView(device, imageViews[i], nullptr);
+                vkDestroyImage(device, images[i], nullptr);
+            }
+            for (auto allocation : allocations) {
+                vmaFreeMemory(context.GetAllocator(), allocation);
+            }
+        });
+    }
+    framebuffers_.clear();
+    allocations_.clear();
+}
+
+void RenderGraph::CullPasses()
+{
+    std::vector<uint8_t> needed(resources_.size(), 0);
+    for (uint32_t i = 0; i < resources_.size(); i++) {
+        needed[i] = resources_[i].output ? 1 : 0;
+    }
+
+    stats_.culledPasses = 0;
+    for (auto i = passes_.size(); i-- > 0;) {
+        auto& pass = passes_[i];
+        pass.culled = !pass.sideEffects;
+        for (const auto& access : pass.accesses) {
+            if (access.write && needed[access.resource]) {
+                pass.culled = false;
+            }
+        }
+        if (pass.culled) {
+            stats_.culledPasses++;
+            continue;
+        }
+        for (const auto& access : pass.accesses) {
+            if (!access.clear) {
+                needed[access.resource] = 1;
+            }
+        }
+    }
+
+    for (auto& resource : resources_) {
+        resource.firstPass = UINT32_MAX;
+        resource.lastPass = 0;
+    }
+    for (uint32_t i = 0; i < passes_.size(); i++) {
+        if (passes_[i].culled) {
+            continue;
+        }
+        for (const auto& access : passes_[i].accesses) {
+            auto& resource = resources_[access.resource];
+            resource.firstPass = std::min(resource.firstPass, i);
+            resource.lastPass = std::max(resource.lastPass, i);
+        }
+    }
+}
+
+void RenderGraph::CreateTransientImages()
+{
+    auto& context = VulkanContext::Instance();
+    auto device = context.GetDevice();
+    auto allocator = context.GetAllocator();
+
+    std::vector<uint32_t> transients;
+    std::vector<VkMemoryRequirements> requirements(resources_.size());
+    uint32_t memoryTypeBits = UINT32_MAX;
+    for (uint32_t i = 0; i < resources_.size(); i++) {
+        auto& resource = resources_[i];
+        if (!resource.transient || resource.firstPass == UINT32_MAX) {
+            continue;
+        }
+
+        VkImageUsageFlags usage = 0;
+        for (uint32_t j = resource.firstPass; j <= resource.lastPass; j++) {
+            for (const auto& access : passes_[j].accesses) {
+                if (access.resource != i || passes_[j].culled) {
+                    continue;
+                }
+                if (access.layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+                    usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+                } else if (access.layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
+                    usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+                } else if (access.layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+                    usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+                } else if (access.layout == VK_IMAGE_LAYOUT_GENERAL) {
+                    usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+                } else if (access.layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+                    usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+                } else if (access.layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+                    usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+                }
+            }
+        }
+
+        VkImageCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        createInfo.imageType = VK_IMAGE_TYPE_2D;
+        createInfo.extent = {extent_.width, extent_.height, 1};
+        createInfo.mipLevels = 1;
+        createInfo.arrayLayers = 1;
+        createInfo.format = resource.format;
+        createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        createInfo.usage = usage;
+        createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VULKAN_CHECK(vkCreateImage(device, &createInfo, nullptr, &resource.image));
+
+        vkGetImageMemoryRequirements(device, resource.image, &requirements[i]);
+        resource.size = requirements[i].size;
+        memoryTypeBits &= requirements[i].memoryTypeBits;
+        transients.push_back(i);
+    }
+
+    stats_.transientImages = static_cast<uint32_t>(transients.size());
+    stats_.transientBytes = 0;
+    stats_.aliasedBytes = 0;
+    if (transients.empty()) {
+        return;
+    }
+
+    VmaAllocationCreateInfo allocationInfo{};
+    allocationInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    if (memoryTypeBits == 0) {
+        for (auto i : transients) {
+            auto& resource = resources_[i];
+            VmaAllocation allocation;
+            VULKAN_CHECK(vmaAllocateMemoryForImage(allocator, resource.image, &allocationInfo, &allocation, nullptr));
+            VULKAN_CHECK(vmaBindImageMemory(allocator, allocation, resource.image));
+            allocations_.push_back(allocation);
+            stats_.transientBytes += resource.size;
+        }
+    } else {
+        std::sort(transients.begin(), transients.end(), [this](uint32_t a, uint32_t b) {
+            return resources_[a].size > resources_[b].size;
+        });
+
+        VkMemoryRequirements blockRequirements{};
+        blockRequirements.alignment = 1;
+        blockRequirements.memoryTypeBits = memoryTypeBits;
+        std::vector<uint32_t> placed;
+        for (auto i : transients) {
+            auto& resource = resources_[i];
+            auto alignment = requirements[i].alignment;
+            resource.offset = 0;
+            for (auto overlap = true; overlap;) {
+                overlap = false;
+                for (auto j : placed) {
+                    const auto& other = resources_[j];
+                    auto lifetimesOverlap = resource.firstPass <= other.lastPass &&
+                        other.firstPass <= resource.lastPass;
+                    if (lifetimesOverlap && resource.offset < other.offset + other.size &&
+                        other.offset < resource.offset + resource.size) {
+                        resource.offset = (other.offset + other.size + alignment - 1) / alignment * alignment;
+                        overlap = true;
+                    }
+                }
+            }
+            for (auto j : placed) {
+                auto& other = resources_[j];
+                if (resource.offset < other.offset + other.size && other.offset < resource.offset + resource.size) {
+                    resource.aliases.push_back(j);
+                    other.aliases.push_back(i);
+                }
+            }
+            placed.push_back(i);
+            blockRequirements.size = std::max(blockRequirements.size, resource.offset + resource.size);
+            blockRequirements.alignment = std::max(blockRequirements.alignment, alignment);
+        }
+
+        VmaAllocation allocation;
+        VULKAN_CHECK(vmaAllocateMemory(allocator, &blockRequirements, &allocationInfo, &allocation, nullptr));
+        for (auto i : transients) {
+            VULKAN_CHECK(vmaBindImageMemory2(allocator, allocation, resources_[i].offset, resources_[i].image,
+                nullptr));
+        }
+        allocations_.push_back(allocation);
+        stats_.transientBytes = blockRequirements.size;
+    }
+
+    VkDeviceSize requestedBytes = 0;
+    for (auto i : transients) {
+        auto& resource = resources_[i];
+        resource.imageView = context.CreateImageView(resource.image, resource.format,
+            VulkanContext::GetFormatAspectMask(resource.format));
+        requestedBytes += resource.size;
+    }
+    stats_.aliasedBytes = requestedBytes - stats_.transientBytes;
+}
+
+void RenderGraph::CreateRenderPasses()
+{
+    auto device = VulkanContext::Instance().GetDevice();
+    for (uint32_t i = 0; i < passes_.size(); i++) {
+        auto& pass = passes_[i];
+        pass.renderPass = VK_NULL_HANDLE;
+        auto hasDepth = pass.depthAttachment.resource != UINT32_MAX;
+        if (pass.culled || (pass.colorAttachments.empty() && !hasDepth)) {
+            continue;
+        }
+
+        std::vector<VkAttachmentDescription> attachments;
+        std::vector<VkAttachmentReference> colorAttachmentRefs;
+        VkAttachmentReference depthAttachmentRef{};
+        std::vector<uint32_t> key;
+        auto addAttachment = [this, i, &attachments, &key](const Attachment& attachment, VkImageLayout layout) {
+            const auto& resource = resources_[attachment.resource];
+
+            VkAttachmentDescription description{};
+            description.format = resource.format;
+            description.samples = VK_SAMPLE_COUNT_1_BIT;
+            if (attachment.clear) {
+                description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            } else if (!resource.transient || resource.firstPass < i) {
+                description.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            } else {
+                description.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            }
+            if (resource.output || !resource.transient || resource.lastPass > i) {
+                description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            } else {
+                description.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            }
+            description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            description.initialLayout = layout;
+            description.finalLayout = layout;
+            attachments.push_back(description);
+            key.insert(key.end(), {static_cast<uint32_t>(description.format),
+                static_cast<uint32_t>(description.loadOp), static_cast<uint32_t>(description.storeOp),
+                static_cast<uint32_t>(layout)});
+            return static_cast<uint32_t>(attachments.size() - 1);
+        };
+        for (const auto& attachment : pass.colorAttachments) {
+            colorAttachmentRefs.push_back({addAttachment(attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL),
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+        }
+        if (hasDepth) {
+            depthAttachmentRef = {addAttachment(pass.depthAttachment,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+        }
+        key.push_back(static_cast<uint32_t>(colorAttachmentRefs.size()));
+
+        auto cached = renderPasses_.find(key);
+        if (cached != renderPasses_.end()) {
+            pass.renderPass = cached->second;
+            continue;
+        }
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = static_cast<uint32_t>(colorAttachmentRefs.size());
+        subpass.pColorAttachments = colorAttachmentRefs.data();
+        subpass.pDepthStencilAttachment = hasDepth ? &depthAttachmentRef : nullptr;
+
+        VkRenderPassCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        createInfo.pAttachments = attachments.data();
+        createInfo.subpassCount = 1;
+        createInfo.pSubpasses = &subpass;
+        VULKAN_CHECK(vkCreateRenderPass(device, &createInfo, nullptr, &pass.renderPass));
+        renderPasses_[key] = pass.renderPass;
+    }
+}
+
+VkFramebuffer RenderGraph::GetFramebuffer(const Pass& pass)
+{
+    std::vector<VkImageView> attachments;
+    for (const auto& attachment : pass.colorAttachments) {
+        attachments.push_back(resources_[attachment.resource].imageView);
+    }
+    if (pass.depthAttachment.resource != UINT32_MAX) {
+        attachments.push_back(resources_[pass.depthAttachment.resource].imageView);
+    }
+
+    std::vector<uint64_t> key = {reinterpret_cast<uint64_t>(pass.renderPass)};
+    for (auto attachment : attachments) {
+        key.push_back(reinterpret_cast<uint64_t>(attachment));
+    }
+    auto cached = framebuffers_.find(key);
+    if (cached != framebuffers_.end()) {
+        return cached->second;
+    }
+
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = pass.renderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    framebufferInfo.pAttachments = attachments.data();
+    framebufferInfo.width = extent_.width;
+    framebufferInfo.height = extent_.height;
+    framebufferInfo.layers = 1;
+
+    VkFramebuffer framebuffer;
+    VULKAN_CHECK(vkCreateFramebuffer(VulkanContext::Instance().GetDevice(), &framebufferInfo, nullptr,
+        &framebuffer));
+    framebuffers_[key] = framebuffer;
+    return framebuffer;
+}
+
+void RenderGraph::AddBarrier(Resource& resource, const Access& access, BarrierBatch& batch)
+{
+    auto& state = resource.state;
+    auto srcStageMask = state.writeStageMask | state.readStageMask;
+    auto srcAccessMask = state.writeAccessMask;
+    auto oldLayout = state.layout;
+    if (!resource.touched) {
+        if (!resource.aliases.empty() || oldLayout != access.layout) {
+            oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        }
+        for (auto alias : resource.aliases) {
+            const auto& aliasState = resources_[alias].state;
+            srcStageMask |= aliasState.writeStageMask | aliasState.readStageMask;
+            srcAccessMask |= aliasState.writeAccessMask;
+        }
+        resource.touched = true;
+    }
+
+    auto layoutChange = resource.isImage && oldLayout != access.layout;
+    if (!layoutChange && !access.write) {
+        auto covered = (state.readStageMask & access.stageMask) == access.stageMask &&
+            (state.readAccessMask & access.accessMask) == access.accessMask;
+        if (state.writeStageMask == 0 || covered) {
+            state.readStageMask |= access.stageMask;
+            state.readAccessMask |= access.accessMask;
+            return;
+        }
+        srcStageMask = state.writeStageMask;
+    }
+
+    if (layoutChange) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccessMask;
+        barrier.dstAccessMask = access.accessMask;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = access.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = resource.image;
+        barrier.subresourceRange = {VulkanContext::GetFormatAspectMask(resource.format), 0,
+            VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+        batch.imageBarriers.push_back(barrier);
+        batch.srcStageMask |= srcStageMask != 0 ? srcStageMask : access.stageMask;
+        batch.dstStageMask |= access.stageMask;
+    } else if (srcStageMask != 0) {
+        batch.memoryBarrier.srcAccessMask |= srcAccessMask;
+        batch.memoryBarrier.dstAccessMask |= access.accessMask;
+        batch.srcStageMask |= srcStageMask;
+        batch.dstStageMask |= access.stageMask;
+    }
+
+    if (access.write || layoutChange) {
+        state.layout = resource.isImage ? access.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+        state.writeStageMask = access.stageMask;
+        state.writeAccessMask = access.write ? access.accessMask : 0;
+        state.readStageMask = access.write ? 0 : access.stageMask;
+        state.readAccessMask = access.write ? 0 : access.accessMask;
+    } else {
+        state.readStageMask |= access.stageMask;
+        state.readAccessMask |= access.accessMask;
+    }
+}
+
+void RenderGraph::FlushBarriers(VkCommandBuffer commandBuffer, BarrierBatch& batch)
+{
+    if (batch.srcStageMask == 0) {
+        return;
+    }
+
+    batch.memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    auto memoryBarrierCount = batch.memoryBarrier.srcAccessMask != 0 ? 1u : 0u;
+    vkCmdPipelineBarrier(commandBuffer, batch.srcStageMask, batch.dstStageMask, 0, memoryBarrierCount,
+        &batch.memoryBarrier, 0, nullptr, static_cast<uint32_t>(batch.imageBarriers.size()),
+        batch.imageBarriers.data());
+    stats_.barrierBatches++;
+    stats_.imageBarriers += batch.imageBarriers.size();
+}
+
+void RenderGraph::DestroyQueryPool()
+{
+    if (queryPool_ != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(VulkanContext::Instance().GetDevice(), queryPool_, nullptr);
+        queryPool_ = VK_NULL_HANDLE;
+    }
+}
\ No newline at end of file
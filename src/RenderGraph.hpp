@@ -0,0 +1,149 @@
+#ifndef RENDER_GRAPH_HPP
+#define RENDER_GRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "DeletionQueue.hpp"
+
+struct RenderPassContext {
+    VkCommandBuffer commandBuffer;
+    VkRenderPass renderPass;
+    VkFramebuffer framebuffer;
+    VkExtent2D renderArea;
+};
+
+struct RenderGraphStats {
+    uint32_t passCount = 0, culledPasses = 0, transientImages = 0;
+    VkDeviceSize transientBytes = 0, aliasedBytes = 0;
+    uint64_t barrierBatches = 0, imageBarriers = 0, frameCount = 0;
+};
+
+class RenderGraph {
+public:
+    using ExecuteCallback = std::function<void(const RenderPassContext&)>;
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    uint32_t ImportImage(const std::string& name, VkFormat format);
+    uint32_t CreateImage(const std::string& name, VkFormat format);
+    uint32_t ImportBuffer(const std::string& name);
+    void BindImage(uint32_t resource, VkImage image, VkImageView imageView, VkImageLayout layout);
+    void BindBuffer(uint32_t resource, VkBuffer buffer);
+    void SetOutput(uint32_t resource, VkImageLayout finalLayout);
+
+    uint32_t AddPass(const std::string& name, ExecuteCallback callback);
+    void WriteColor(uint32_t pass, uint32_t resource, const VkClearColorValue* clearValue = nullptr);
+    void WriteDepth(uint32_t pass, uint32_t resource, const VkClearDepthStencilValue* clearValue = nullptr);
+    void ReadTexture(uint32_t pass, uint32_t resource, VkPipelineStageFlags stageMask);
+    void ReadStorage(uint32_t pass, uint32_t resource, VkPipelineStageFlags stageMask);
+    void WriteStorage(uint32_t pass, uint32_t resource, VkPipelineStageFlags stageMask);
+    void ReadIndirect(uint32_t pass, uint32_t resource);
+    void ReadTransfer(uint32_t pass, uint32_t resource);
+    void WriteTransfer(uint32_t pass, uint32_t resource);
+    void SetSideEffects(uint32_t pass);
+    void SetSecondaryCommandBuffers(uint32_t pass);
+    void SetRenderArea(uint32_t pass, VkExtent2D renderArea);
+
+    void Compile(VkExtent2D extent, DeletionQueue& deletionQueue, uint64_t frameNumber);
+    void EnableTimestamps(uint32_t slotCount);
+    void Execute(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t frameIndex);
+    bool ResolveTimestamps(uint32_t slot, uint32_t& frameIndex, std::vector<double>& passMilliseconds);
+    uint32_t GetPassCount() const;
+    const std::string& GetPassName(uint32_t pass) const;
+    bool IsPassCulled(uint32_t pass) const;
+    VkRenderPass GetRenderPass(uint32_t pass) const;
+    VkImage GetImage(uint32_t resource) const;
+    VkImageView GetImageView(uint32_t resource) const;
+    const RenderGraphStats& GetStats() const;
+    void PrintStats() const;
+
+private:
+    struct Access {
+        uint32_t resource;
+        VkImageLayout layout;
+        VkPipelineStageFlags stageMask;
+        VkAccessFlags accessMask;
+        bool write, clear;
+    };
+
+    struct Attachment {
+        uint32_t resource = UINT32_MAX;
+        bool clear = false;
+        VkClearValue clearValue{};
+    };
+
+    struct Pass {
+        std::string name;
+        ExecuteCallback callback;
+        std::vector<Access> accesses;
+        std::vector<Attachment> colorAttachments;
+        Attachment depthAttachment;
+        VkExtent2D renderArea{};
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        bool sideEffects = false, secondaryCommandBuffers = false, culled = false;
+    };
+
+    struct ResourceState {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStageMask = 0, readStageMask = 0;
+        VkAccessFlags writeAccessMask = 0, readAccessMask = 0;
+    };
+
+    struct Resource {
+        std::string name;
+        bool isImage, transient, output = false;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView imageView = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        uint32_t firstPass = UINT32_MAX, lastPass = 0;
+        VkDeviceSize offset = 0, size = 0;
+        std::vector<uint32_t> aliases;
+        ResourceState state;
+        bool touched = false;
+    };
+
+    struct BarrierBatch {
+        VkPipelineStageFlags srcStageMask = 0, dstStageMask = 0;
+        VkMemoryBarrier memoryBarrier{};
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+    };
+
+    uint32_t AddResource(const std::string& name, bool isImage, bool transient, VkFormat format);
+    void AddAccess(uint32_t pass, uint32_t resource, VkImageLayout layout, VkPipelineStageFlags stageMask,
+        VkAccessFlags accessMask, bool write, bool clear = false);
+    void Release(DeletionQueue& deletionQueue, uint64_t frameNumber);
+    void CullPasses();
+    void CreateTransientImages();
+    void CreateRenderPasses();
+    VkFramebuffer GetFramebuffer(const Pass& pass);
+    void AddBarrier(Resource& resource, const Access& access, BarrierBatch& batch);
+    void FlushBarriers(VkCommandBuffer commandBuffer, BarrierBatch& batch);
+    void DestroyQueryPool();
+
+    std::vector<Pass> passes_;
+    std::vector<Resource> resources_;
+    VkExtent2D extent_{};
+    std::vector<VmaAllocation> allocations_;
+    std::map<std::vector<uint32_t>, VkRenderPass> renderPasses_;
+    std::map<std::vector<uint64_t>, VkFramebuffer> framebuffers_;
+    VkQueryPool queryPool_ = VK_NULL_HANDLE;
+    double timestampPeriod_ = 0.0;
+    std::vector<uint32_t> timestampFrames_;
+    std::vector<bool> timestampsPending_;
+    RenderGraphStats stats_;
+};
+
+#endif
\ No newline at end of file
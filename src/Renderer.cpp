@@ -2,28 +2,78 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <fstream>
+#include <future>
+#include <random>
 #include <iostream>
+#include <map>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "CaptureSinks.hpp"
 #include "Image.hpp"
+#include "Profiler.hpp"
 
-Renderer::Renderer(uint32_t width, uint32_t height) :
-    width_(width),
-    height_(height) {}
+Renderer::Renderer(const RendererConfig& config) :
+    config_(config),
+    width_(config.width),
+    height_(config.height),
+    requestedFramesInFlight_(config.framesInFlight) {}
 
 Renderer::~Renderer() = default;
 
 void Renderer::Run()
 {
-    InitScene();
-    InitWindow();
+    if (!config_.tracePath.empty()) {
+        Profiler::Instance().SetEnabled(true);
+        Profiler::Instance().SetThreadName("Main");
+    }
+
+    VulkanContext::Instance().SetShaderDirectory(config_.shaderDirectory);
+    auto sceneLoading = std::async(std::launch::async, [this]() {
+        if (Profiler::Instance().IsEnabled()) {
+            Profiler::Instance().SetThreadName("Loader");
+        }
+        startupTimer_.Measure("Scene", [this]() {
+            InitScene();
+        });
+    });
+    if (!config_.headless) {
+        startupTimer_.Measure("Window", [this]() {
+            InitWindow();
+        });
+    }
+    startupTimer_.Measure("Device", [this]() {
+        InitDevice();
+    });
+    sceneLoading.get();
     InitVulkan();
     MainLoop();
+    if (benchmark_) {
+        benchmark_->SampleMemory(allocator_);
+        benchmark_->PrintSummary();
+        if (!config_.reportPath.empty()) {
+            benchmark_->WriteReport(config_.reportPath);
+        }
+    }
+    if (config_.headless && !config_.outputPath.empty()) {
+        WriteImage(config_.outputPath, ReadbackImage(lastImageIndex_));
+    }
     Cleanup();
+
+    if (!config_.tracePath.empty()) {
+        Profiler::Instance().ExportChromeTrace(config_.tracePath);
+    }
+}
+
+BenchmarkResult Renderer::GetBenchmarkResult() const
+{
+    return benchmark_ ? benchmark_->GetResult() : BenchmarkResult{};
 }
 
 void Renderer::InitWindow()
@@ -35,6 +85,7 @@ void Renderer::InitWindow()
 
     glfwSetWindowUserPointer(window_, this);
     glfwSetFramebufferSizeCallback(window_, FramebufferResizeCallback);
+    glfwSetKeyCallback(window_, KeyCallback);
 }
 
 void Renderer::FramebufferResizeCallback(GLFWwindow* window, int width, int height)
@@ -43,8 +94,25 @@ void Renderer::FramebufferResizeCallback(GLFWwindow* window, int width, int heig
     renderer->framebufferResized_ = true;
 }
 
-void Renderer::InitVulkan()
+void Renderer::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS) {
+        return;
+    }
+
+    auto renderer = reinterpret_cast<Renderer*>(glfwGetWindowUserPointer(window));
+    auto& framesInFlight = renderer->requestedFramesInFlight_;
+    if (key == GLFW_KEY_LEFT_BRACKET && framesInFlight > 1) {
+        framesInFlight--;
+    } else if (key == GLFW_KEY_RIGHT_BRACKET && framesInFlight < RendererConfig::MAX_FRAMES_IN_FLIGHT) {
+        framesInFlight++;
+    }
+}
+
+void Renderer::InitDevice()
 {
+    PROFILE_SCOPE("InitDevice");
+
     auto& context = VulkanContext::Instance();
     context.Init(window_);
     instance_ = context.GetInstance();
@@ -53,27 +121,71 @@ void Renderer::InitVulkan()
     graphicsQueue_ = context.GetGraphicsQueue();
     presentQueue_ = context.GetPresentQueue();
     allocator_ = context.GetAllocator();
-    commandPool_ = context.GetCommandPool();
 
     CreateSwapchain();
+    if (config_.IsDynamicResolutionEnabled()) {
+        resolutionController_ = std::make_unique<ResolutionController>(config_.resolutionBudgetMs, config_.renderScale,
+            config_.minRenderScale, 1.0f);
+    }
     CreateSwapchainImageViews();
-    CreateSwapchainDepthResources();
-    CreateRenderPass();
-    CreateDescriptorSetLayout();
-    CreateGraphicsPipeline();
-    CreateSwapchainFramebuffers();
-    CreateCommandBuffers();
-    CreateUniformBuffers();
-    CreateDescriptorPool();
-    CreateSyncObjects();
-
-    mesh_->Bind();
+}
 
-    CreateDescriptorSets();
+void Renderer::InitVulkan()
+{
+    PROFILE_SCOPE("InitVulkan");
+
+    auto assetUpload = std::async(std::launch::async, [this]() {
+        if (Profiler::Instance().IsEnabled()) {
+            Profiler::Instance().SetThreadName("Loader");
+        }
+        startupTimer_.Measure("Assets", [this]() {
+            CreateVertexPool();
+            for (const auto& mesh : meshes_) {
+                mesh->Bind();
+            }
+        });
+    });
+    startupTimer_.Measure("Descriptors", [this]() {
+        CreateDescriptorSetLayout();
+        CreateBindlessTextures();
+        CreateClusteredLighting();
+        CreateShadowMaps();
+        CreateFrameCapture();
+    });
+    startupTimer_.Measure("Pipelines", [this]() {
+        CreateRenderGraph();
+        CreateGraphicsPipeline();
+    });
+    assetUpload.get();
+    if (benchmark_) {
+        auto uploadStats = VulkanContext::Instance().GetUploadStats();
+        benchmark_->SetUploadStats(uploadStats.directBytes, uploadStats.stagedBytes);
+    }
+
+    startupTimer_.Measure("FrameResources", [this]() {
+        if (bindlessTextures_) {
+            std::map<const Texture*, uint32_t> textureIndices;
+            for (const auto& instanceBatch : instanceBatches_) {
+                const auto& mesh = instanceBatch->GetMesh();
+                auto texture = textureIndices.find(mesh->GetTexture().get());
+                if (texture == textureIndices.end()) {
+                    auto textureIndex = bindlessTextures_->Register(mesh->GetTextureInfo());
+                    texture = textureIndices.emplace(mesh->GetTexture().get(), textureIndex).first;
+                }
+                instanceBatch->SetTextureIndex(texture->second);
+            }
+        }
+        CreateFrameResources();
+    });
 }
 
 void Renderer::CreateSwapchain()
 {
+    if (config_.headless) {
+        CreateOffscreenTargets();
+        return;
+    }
+
     auto swapchainSupport = VulkanContext::Instance().GetSwapchainSupport();
 
     uint32_t imageCount = swapchainSupport.capabilities.minImageCount + 1;
@@ -101,6 +213,26 @@ void Renderer::CreateSwapchain()
     createInfo.imageExtent = swapchainImageExtent_;
     createInfo.imageArrayLayers = 1;
     createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (config_.IsDynamicResolutionEnabled()) {
+        if (swapchainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        } else {
+            std::cerr << "Swapchain images do not support transfer destination usage, dynamic resolution disabled"
+                << std::endl;
+            config_.renderScale = 1.0f;
+            config_.resolutionBudgetMs = 0.0f;
+        }
+    }
+    if (config_.IsCaptureEnabled()) {
+        if (swapchainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        } else {
+            std::cerr << "Swapchain images do not support transfer source usage, capture disabled" << std::endl;
+            config_.captureRawPath.clear();
+            config_.capturePngDirectory.clear();
+            config_.capturePipeCommand.clear();
+        }
+    }
     if (indices.graphicsFamilyIndex != indices.presentFamilyIndex) {
         createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
         createInfo.queueFamilyIndexCount = 2;
@@ -112,7 +244,7 @@ void Renderer::CreateSwapchain()
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    createInfo.oldSwapchain = swapchain_;
     VULKAN_CHECK(vkCreateSwapchainKHR(device_, &createInfo, nullptr, &swapchain_));
 
     uint32_t swapchainImageCount;
@@ -121,6 +253,21 @@ void Renderer::CreateSwapchain()
     vkGetSwapchainImagesKHR(device_, swapchain_, &swapchainImageCount, swapchainImages_.data());
 }
 
+void Renderer::CreateOffscreenTargets()
+{
+    swapchainImageFormat_ = VK_FORMAT_R8G8B8A8_UNORM;
+    swapchainImageExtent_ = {width_, height_};
+
+    swapchainImages_.resize(config_.framesInFlight);
+    offscreenAllocations_.resize(config_.framesInFlight);
+    for (uint32_t i = 0; i < config_.framesInFlight; i++) {
+        VulkanContext::Instance().CreateImage(swapchainImageExtent_.width, swapchainImageExtent_.height,
+            swapchainImageFormat_, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, {},
+            swapchainImages_[i], offscreenAllocations_[i]);
+    }
+}
+
 VkExtent2D Renderer::ChooseSwapchainExtent(const VkSurfaceCapabilitiesKHR& capabilities)
 {
     if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
@@ -151,17 +298,28 @@ VkSurfaceFormatKHR Renderer::ChooseSwapchainFormat(const std::vector<VkSurfaceFo
 
 VkPresentModeKHR Renderer::ChooseSwapchainPresentMode(const std::vector<VkPresentModeKHR>& presentModes)
 {
-    static const std::unordered_map<VkPresentModeKHR, uint32_t> PRESENT_MODE_PRIORITY = {
-        {VK_PRESENT_MODE_MAILBOX_KHR, 0},
-        {VK_PRESENT_MODE_IMMEDIATE_KHR, 1},
-        {VK_PRESENT_MODE_FIFO_KHR, 2}
+    static const std::unordered_map<LatencyMode, std::unordered_map<VkPresentModeKHR, uint32_t>> PRESENT_MODE_PRIORITY = {
+        {LatencyMode::Throughput, {
+            {VK_PRESENT_MODE_MAILBOX_KHR, 0},
+            {VK_PRESENT_MODE_IMMEDIATE_KHR, 1},
+            {VK_PRESENT_MODE_FIFO_KHR, 2}
+        }},
+        {LatencyMode::Vsync, {
+            {VK_PRESENT_MODE_FIFO_KHR, 2}
+        }},
+        {LatencyMode::LowLatency, {
+            {VK_PRESENT_MODE_IMMEDIATE_KHR, 0},
+            {VK_PRESENT_MODE_MAILBOX_KHR, 1},
+            {VK_PRESENT_MODE_FIFO_KHR, 2}
+        }}
     };
 
+    const auto& priorities = PRESENT_MODE_PRIORITY.at(config_.latencyMode);
     auto mode = VK_PRESENT_MODE_FIFO_KHR;
     auto priority = 2;
     for (const auto& presentMode : presentModes) {
-        auto iter = PRESENT_MODE_PRIORITY.find(presentMode);
-        if (iter != PRESENT_MODE_PRIORITY.end() && iter->second < priority) {
+        auto iter = priorities.find(presentMode);
+        if (iter != priorities.end() && iter->second < priority) {
             mode = presentMode;
             priority = iter->second;
         }
@@ -178,72 +336,25 @@ void Renderer::CreateSwapchainImageViews()
     }
 }
 
-void Renderer::CreateSwapchainDepthResources()
-{
-    VulkanContext::Instance().CreateImage(swapchainImageExtent_.width, swapchainImageExtent_.height,
-        VK_FORMAT_D32_SFLOAT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, {},
-        swapchainDepthImage_, swapchainDepthAllocation_);
-    swapchainDepthImageView_ = VulkanContext::Instance().CreateImageView(swapchainDepthImage_, VK_FORMAT_D32_SFLOAT,
-        VK_IMAGE_ASPECT_DEPTH_BIT);
-    VulkanContext::Instance().TransitionImageLayout(swapchainDepthImage_, VK_FORMAT_D32_SFLOAT,
-        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-}
-
-void Renderer::CreateRenderPass()
-{
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = swapchainImageFormat_;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    VkAttachmentDescription depthAttachment{};
-    depthAttachment.format = VK_FORMAT_D32_SFLOAT;
-    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    VkAttachmentReference colorAttachmentRef{};
-    colorAttachmentRef.attachment = 0;
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    VkAttachmentReference depthAttachmentRef{};
-    depthAttachmentRef.attachment = 1;
-    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-    subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-    VkSubpassDependency subpassDependency{};
-    subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    subpassDependency.dstSubpass = 0;
-    subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    subpassDependency.srcAccessMask = 0;
-    subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    std::vector<VkAttachmentDescription> attachments = {colorAttachment, depthAttachment};
-
-    VkRenderPassCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-    createInfo.pAttachments = attachments.data();
-    createInfo.subpassCount = 1;
-    createInfo.pSubpasses = &subpass;
-    createInfo.dependencyCount = 1;
-    createInfo.pDependencies = &subpassDependency;
-    VULKAN_CHECK(vkCreateRenderPass(device_, &createInfo, nullptr, &renderPass_));
+void Renderer::CreateVertexPool()
+{
+    if (!config_.vertexPulling) {
+        return;
+    }
+
+    std::vector<uint32_t> baseVertices;
+    uint32_t vertexCount = 0;
+    for (const auto& mesh : meshes_) {
+        baseVertices.push_back(vertexCount);
+        vertexCount += mesh->GetVertexCount();
+    }
+    vertexPoolSize_ = sizeof(PackedVertex) * vertexCount;
+    VulkanContext::Instance().CreateBuffer(vertexPoolSize_,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VulkanContext::DIRECT_UPLOAD_ALLOCATION_FLAGS, vertexPool_, vertexPoolAllocation_);
+    for (uint32_t i = 0; i < meshes_.size(); i++) {
+        meshes_[i]->SetVertexPool(vertexPool_, vertexPoolAllocation_, baseVertices[i]);
+    }
 }
 
 void Renderer::CreateDescriptorSetLayout()
@@ -261,6 +372,14 @@ void Renderer::CreateDescriptorSetLayout()
     samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
     std::vector<VkDescriptorSetLayoutBinding> bindings = {uboLayoutBinding, samplerLayoutBinding};
+    if (config_.vertexPulling) {
+        VkDescriptorSetLayoutBinding vertexPoolLayoutBinding{};
+        vertexPoolLayoutBinding.binding = 2;
+        vertexPoolLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        vertexPoolLayoutBinding.descriptorCount = 1;
+        vertexPoolLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        bindings.push_back(vertexPoolLayoutBinding);
+    }
 
     VkDescriptorSetLayoutCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -270,12 +389,185 @@ void Renderer::CreateDescriptorSetLayout()
     VULKAN_CHECK(vkCreateDescriptorSetLayout(device_, &createInfo, nullptr, &descriptorSetLayout_));
 }
 
+void Renderer::CreateBindlessTextures()
+{
+    if (!config_.bindless) {
+        return;
+    }
+    if (!BindlessTextures::IsSupported()) {
+        std::cerr << "Descriptor indexing is not supported, falling back to per-mesh texture bindings" << std::endl;
+        return;
+    }
+    bindlessTextures_ = std::make_unique<BindlessTextures>(MAX_BINDLESS_TEXTURES);
+}
+
+void Renderer::CreateClusteredLighting()
+{
+    if (!config_.IsClusteredLightingEnabled()) {
+        return;
+    }
+    clusteredLighting_ = std::make_unique<ClusteredLighting>(config_.lightCount,
+        RendererConfig::MAX_FRAMES_IN_FLIGHT);
+}
+
+void Renderer::CreateShadowMaps()
+{
+    if (!config_.shadows) {
+        return;
+    }
+    shadowMaps_ = std::make_unique<CascadedShadowMaps>(config_.shadowResolution, NEAR_PLANE, FAR_PLANE,
+        glm::vec3(-0.4f, -0.3f, -0.85f), threadPool_.get());
+}
+
+void Renderer::CreateRenderGraph()
+{
+    renderGraph_ = std::make_unique<RenderGraph>();
+    swapchainResource_ = renderGraph_->ImportImage("swapchain", swapchainImageFormat_);
+    renderGraph_->SetOutput(swapchainResource_, config_.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL :
+        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    depthResource_ = renderGraph_->CreateImage("depth", VK_FORMAT_D32_SFLOAT);
+    auto colorResource = swapchainResource_;
+    if (resolutionController_) {
+        sceneColorResource_ = renderGraph_->CreateImage("sceneColor", swapchainImageFormat_);
+        colorResource = sceneColorResource_;
+    }
+
+    auto cullingPass = renderGraph_->AddPass("Culling", [this](const RenderPassContext& context) {
+        for (const auto& instanceBatch : instanceBatches_) {
+            instanceBatch->RecordUpload(context.commandBuffer, *frameScheduler_, deletionQueue_);
+        }
+        if (gpuCuller_) {
+            gpuCuller_->Record(context.commandBuffer, viewProjection_, instanceBatches_, *frameScheduler_,
+                *descriptorAllocator_, deletionQueue_, hiZPyramid_.get());
+        } else if (frustumCuller_) {
+            CullInstances();
+        }
+    });
+    renderGraph_->SetSideEffects(cullingPass);
+
+    if (shadowMaps_) {
+        auto shadowPass = renderGraph_->AddPass("Shadows", [this](const RenderPassContext& context) {
+            shadowMaps_->Record(context.commandBuffer, instanceBatches_, uniforms_.model, uniforms_.view,
+                uniforms_.proj);
+        });
+        renderGraph_->SetSideEffects(shadowPass);
+    }
+    if (clusteredLighting_) {
+        auto lightCullPass = renderGraph_->AddPass("LightCulling", [this](const RenderPassContext& context) {
+            ClusterParameters parameters{};
+            parameters.cameraPosition = glm::vec4(cameraPosition_, 1.0f);
+            parameters.screenSize = glm::vec2(static_cast<float>(renderExtent_.width),
+                static_cast<float>(renderExtent_.height));
+            parameters.nearPlane = NEAR_PLANE;
+            parameters.farPlane = FAR_PLANE;
+            clusteredLighting_->Record(context.commandBuffer, *frameScheduler_, *descriptorAllocator_, lights_,
+                parameters, frameIndex_);
+        });
+        renderGraph_->SetSideEffects(lightCullPass);
+    }
+
+    VkClearColorValue clearColor = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    VkClearDepthStencilValue clearDepth = {1.0f, 0};
+    if (config_.depthPrepass) {
+        depthPrepassPass_ = renderGraph_->AddPass("DepthPrepass", [this](const RenderPassContext& context) {
+            auto descriptorSet = frameScheduler_->GetFrame(frameScheduler_->GetFrameSlot()).descriptorSet;
+            RecordDepthPrepass(context.commandBuffer, descriptorSet, CullPhase::Early);
+        });
+        renderGraph_->WriteDepth(depthPrepassPass_, depthResource_, &clearDepth);
+    }
+
+    scenePass_ = renderGraph_->AddPass("Scene", [this](const RenderPassContext& context) {
+        auto frameSlot = frameScheduler_->GetFrameSlot();
+        BuildDrawRanges();
+        auto rangeCount = static_cast<uint32_t>(drawRanges_.size());
+        if (commandRecorder_) {
+            VkCommandBufferInheritanceInfo inheritanceInfo{};
+            inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo.renderPass = context.renderPass;
+            inheritanceInfo.subpass = 0;
+            inheritanceInfo.framebuffer = context.framebuffer;
+            const auto& secondaryCommandBuffers = commandRecorder_->Record(frameSlot, rangeCount, inheritanceInfo,
+                [this, frameSlot](VkCommandBuffer secondaryCommandBuffer, uint32_t begin, uint32_t end) {
+                    RecordInstanceBatches(secondaryCommandBuffer, frameSlot, begin, end, CullPhase::Early);
+                }
+            );
+            vkCmdExecuteCommands(context.commandBuffer, static_cast<uint32_t>(secondaryCommandBuffers.size()),
+                secondaryCommandBuffers.data());
+        } else {
+            RecordInstanceBatches(context.commandBuffer, frameSlot, 0, rangeCount, CullPhase::Early);
+        }
+        drawCount_ = rangeCount;
+    });
+    renderGraph_->WriteColor(scenePass_, colorResource, &clearColor);
+    renderGraph_->WriteDepth(scenePass_, depthResource_, config_.depthPrepass ? nullptr : &clearDepth);
+    if (config_.recordThreads > 0) {
+        renderGraph_->SetSecondaryCommandBuffers(scenePass_);
+    }
+
+    if (config_.cullingMode == CullingMode::GpuOcclusion) {
+        auto hiZPass = renderGraph_->AddPass("HiZ", [this](const RenderPassContext& context) {
+            hiZPyramid_->Build(context.commandBuffer, renderGraph_->GetImageView(depthResource_), renderExtent_,
+                frameScheduler_->GetFrameSlot(), *descriptorAllocator_);
+            gpuCuller_->RecordLate(context.commandBuffer, instanceBatches_, *hiZPyramid_);
+        });
+        renderGraph_->ReadTexture(hiZPass, depthResource_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        renderGraph_->SetSideEffects(hiZPass);
+
+        if (config_.depthPrepass) {
+            lateDepthPrepassPass_ = renderGraph_->AddPass("DepthPrepassLate", [this](const RenderPassContext& context) {
+                auto descriptorSet = frameScheduler_->GetFrame(frameScheduler_->GetFrameSlot()).descriptorSet;
+                RecordDepthPrepass(context.commandBuffer, descriptorSet, CullPhase::Late);
+            });
+            renderGraph_->WriteDepth(lateDepthPrepassPass_, depthResource_);
+        }
+
+        lateScenePass_ = renderGraph_->AddPass("SceneLate", [this](const RenderPassContext& context) {
+            auto rangeCount = static_cast<uint32_t>(drawRanges_.size());
+            RecordInstanceBatches(context.commandBuffer, frameScheduler_->GetFrameSlot(), 0, rangeCount,
+                CullPhase::Late);
+            drawCount_ += rangeCount;
+        });
+        renderGraph_->WriteColor(lateScenePass_, colorResource);
+        renderGraph_->WriteDepth(lateScenePass_, depthResource_);
+    }
+
+    if (resolutionController_) {
+        auto upscalePass = renderGraph_->AddPass("Upscale", [this](const RenderPassContext& context) {
+            BlitSceneColor(context.commandBuffer);
+        });
+        renderGraph_->ReadTransfer(upscalePass, sceneColorResource_);
+        renderGraph_->WriteTransfer(upscalePass, swapchainResource_);
+    }
+
+    if (config_.IsCaptureEnabled()) {
+        auto capturePass = renderGraph_->AddPass("Capture", [this](const RenderPassContext& context) {
+            frameCapture_->Record(context.commandBuffer, renderGraph_->GetImage(swapchainResource_),
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, frameIndex_, frameScheduler_->GetFrameNumber());
+        });
+        renderGraph_->ReadTransfer(capturePass, swapchainResource_);
+        renderGraph_->SetSideEffects(capturePass);
+    }
+
+    renderGraph_->Compile(swapchainImageExtent_, deletionQueue_, 0);
+}
+
 void Renderer::CreateGraphicsPipeline()
 {
-    auto vertShaderCode = ReadFile("shader/shader.vert.spv");
-    auto fragShaderCode = ReadFile("shader/shader.frag.spv");
-    vertShaderModule_ = CreateShaderModule(vertShaderCode);
-    fragShaderModule_ = CreateShaderModule(fragShaderCode);
+    auto& context = VulkanContext::Instance();
+    vertShaderModule_ = context.CreateShaderModule(config_.vertexPulling ? "shader/pulled.vert.spv" :
+        "shader/shader.vert.spv");
+    std::string fragShaderName = "shader";
+    if (clusteredLighting_ && shadowMaps_) {
+        fragShaderName = "clustered_shadowed";
+    } else if (clusteredLighting_) {
+        fragShaderName = "clustered";
+    } else if (shadowMaps_) {
+        fragShaderName = "shadowed";
+    }
+    if (bindlessTextures_) {
+        fragShaderName = fragShaderName == "shader" ? "bindless" : fragShaderName + "_bindless";
+    }
+    fragShaderModule_ = context.CreateShaderModule("shader/" + fragShaderName + ".frag.spv");
 
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -290,13 +582,23 @@ void Renderer::CreateGraphicsPipeline()
     fragShaderStageInfo.pName = "main";
 
     std::vector<VkPipelineShaderStageCreateInfo> shaderStages = {vertShaderStageInfo, fragShaderStageInfo};
-    auto vertexBindingDescription = Vertex::GetBindingDescription();
+    std::vector<VkVertexInputBindingDescription> vertexBindingDescriptions = {
+        Vertex::GetBindingDescription(),
+        InstanceBatch::GetBindingDescription()
+    };
     auto vertexAttributeDescriptions = Vertex::GetAttributeDescriptions();
+    auto instanceAttributeDescriptions = InstanceBatch::GetAttributeDescriptions();
+    if (config_.vertexPulling) {
+        vertexBindingDescriptions.erase(vertexBindingDescriptions.begin());
+        vertexAttributeDescriptions.clear();
+    }
+    vertexAttributeDescriptions.insert(vertexAttributeDescriptions.end(), instanceAttributeDescriptions.begin(),
+        instanceAttributeDescriptions.end());
 
     VkPipelineVertexInputStateCreateInfo vertexInputStateInfo{};
     vertexInputStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputStateInfo.vertexBindingDescriptionCount = 1;
-    vertexInputStateInfo.pVertexBindingDescriptions = &vertexBindingDescription;
+    vertexInputStateInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexBindingDescriptions.size());
+    vertexInputStateInfo.pVertexBindingDescriptions = vertexBindingDescriptions.data();
     vertexInputStateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributeDescriptions.size());
     vertexInputStateInfo.pVertexAttributeDescriptions = vertexAttributeDescriptions.data();
 
@@ -342,8 +644,8 @@ void Renderer::CreateGraphicsPipeline()
     VkPipelineDepthStencilStateCreateInfo depthStencilStateInfo{};
     depthStencilStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depthStencilStateInfo.depthTestEnable = VK_TRUE;
-    depthStencilStateInfo.depthWriteEnable = VK_TRUE;
-    depthStencilStateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencilStateInfo.depthWriteEnable = config_.depthPrepass ? VK_FALSE : VK_TRUE;
+    depthStencilStateInfo.depthCompareOp = config_.depthPrepass ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS;
     depthStencilStateInfo.depthBoundsTestEnable = VK_FALSE;
     depthStencilStateInfo.stencilTestEnable = VK_FALSE;
 
@@ -364,10 +666,29 @@ void Renderer::CreateGraphicsPipeline()
     dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
     dynamicStateInfo.pDynamicStates = dynamicStates.data();
 
+    std::vector<VkDescriptorSetLayout> setLayouts = {descriptorSetLayout_};
+    std::vector<VkPushConstantRange> pushConstantRanges;
+    if (bindlessTextures_) {
+        setLayouts.push_back(bindlessTextures_->GetDescriptorSetLayout());
+        pushConstantRanges.push_back({VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uint32_t)});
+    }
+    if (config_.vertexPulling) {
+        pushConstantRanges.push_back({VK_SHADER_STAGE_VERTEX_BIT, PULLED_VERTEX_CONSTANTS_OFFSET,
+            sizeof(PulledVertexConstants)});
+    }
+
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout_;
+    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+    if (clusteredLighting_) {
+        setLayouts.push_back(clusteredLighting_->GetDescriptorSetLayout());
+    }
+    if (shadowMaps_) {
+        setLayouts.push_back(shadowMaps_->GetDescriptorSetLayout());
+    }
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
     VULKAN_CHECK(vkCreatePipelineLayout(device_, &pipelineLayoutInfo, nullptr, &pipelineLayout_));
 
     VkGraphicsPipelineCreateInfo createInfo{};
@@ -383,125 +704,95 @@ void Renderer::CreateGraphicsPipeline()
     createInfo.pColorBlendState = &colorBlendStateInfo;
     createInfo.pDynamicState = &dynamicStateInfo;
     createInfo.layout = pipelineLayout_;
-    createInfo.renderPass = renderPass_;
+    createInfo.renderPass = renderGraph_->GetRenderPass(scenePass_);
     createInfo.subpass = 0;
     VULKAN_CHECK(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &createInfo, nullptr, &graphicsPipeline_));
 
     vkDestroyShaderModule(device_, fragShaderModule_, nullptr);
     vkDestroyShaderModule(device_, vertShaderModule_, nullptr);
-}
 
-std::vector<char> Renderer::ReadFile(const std::string& path)
-{
-    std::ifstream file(path, std::ios::ate | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << path << std::endl;
-        exit(EXIT_FAILURE);
+    if (!config_.depthPrepass) {
+        return;
     }
 
-    auto size = static_cast<size_t>(file.tellg());
-    std::vector<char> buffer(size);
-    file.seekg(0);
-    file.read(buffer.data(), size);
-    file.close();
+    depthShaderModule_ = context.CreateShaderModule(config_.vertexPulling ? "shader/depth_pulled.vert.spv" :
+        "shader/depth.vert.spv");
+    vertShaderStageInfo.module = depthShaderModule_;
+
+    if (!config_.vertexPulling) {
+        vertexBindingDescriptions[0] = Vertex::GetPositionBindingDescription();
+        vertexAttributeDescriptions = Vertex::GetPositionAttributeDescriptions();
+        vertexAttributeDescriptions.insert(vertexAttributeDescriptions.end(), instanceAttributeDescriptions.begin(),
+            instanceAttributeDescriptions.end());
+        vertexInputStateInfo.pVertexBindingDescriptions = vertexBindingDescriptions.data();
+        vertexInputStateInfo.vertexAttributeDescriptionCount =
+            static_cast<uint32_t>(vertexAttributeDescriptions.size());
+        vertexInputStateInfo.pVertexAttributeDescriptions = vertexAttributeDescriptions.data();
+    }
 
-    return buffer;
-}
+    depthStencilStateInfo.depthWriteEnable = VK_TRUE;
+    depthStencilStateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
 
-VkShaderModule Renderer::CreateShaderModule(const std::vector<char>& code)
-{
-    VkShaderModuleCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    createInfo.stageCount = 1;
+    createInfo.pStages = &vertShaderStageInfo;
+    createInfo.pColorBlendState = nullptr;
+    createInfo.renderPass = renderGraph_->GetRenderPass(depthPrepassPass_);
+    VULKAN_CHECK(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &createInfo, nullptr, &depthPipeline_));
 
-    VkShaderModule shaderModule;
-    VULKAN_CHECK(vkCreateShaderModule(device_, &createInfo, nullptr, &shaderModule));
-    return shaderModule;
+    vkDestroyShaderModule(device_, depthShaderModule_, nullptr);
 }
 
-void Renderer::CreateSwapchainFramebuffers()
+void Renderer::CreateFrameResources()
 {
-    swapchainFramebuffers_.resize(swapchainImageViews_.size());
-    for (uint32_t i = 0; i < swapchainImageViews_.size(); i++) {
-        std::vector<VkImageView> attachments = {swapchainImageViews_[i], swapchainDepthImageView_};
-
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = renderPass_;
-        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        framebufferInfo.pAttachments = attachments.data();
-        framebufferInfo.width = swapchainImageExtent_.width;
-        framebufferInfo.height = swapchainImageExtent_.height;
-        framebufferInfo.layers = 1;
-        VULKAN_CHECK(vkCreateFramebuffer(device_, &framebufferInfo, nullptr, &swapchainFramebuffers_[i]));
+    VkDeviceSize instanceSize = 0;
+    for (const auto& instanceBatch : instanceBatches_) {
+        instanceSize += sizeof(glm::mat4) * instanceBatch->GetInstanceCount();
     }
-}
-
-void Renderer::CreateCommandBuffers()
-{
-    commandBuffers_.resize(swapchainFramebuffers_.size());
-
-    VkCommandBufferAllocateInfo allocateInfo{};
-    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocateInfo.commandPool = commandPool_;
-    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocateInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers_.size());
-    VULKAN_CHECK(vkAllocateCommandBuffers(device_, &allocateInfo, commandBuffers_.data()));
-}
-
-void Renderer::CreateUniformBuffers()
-{
-    VkDeviceSize bufferSize = sizeof(UniformBufferObject);
-    uniformBuffers_.resize(swapchainImages_.size());
-    uniformAllocations_.resize(swapchainImages_.size());
-
-    for (uint32_t i = 0; i < swapchainImages_.size(); i++) {
-        VulkanContext::Instance().CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT, uniformBuffers_[i], uniformAllocations_[i]);
+    if (config_.cullingMode == CullingMode::Cpu) {
+        instanceSize *= 2;
     }
-}
+    frameScheduler_ = std::make_unique<FrameScheduler>(config_.framesInFlight, sizeof(UniformBufferObject),
+        std::max(UPLOAD_BUFFER_SIZE, instanceSize));
+    descriptorAllocator_ = std::make_unique<DescriptorAllocator>(config_.framesInFlight);
+    CreateDescriptorSets();
 
-void Renderer::CreateDescriptorPool()
-{
-    std::vector<VkDescriptorPoolSize> poolSizes(2);
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = static_cast<uint32_t>(swapchainImages_.size());
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = static_cast<uint32_t>(swapchainImages_.size());
+    gpuTimer_ = std::make_unique<GpuTimer>(config_.framesInFlight);
+    if (benchmark_) {
+        renderGraph_->EnableTimestamps(config_.framesInFlight);
+    }
+    if (config_.cullingMode == CullingMode::Gpu || config_.cullingMode == CullingMode::GpuOcclusion) {
+        auto occlusion = config_.cullingMode == CullingMode::GpuOcclusion;
+        gpuCuller_ = std::make_unique<GpuCuller>(static_cast<uint32_t>(instanceBatches_.size()), occlusion);
+        if (occlusion) {
+            hiZPyramid_ = std::make_unique<HiZPyramid>(swapchainImageExtent_.width, swapchainImageExtent_.height);
+        }
+    }
+    if (config_.recordThreads > 0) {
+        commandRecorder_ = std::make_unique<ParallelCommandRecorder>(*threadPool_, config_.framesInFlight,
+            MIN_DRAW_RANGES_PER_TASK);
+    }
 
-    VkDescriptorPoolCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    createInfo.pPoolSizes = poolSizes.data();
-    createInfo.maxSets = static_cast<uint32_t>(swapchainImages_.size());
-    VULKAN_CHECK(vkCreateDescriptorPool(device_, &createInfo, nullptr, &descriptorPool_));
+    if (benchmark_) {
+        benchmark_->SetFramesInFlight(config_.framesInFlight, frameScheduler_->UsesTimelineSemaphore());
+    }
 }
 
 void Renderer::CreateDescriptorSets()
 {
-    std::vector<VkDescriptorSetLayout> layouts(swapchainImages_.size(), descriptorSetLayout_);
-
-    VkDescriptorSetAllocateInfo allocateInfo{};
-    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocateInfo.descriptorPool = descriptorPool_;
-    allocateInfo.descriptorSetCount = static_cast<uint32_t>(swapchainImages_.size());
-    allocateInfo.pSetLayouts = layouts.data();
-    descriptorSets_.resize(swapchainImages_.size());
-    VULKAN_CHECK(vkAllocateDescriptorSets(device_, &allocateInfo, descriptorSets_.data()));
+    materialDescriptorSets_.assign(config_.framesInFlight, {});
+    for (uint32_t i = 0; i < config_.framesInFlight; i++) {
+        auto& frame = frameScheduler_->GetFrame(i);
 
-    for (uint32_t i = 0; i < swapchainImages_.size(); i++) {
         VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = uniformBuffers_[i];
-        bufferInfo.offset = 0;
+        bufferInfo.buffer = frameScheduler_->GetUniformBuffer();
+        bufferInfo.offset = frame.uniformOffset;
         bufferInfo.range = sizeof(UniformBufferObject);
 
-        auto imageInfo = mesh_->GetTextureInfo();
+        auto imageInfo = meshes_[0]->GetTextureInfo();
 
         std::vector<VkWriteDescriptorSet> writeDescriptorSets(2);
 
         writeDescriptorSets[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeDescriptorSets[0].dstSet = descriptorSets_[i];
         writeDescriptorSets[0].dstBinding = 0;
         writeDescriptorSets[0].dstArrayElement = 0;
         writeDescriptorSets[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -509,61 +800,365 @@ void Renderer::CreateDescriptorSets()
         writeDescriptorSets[0].pBufferInfo = &bufferInfo;
 
         writeDescriptorSets[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeDescriptorSets[1].dstSet = descriptorSets_[i];
         writeDescriptorSets[1].dstBinding = 1;
         writeDescriptorSets[1].dstArrayElement = 0;
         writeDescriptorSets[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         writeDescriptorSets[1].descriptorCount = 1;
         writeDescriptorSets[1].pImageInfo = &imageInfo;
 
-        vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(),
-            0, nullptr);
+        VkDescriptorBufferInfo vertexPoolInfo{};
+        vertexPoolInfo.buffer = vertexPool_;
+        vertexPoolInfo.offset = 0;
+        vertexPoolInfo.range = vertexPoolSize_;
+        if (config_.vertexPulling) {
+            VkWriteDescriptorSet vertexPoolWrite{};
+            vertexPoolWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            vertexPoolWrite.dstBinding = 2;
+            vertexPoolWrite.dstArrayElement = 0;
+            vertexPoolWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            vertexPoolWrite.descriptorCount = 1;
+            vertexPoolWrite.pBufferInfo = &vertexPoolInfo;
+            writeDescriptorSets.push_back(vertexPoolWrite);
+        }
+
+        frame.descriptorSet = descriptorAllocator_->GetCached(descriptorSetLayout_, writeDescriptorSets);
+        if (bindlessTextures_) {
+            continue;
+        }
+        for (const auto& instanceBatch : instanceBatches_) {
+            imageInfo = instanceBatch->GetMesh()->GetTextureInfo();
+            materialDescriptorSets_[i].push_back(descriptorAllocator_->GetCached(descriptorSetLayout_,
+                writeDescriptorSets));
+        }
     }
 }
 
-void Renderer::CreateSyncObjects()
+void Renderer::DestroyFrameResources()
+{
+    commandRecorder_.reset();
+    hiZPyramid_.reset();
+    gpuCuller_.reset();
+    gpuTimer_.reset();
+    descriptorAllocator_.reset();
+    frameScheduler_.reset();
+}
+
+void Renderer::RecreateFrameResources(uint32_t framesInFlight)
 {
-    imageAvailableSemaphores_.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores_.resize(MAX_FRAMES_IN_FLIGHT);
-    inFlightFences_.resize(MAX_FRAMES_IN_FLIGHT);
+    PROFILE_SCOPE("RecreateFrameResources");
 
-    VkSemaphoreCreateInfo semaphoreInfo{};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    vkDeviceWaitIdle(device_);
+    for (uint32_t i = 0; i < frameScheduler_->GetFramesInFlight(); i++) {
+        CollectGpuTimings(i);
+    }
+    CollectLatency(std::numeric_limits<uint64_t>::max());
+    deletionQueue_.Flush();
+    if (frameCapture_) {
+        frameCapture_->Flush(frameIndex_);
+    }
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    DestroyFrameResources();
+    config_.framesInFlight = framesInFlight;
+    CreateFrameResources();
+}
 
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        VULKAN_CHECK(vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &imageAvailableSemaphores_[i]));
-        VULKAN_CHECK(vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &renderFinishedSemaphores_[i]));
-        VULKAN_CHECK(vkCreateFence(device_, &fenceInfo, nullptr, &inFlightFences_[i]));
+void Renderer::CreateFrameCapture()
+{
+    if (!config_.IsCaptureEnabled()) {
+        return;
     }
+
+    FrameCapture::Sink sink;
+    if (!config_.capturePngDirectory.empty()) {
+        auto pngSink = std::make_shared<PngWriterSink>(config_.capturePngDirectory, MAX_QUEUED_CAPTURE_FRAMES);
+        sink = [pngSink](CapturedFrame&& frame) {
+            pngSink->Consume(std::move(frame));
+        };
+    } else if (!config_.capturePipeCommand.empty()) {
+        auto pipeSink = std::make_shared<PipeSink>(config_.capturePipeCommand, MAX_QUEUED_CAPTURE_FRAMES);
+        sink = [pipeSink](CapturedFrame&& frame) {
+            pipeSink->Consume(std::move(frame));
+        };
+    } else {
+        auto rawSink = std::make_shared<RawFileSink>(config_.captureRawPath, MAX_QUEUED_CAPTURE_FRAMES);
+        sink = [rawSink](CapturedFrame&& frame) {
+            rawSink->Consume(std::move(frame));
+        };
+    }
+
+    frameCapture_ = std::make_unique<FrameCapture>(config_.captureSlots, std::move(sink));
+    frameCapture_->Resize(swapchainImageExtent_.width, swapchainImageExtent_.height, swapchainImageFormat_);
 }
 
 void Renderer::InitScene()
 {
-    mesh_ = std::make_shared<Mesh>("model/marry/Marry.obj", "model/marry/MC003_Kozakura_Mari.png");
+    PROFILE_SCOPE("InitScene");
+
+    auto workerCount = config_.recordThreads > 0 ? config_.recordThreads :
+        std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    threadPool_ = std::make_unique<ThreadPool>(workerCount);
+    if (config_.cullingMode == CullingMode::Cpu) {
+        frustumCuller_ = std::make_unique<FrustumCuller>(threadPool_.get());
+    }
+
+    TangentSpaceGenerator tangentSpaceGenerator(threadPool_.get());
+
+    std::vector<ModelDraw> draws;
+    ModelStats modelStats;
+    if (std::filesystem::path(config_.modelPath).extension() == ".glb") {
+        GltfModel model(config_.modelPath, tangentSpaceGenerator);
+        meshes_ = model.GetMeshes();
+        draws = model.GetDraws();
+        modelStats = model.GetStats();
+    } else {
+        meshes_.push_back(std::make_shared<Mesh>(config_.modelPath, config_.texturePath, tangentSpaceGenerator));
+        draws.push_back({0, glm::mat4(1.0f)});
+        modelStats = {1, 1, 1, 0};
+    }
+    tangentSpaceStats_ = tangentSpaceGenerator.GetStats();
+    if (draws.empty()) {
+        std::cerr << "Model has nothing to draw: " << config_.modelPath << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    auto directDraw = draws.size() == 1 && draws[0].transform == glm::mat4(1.0f);
+
+    auto gridSize = config_.sceneGridSize;
+    auto cellCount = gridSize * gridSize;
+    auto offset = 0.5f * static_cast<float>(gridSize - 1);
+    sceneGraph_ = std::make_unique<SceneGraph>(threadPool_.get());
+    sceneGraph_->Reserve(cellCount + gridSize + 2 + (directDraw ? 0 : cellCount * static_cast<uint32_t>(draws.size())));
+    turntableNode_ = sceneGraph_->AddNode(SceneGraph::INVALID_NODE, glm::mat4(1.0f));
+    auto gridNode = sceneGraph_->AddNode(SceneGraph::INVALID_NODE, glm::mat4(1.0f));
+
+    std::vector<uint32_t> meshDraws(meshes_.size(), 0), meshBatches(meshes_.size(), UINT32_MAX);
+    for (const auto& draw : draws) {
+        meshDraws[draw.mesh]++;
+    }
+    std::vector<std::shared_ptr<Mesh>> drawnMeshes;
+    for (uint32_t i = 0; i < meshes_.size(); i++) {
+        if (meshDraws[i] > 0) {
+            meshBatches[i] = static_cast<uint32_t>(instanceBatches_.size());
+            instanceBatches_.push_back(std::make_unique<InstanceBatch>(meshes_[i], cellCount * meshDraws[i]));
+            drawnMeshes.push_back(meshes_[i]);
+        }
+    }
+    meshes_ = std::move(drawnMeshes);
+
+    auto addInstance = [this](uint32_t node, uint32_t batch) {
+        auto instance = instanceBatches_[batch]->AddInstance(sceneGraph_->GetWorldTransform(node));
+        sceneInstances_.resize(node + 1);
+        sceneInstances_[node] = {batch, instance};
+    };
+    for (uint32_t i = 0; i < gridSize; i++) {
+        auto rowNode = sceneGraph_->AddNode(gridNode,
+            glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i) - offset, 0.0f, 0.0f)));
+        for (uint32_t j = 0; j < gridSize; j++) {
+            auto node = sceneGraph_->AddNode(rowNode,
+                glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, static_cast<float>(j) - offset, 0.0f)));
+            if (directDraw) {
+                addInstance(node, meshBatches[draws[0].mesh]);
+            } else {
+                for (const auto& draw : draws) {
+                    addInstance(sceneGraph_->AddNode(node, draw.transform), meshBatches[draw.mesh]);
+                }
+            }
+            instanceNodes_.push_back(node);
+        }
+    }
+    InitLights();
+
+    if (config_.benchmark) {
+        benchmark_ = std::make_unique<Benchmark>(config_.warmupFrames, config_.measuredFrames, config_.fixedTimestep);
+        benchmark_->SetModelStats(modelStats.meshes, modelStats.primitives, modelStats.draws,
+            modelStats.mappedBytes);
+        cameraPath_ = CameraPath::Orbit(glm::vec3(0.0f, 0.0f, 0.5f), 3.0f, 1.5f, 10.0f, 8);
+    }
+}
+
+void Renderer::InitLights()
+{
+    if (!config_.IsClusteredLightingEnabled()) {
+        return;
+    }
+
+    std::mt19937 generator(42);
+    auto extent = 0.5f * static_cast<float>(config_.sceneGridSize) + 0.5f;
+    std::uniform_real_distribution<float> horizontal(-extent, extent);
+    std::uniform_real_distribution<float> vertical(0.1f, 1.5f);
+    std::uniform_real_distribution<float> range(0.5f, 1.5f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    lights_.reserve(config_.lightCount);
+    lightOrigins_.reserve(config_.lightCount);
+    for (uint32_t i = 0; i < config_.lightCount; i++) {
+        glm::vec3 position(horizontal(generator), horizontal(generator), vertical(generator));
+        glm::vec3 color(unit(generator), unit(generator), unit(generator));
+        color /= std::max(std::max(color.r, color.g), std::max(color.b, 0.1f));
+        if (i % 4 == 3) {
+            glm::vec3 direction(horizontal(generator), horizontal(generator), -2.0f);
+            lights_.push_back(Light::CreateSpot(position, range(generator), color, 4.0f, direction,
+                glm::radians(20.0f), glm::radians(35.0f)));
+        } else {
+            lights_.push_back(Light::CreatePoint(position, range(generator), color, 2.0f));
+        }
+        lightOrigins_.push_back(position);
+    }
 }
 
 void Renderer::MainLoop()
 {
-    while (!glfwWindowShouldClose(window_)) {
-        glfwPollEvents();
+    framePacer_ = std::make_unique<FramePacer>(config_.latencyMode, config_.frameRateCap);
+    startTime_ = std::chrono::steady_clock::now();
+    while (!ShouldClose()) {
+        if (!config_.headless && requestedFramesInFlight_ != config_.framesInFlight) {
+            RecreateFrameResources(requestedFramesInFlight_);
+        }
+
+        ApplyResizeStorm();
+        framePacer_->WaitForNextFrame();
+        if (config_.latencyMode != LatencyMode::LowLatency) {
+            SampleInput();
+        }
+
+        auto frameIndex = frameIndex_;
+        auto frameStart = std::chrono::steady_clock::now();
         DrawFrame();
+        auto frameEnd = std::chrono::steady_clock::now();
+        if (frameIndex_ > frameIndex && !startupTimer_.HasFirstFrame()) {
+            startupTimer_.MarkFirstFrame(frameStart, frameEnd);
+            if (benchmark_) {
+                benchmark_->SetStartup(startupTimer_.GetTimeToFirstFrame(), startupTimer_.GetPhases());
+            }
+        }
+        if (benchmark_ && frameIndex_ > frameIndex) {
+            benchmark_->AddCpuSample(frameIndex,
+                std::chrono::duration<double, std::milli>(frameEnd - frameStart).count(), drawCount_);
+            if (frustumCuller_) {
+                const auto& stats = frustumCuller_->GetStats();
+                benchmark_->AddCullSample(frameIndex, stats.milliseconds, stats.tested, stats.visible);
+            }
+            if (shadowMaps_) {
+                const auto& stats = shadowMaps_->GetStats();
+                std::vector<uint32_t> cascadeDraws(stats.staticDraws.size());
+                for (size_t i = 0; i < cascadeDraws.size(); i++) {
+                    cascadeDraws[i] = stats.staticDraws[i] + stats.dynamicDraws[i];
+                }
+                benchmark_->AddShadowSample(frameIndex, cascadeDraws, stats.cacheHits);
+            }
+        }
     }
 
     vkDeviceWaitIdle(device_);
+    for (uint32_t i = 0; i < frameScheduler_->GetFramesInFlight(); i++) {
+        CollectGpuTimings(i);
+    }
+    CollectLatency(std::numeric_limits<uint64_t>::max());
+    deletionQueue_.Flush();
+    startupTimer_.PrintStats();
+    TangentSpaceGenerator::PrintStats(tangentSpaceStats_);
+    framePacer_->PrintStats();
+    descriptorAllocator_->PrintStats();
+    renderGraph_->PrintStats();
+    if (resolutionController_) {
+        resolutionController_->PrintStats();
+    }
+    if (clusteredLighting_) {
+        clusteredLighting_->PrintStats();
+    }
+    if (shadowMaps_) {
+        shadowMaps_->PrintStats();
+    }
+    if (frameCapture_) {
+        frameCapture_->Flush(frameIndex_);
+        frameCapture_->PrintStats();
+    }
+}
+
+bool Renderer::ShouldClose() const
+{
+    if (config_.frameCount > 0 && frameIndex_ >= config_.frameCount) {
+        return true;
+    }
+    return !config_.headless && glfwWindowShouldClose(window_);
+}
+
+void Renderer::ApplyResizeStorm()
+{
+    static const std::vector<float> RESIZE_SCALES = {0.5f, 0.75f, 1.0f, 0.625f};
+
+    if (config_.resizeInterval == 0 || frameIndex_ == 0 || frameIndex_ == lastResizeFrameIndex_ ||
+        frameIndex_ % config_.resizeInterval != 0) {
+        return;
+    }
+    lastResizeFrameIndex_ = frameIndex_;
+
+    auto scale = RESIZE_SCALES[(frameIndex_ / config_.resizeInterval) % RESIZE_SCALES.size()];
+    auto width = std::max(static_cast<uint32_t>(static_cast<float>(config_.width) * scale), 1u);
+    auto height = std::max(static_cast<uint32_t>(static_cast<float>(config_.height) * scale), 1u);
+    if (config_.headless) {
+        width_ = width;
+        height_ = height;
+        RecreateSwapchain();
+    } else {
+        glfwSetWindowSize(window_, static_cast<int>(width), static_cast<int>(height));
+    }
+}
+
+void Renderer::SampleInput()
+{
+    if (!config_.headless) {
+        glfwPollEvents();
+    }
+    if (config_.fixedTimestep <= 0.0f) {
+        simulationTime_ = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime_).count();
+    }
+    framePacer_->MarkInput();
 }
 
 void Renderer::DrawFrame()
 {
-    vkWaitForFences(device_, 1, &inFlightFences_[currentFrame_], VK_TRUE, std::numeric_limits<uint64_t>::max());
-    vkResetFences(device_, 1, &inFlightFences_[currentFrame_]);
+    PROFILE_SCOPE("DrawFrame");
+
+    auto& frame = frameScheduler_->BeginFrame();
+    auto frameSlot = frameScheduler_->GetFrameSlot();
+    auto completedFrame = frameScheduler_->GetCompletedFrame();
+    CollectGpuTimings(frameSlot);
+    CollectLatency(completedFrame);
+    deletionQueue_.Collect(completedFrame);
+    descriptorAllocator_->ResetFrame(frameSlot);
+    if (frameCapture_) {
+        frameCapture_->Poll(completedFrame, frameIndex_);
+    }
+    if (commandRecorder_) {
+        commandRecorder_->ResetFrame(frameSlot);
+    }
+
+    if (config_.latencyMode == LatencyMode::LowLatency) {
+        framePacer_->DelayInput(frameScheduler_->GetFrameNumber() - 1 - completedFrame);
+        SampleInput();
+    }
+
+    if (config_.headless) {
+        auto imageIndex = frameSlot;
+        AnimateScene();
+        UpdateUniformBuffer(frame);
+        RecordCommandBuffer(frame, imageIndex);
+        frameScheduler_->Submit(graphicsQueue_, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+        framePacer_->MarkSubmit(frameIndex_, frameScheduler_->GetFrameNumber());
+        frameScheduler_->EndFrame();
+
+        lastImageIndex_ = imageIndex;
+        frameIndex_++;
+        AdvanceSimulation();
+        return;
+    }
 
     uint32_t imageIndex;
-    auto acquireResult = vkAcquireNextImageKHR(device_, swapchain_, std::numeric_limits<uint64_t>::max(),
-        imageAvailableSemaphores_[currentFrame_], VK_NULL_HANDLE, &imageIndex);
+    VkResult acquireResult;
+    {
+        PROFILE_SCOPE("AcquireNextImage");
+        acquireResult = vkAcquireNextImageKHR(device_, swapchain_, std::numeric_limits<uint64_t>::max(),
+            frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    }
 
     if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
         RecreateSwapchain();
@@ -573,32 +1168,28 @@ void Renderer::DrawFrame()
         exit(EXIT_FAILURE);
     }
 
-    UpdateUniformBuffer(imageIndex);
-    vkResetCommandBuffer(commandBuffers_[imageIndex], 0);
-    RecordCommandBuffer(commandBuffers_[imageIndex], imageIndex);
-
-    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &imageAvailableSemaphores_[currentFrame_];
-    submitInfo.pWaitDstStageMask = &waitStage;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffers_[imageIndex];
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &renderFinishedSemaphores_[currentFrame_];
-    VULKAN_CHECK(vkQueueSubmit(graphicsQueue_, 1, &submitInfo, inFlightFences_[currentFrame_]));
+    AnimateScene();
+    UpdateUniformBuffer(frame);
+    RecordCommandBuffer(frame, imageIndex);
+    frameScheduler_->Submit(graphicsQueue_, frame.imageAvailableSemaphore,
+        resolutionController_ ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        frame.renderFinishedSemaphore);
+    framePacer_->MarkSubmit(frameIndex_, frameScheduler_->GetFrameNumber());
+    frameScheduler_->EndFrame();
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = &renderFinishedSemaphores_[currentFrame_];
+    presentInfo.pWaitSemaphores = &frame.renderFinishedSemaphore;
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &swapchain_;
     presentInfo.pImageIndices = &imageIndex;
 
-    auto presentResult = vkQueuePresentKHR(presentQueue_, &presentInfo);
+    VkResult presentResult;
+    {
+        PROFILE_SCOPE("QueuePresent");
+        presentResult = vkQueuePresentKHR(presentQueue_, &presentInfo);
+    }
     if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || framebufferResized_) {
         framebufferResized_ = false;
         RecreateSwapchain();
@@ -607,133 +1198,398 @@ void Renderer::DrawFrame()
         exit(EXIT_FAILURE);
     }
 
-    currentFrame_ = (currentFrame_ + 1) % MAX_FRAMES_IN_FLIGHT;
+    lastImageIndex_ = imageIndex;
+    frameIndex_++;
+    AdvanceSimulation();
+}
+
+void Renderer::AdvanceSimulation()
+{
+    if (config_.fixedTimestep > 0.0f) {
+        simulationTime_ += config_.fixedTimestep;
+    }
+}
+
+void Renderer::AnimateScene()
+{
+    PROFILE_SCOPE("AnimateScene");
+
+    sceneGraph_->SetLocalTransform(turntableNode_,
+        glm::rotate(glm::mat4(1.0f), simulationTime_ * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+
+    auto nodeCount = static_cast<uint32_t>(instanceNodes_.size());
+    auto updateCount = std::min(config_.instanceUpdates, nodeCount);
+    for (uint32_t i = 0; i < updateCount; i++) {
+        auto index = (instanceUpdateCursor_ + i) % nodeCount;
+        auto node = instanceNodes_[index];
+        auto transform = sceneGraph_->GetLocalTransform(node);
+        transform[3][2] = 0.1f * std::sin(simulationTime_ * 4.0f + static_cast<float>(index));
+        sceneGraph_->SetLocalTransform(node, transform);
+    }
+    instanceUpdateCursor_ += updateCount;
+
+    for (uint32_t i = 0; i < lights_.size(); i++) {
+        auto phase = simulationTime_ * 0.5f + static_cast<float>(i);
+        auto position = lightOrigins_[i] + 0.25f * glm::vec3(std::cos(phase), std::sin(phase), 0.0f);
+        lights_[i].positionRange = glm::vec4(position, lights_[i].positionRange.w);
+    }
+
+    sceneGraph_->Update();
+    for (auto node : sceneGraph_->GetChangedNodes()) {
+        if (node < sceneInstances_.size() && sceneInstances_[node].batch != UINT32_MAX) {
+            const auto& sceneInstance = sceneInstances_[node];
+            instanceBatches_[sceneInstance.batch]->SetTransform(sceneInstance.instance,
+                sceneGraph_->GetWorldTransform(node));
+            if (shadowMaps_) {
+                shadowMaps_->MarkDynamic(sceneInstance.batch, sceneInstance.instance);
+            }
+        }
+    }
+}
+
+void Renderer::CollectGpuTimings(uint32_t slot)
+{
+    uint32_t frameIndex;
+    double milliseconds;
+    if (gpuTimer_->Resolve(slot, frameIndex, milliseconds)) {
+        framePacer_->AddGpuTime(milliseconds);
+        if (resolutionController_) {
+            resolutionController_->AddGpuTime(milliseconds);
+        }
+        if (benchmark_) {
+            benchmark_->AddGpuSample(frameIndex, milliseconds);
+        }
+    }
+
+    std::vector<double> passMilliseconds;
+    if (renderGraph_->ResolveTimestamps(slot, frameIndex, passMilliseconds) && benchmark_) {
+        for (uint32_t i = 0; i < passMilliseconds.size(); i++) {
+            if (!renderGraph_->IsPassCulled(i)) {
+                benchmark_->AddPassSample(frameIndex, renderGraph_->GetPassName(i), passMilliseconds[i]);
+            }
+        }
+    }
+
+    LightCullStats stats;
+    if (clusteredLighting_ && clusteredLighting_->Resolve(slot, frameIndex, stats) && benchmark_) {
+        benchmark_->AddLightCullSample(frameIndex, stats.milliseconds, stats.lightCount, stats.clusterCount,
+            stats.occupiedClusters, stats.assignedLights);
+    }
+}
+
+void Renderer::CollectLatency(uint64_t completedFrame)
+{
+    framePacer_->ResolveLatency(completedFrame, [this](uint32_t frameIndex, double milliseconds) {
+        if (benchmark_) {
+            benchmark_->AddLatencySample(frameIndex, milliseconds);
+        }
+    });
 }
 
 void Renderer::RecreateSwapchain()
 {
-    int32_t width = 0, height = 0;
-    while (width == 0 || height == 0) {
+    PROFILE_SCOPE("RecreateSwapchain");
+
+    if (!config_.headless) {
+        int32_t width = 0, height = 0;
         glfwGetFramebufferSize(window_, &width, &height);
-        glfwWaitEvents();
+        while (width == 0 || height == 0) {
+            glfwWaitEvents();
+            glfwGetFramebufferSize(window_, &width, &height);
+        }
     }
 
-    vkDeviceWaitIdle(device_);
+    auto recreateStart = std::chrono::steady_clock::now();
 
-    CleanupSwapchain();
+    RetireSwapchain();
 
     CreateSwapchain();
     CreateSwapchainImageViews();
-    CreateSwapchainDepthResources();
-    CreateSwapchainFramebuffers();
-}
+    renderGraph_->Compile(swapchainImageExtent_, deletionQueue_, frameScheduler_->GetFrameNumber() - 1);
 
-void Renderer::CleanupSwapchain()
-{
-    for (auto framebuffer : swapchainFramebuffers_) {
-        vkDestroyFramebuffer(device_, framebuffer, nullptr);
+    if (hiZPyramid_) {
+        hiZPyramid_->Resize(swapchainImageExtent_.width, swapchainImageExtent_.height, deletionQueue_,
+            frameScheduler_->GetFrameNumber() - 1);
+    }
+    if (frameCapture_) {
+        frameCapture_->Resize(swapchainImageExtent_.width, swapchainImageExtent_.height, swapchainImageFormat_);
     }
 
-    vkDestroyImageView(device_, swapchainDepthImageView_, nullptr);
-    vmaDestroyImage(allocator_, swapchainDepthImage_, swapchainDepthAllocation_);
-
-    for (auto imageView : swapchainImageViews_) {
-        vkDestroyImageView(device_, imageView, nullptr);
+    if (benchmark_) {
+        benchmark_->AddResizeSample(frameIndex_, std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - recreateStart).count());
     }
+}
 
-    vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+void Renderer::RetireSwapchain()
+{
+    deletionQueue_.Push(frameScheduler_->GetFrameNumber() - 1,
+        [this, swapchain = swapchain_, images = swapchainImages_, allocations = offscreenAllocations_,
+            imageViews = swapchainImageViews_]() {
+            for (auto imageView : imageViews) {
+                vkDestroyImageView(device_, imageView, nullptr);
+            }
+
+            if (config_.headless) {
+                for (uint32_t i = 0; i < images.size(); i++) {
+                    vmaDestroyImage(allocator_, images[i], allocations[i]);
+                }
+            } else {
+                vkDestroySwapchainKHR(device_, swapchain, nullptr);
+            }
+        }
+    );
 }
 
-void Renderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+void Renderer::RecordCommandBuffer(const FrameResources& frame, uint32_t imageIndex)
 {
+    PROFILE_SCOPE("RecordCommandBuffer");
+
+    auto commandBuffer = frame.commandBuffer;
+    auto frameSlot = frameScheduler_->GetFrameSlot();
+
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     VULKAN_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
 
-    std::vector<VkClearValue> clearValues(2);
-    clearValues[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
-    clearValues[1].depthStencil = {1.0f, 0};
+    gpuTimer_->Begin(commandBuffer, frameSlot, frameIndex_);
+
+    renderExtent_ = resolutionController_ ? resolutionController_->GetRenderExtent(swapchainImageExtent_) :
+        swapchainImageExtent_;
+
+    renderGraph_->BindImage(swapchainResource_, swapchainImages_[imageIndex], swapchainImageViews_[imageIndex],
+        VK_IMAGE_LAYOUT_UNDEFINED);
+    for (auto pass : {depthPrepassPass_, scenePass_, lateDepthPrepassPass_, lateScenePass_}) {
+        if (pass != UINT32_MAX) {
+            renderGraph_->SetRenderArea(pass, renderExtent_);
+        }
+    }
+    renderGraph_->Execute(commandBuffer, frameSlot, frameIndex_);
+
+    gpuTimer_->End(commandBuffer, frameSlot);
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass_;
-    renderPassInfo.framebuffer = swapchainFramebuffers_[imageIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = swapchainImageExtent_;
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+    VULKAN_CHECK(vkEndCommandBuffer(commandBuffer));
+}
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+void Renderer::BlitSceneColor(VkCommandBuffer commandBuffer)
+{
+    VkImageBlit blit{};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[1] = {static_cast<int32_t>(renderExtent_.width), static_cast<int32_t>(renderExtent_.height), 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[1] = {static_cast<int32_t>(swapchainImageExtent_.width),
+        static_cast<int32_t>(swapchainImageExtent_.height), 1};
+    vkCmdBlitImage(commandBuffer, renderGraph_->GetImage(sceneColorResource_), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        renderGraph_->GetImage(swapchainResource_), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+        VK_FILTER_LINEAR);
+}
 
+void Renderer::CullInstances()
+{
+    frustumCuller_->BeginFrame(viewProjection_);
+    for (const auto& instanceBatch : instanceBatches_) {
+        frustumCuller_->Cull(instanceBatch->GetBounds(), visibleInstances_);
+        instanceBatch->UploadVisible(*frameScheduler_, visibleInstances_);
+    }
+}
+
+void Renderer::BuildDrawRanges()
+{
+    drawRanges_.clear();
+    for (uint32_t i = 0; i < instanceBatches_.size(); i++) {
+        if (gpuCuller_) {
+            drawRanges_.push_back({i});
+            continue;
+        }
+        auto instanceCount = instanceBatches_[i]->GetDrawInstanceCount();
+        for (uint32_t first = 0; first < instanceCount; first += INSTANCES_PER_DRAW_RANGE) {
+            drawRanges_.push_back({i, first, std::min(INSTANCES_PER_DRAW_RANGE, instanceCount - first)});
+        }
+    }
+}
+
+void Renderer::RecordInstanceBatches(VkCommandBuffer commandBuffer, uint32_t frameSlot, uint32_t begin, uint32_t end,
+    CullPhase phase)
+{
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline_);
+    SetViewportAndScissor(commandBuffer);
+
+    auto descriptorSet = frameScheduler_->GetFrame(frameSlot).descriptorSet;
+    std::vector<VkDescriptorSet> descriptorSets = {descriptorSet};
+    if (bindlessTextures_) {
+        descriptorSets.push_back(bindlessTextures_->GetDescriptorSet());
+    }
+    if (clusteredLighting_) {
+        descriptorSets.push_back(clusteredLighting_->GetDescriptorSet());
+    }
+    if (shadowMaps_) {
+        descriptorSets.push_back(shadowMaps_->GetDescriptorSet());
+    }
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0,
+        static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+
+    auto stream = config_.vertexPulling ? VertexStream::Pulled : VertexStream::Full;
+    for (auto i = begin; i < end; i++) {
+        const auto& drawRange = drawRanges_[i];
+        const auto& instanceBatch = *instanceBatches_[drawRange.batch];
+        if (bindlessTextures_) {
+            auto textureIndex = instanceBatch.GetTextureIndex();
+            vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(textureIndex),
+                &textureIndex);
+        } else if (materialDescriptorSets_[frameSlot][drawRange.batch] != descriptorSet) {
+            descriptorSet = materialDescriptorSets_[frameSlot][drawRange.batch];
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, 1,
+                &descriptorSet, 0, nullptr);
+        }
+        if (config_.vertexPulling) {
+            PushPulledVertexConstants(commandBuffer, instanceBatch);
+        }
+        if (gpuCuller_) {
+            gpuCuller_->Draw(commandBuffer, drawRange.batch, instanceBatch, phase, stream);
+        } else {
+            instanceBatch.Draw(commandBuffer, stream, drawRange.firstInstance, drawRange.instanceCount);
+        }
+    }
+}
 
+void Renderer::RecordDepthPrepass(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet, CullPhase phase)
+{
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, depthPipeline_);
+    SetViewportAndScissor(commandBuffer);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, 1, &descriptorSet, 0,
+        nullptr);
+
+    auto stream = config_.vertexPulling ? VertexStream::Pulled : VertexStream::Position;
+    for (uint32_t i = 0; i < instanceBatches_.size(); i++) {
+        if (config_.vertexPulling) {
+            PushPulledVertexConstants(commandBuffer, *instanceBatches_[i]);
+        }
+        if (gpuCuller_) {
+            gpuCuller_->Draw(commandBuffer, i, *instanceBatches_[i], phase, stream);
+        } else {
+            instanceBatches_[i]->Draw(commandBuffer, stream);
+        }
+    }
+}
+
+void Renderer::PushPulledVertexConstants(VkCommandBuffer commandBuffer, const InstanceBatch& instanceBatch)
+{
+    auto constants = instanceBatch.GetMesh()->GetPulledVertexConstants();
+    vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT, PULLED_VERTEX_CONSTANTS_OFFSET,
+        sizeof(constants), &constants);
+}
+
+void Renderer::SetViewportAndScissor(VkCommandBuffer commandBuffer)
+{
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
-    viewport.width = static_cast<float>(swapchainImageExtent_.width);
-    viewport.height = static_cast<float>(swapchainImageExtent_.height);
+    viewport.width = static_cast<float>(renderExtent_.width);
+    viewport.height = static_cast<float>(renderExtent_.height);
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
     VkRect2D scissor{};
     scissor.offset = {0, 0};
-    scissor.extent = swapchainImageExtent_;
+    scissor.extent = renderExtent_;
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, 1,
-        &descriptorSets_[imageIndex], 0, nullptr);
-    mesh_->Render(commandBuffer);
-
-    vkCmdEndRenderPass(commandBuffer);
-
-    VULKAN_CHECK(vkEndCommandBuffer(commandBuffer));
 }
 
-void Renderer::UpdateUniformBuffer(uint32_t currentImage)
+void Renderer::UpdateUniformBuffer(const FrameResources& frame)
 {
-    static auto startTime = std::chrono::high_resolution_clock::now();
-
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+    PROFILE_SCOPE("UpdateUniformBuffer");
 
     UniformBufferObject ubo{};
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    ubo.model = sceneGraph_->GetWorldTransform(turntableNode_);
+    if (cameraPath_.IsEmpty()) {
+        ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f),
+            glm::vec3(0.0f, 0.0f, 1.0f));
+    } else {
+        ubo.view = cameraPath_.Evaluate(simulationTime_);
+    }
     ubo.proj = glm::perspective(glm::radians(45.0f),
         static_cast<float>(swapchainImageExtent_.width) / static_cast<float>(swapchainImageExtent_.height),
-        0.1f, 10.0f);
+        NEAR_PLANE, FAR_PLANE);
     ubo.proj[1][1] *= -1;
+    viewProjection_ = ubo.proj * ubo.view * ubo.model;
+    cameraPosition_ = glm::vec3(glm::inverse(ubo.view)[3]);
+    uniforms_ = ubo;
 
-    void* data;
-    vmaMapMemory(allocator_, uniformAllocations_[currentImage], &data);
-    memcpy(data, &ubo, sizeof(ubo));
-    vmaUnmapMemory(allocator_, uniformAllocations_[currentImage]);
+    memcpy(frame.uniformData, &ubo, sizeof(ubo));
+    frameScheduler_->FlushUniforms(frame);
 }
 
-void Renderer::Cleanup()
+std::vector<uint8_t> Renderer::ReadbackImage(uint32_t imageIndex)
 {
-    CleanupSwapchain();
+    PROFILE_SCOPE("ReadbackImage");
 
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        vkDestroyFence(device_, inFlightFences_[i], nullptr);
-        vkDestroySemaphore(device_, renderFinishedSemaphores_[i], nullptr);
-        vkDestroySemaphore(device_, imageAvailableSemaphores_[i], nullptr);
-    }
+    vkDeviceWaitIdle(device_);
 
-    vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+    VkDeviceSize size = static_cast<VkDeviceSize>(swapchainImageExtent_.width) * swapchainImageExtent_.height * 4;
+    VkBuffer readbackBuffer;
+    VmaAllocation readbackAllocation;
+    VulkanContext::Instance().CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT, readbackBuffer, readbackAllocation);
+    VulkanContext::Instance().CopyImageToBuffer(swapchainImages_[imageIndex], readbackBuffer,
+        swapchainImageExtent_.width, swapchainImageExtent_.height);
 
-    for (uint32_t i = 0; i < swapchainImages_.size(); i++) {
-        vmaDestroyBuffer(allocator_, uniformBuffers_[i], uniformAllocations_[i]);
+    std::vector<uint8_t> pixels(static_cast<size_t>(size));
+    void* data;
+    vmaMapMemory(allocator_, readbackAllocation, &data);
+    vmaInvalidateAllocation(allocator_, readbackAllocation, 0, VK_WHOLE_SIZE);
+    memcpy(pixels.data(), data, pixels.size());
+    vmaUnmapMemory(allocator_, readbackAllocation);
+
+    vmaDestroyBuffer(allocator_, readbackBuffer, readbackAllocation);
+    return pixels;
+}
+
+void Renderer::WriteImage(const std::string& path, const std::vector<uint8_t>& pixels)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        exit(EXIT_FAILURE);
     }
 
+    file << "P6\n" << swapchainImageExtent_.width << " " << swapchainImageExtent_.height << "\n255\n";
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        file.write(reinterpret_cast<const char*>(&pixels[i]), 3);
+    }
+}
+
+void Renderer::Cleanup()
+{
+    RetireSwapchain();
+    deletionQueue_.Flush();
+    instanceBatches_.clear();
+
+    DestroyFrameResources();
+    sceneGraph_.reset();
+    frustumCuller_.reset();
+    threadPool_.reset();
+    frameCapture_.reset();
+
+    if (depthPipeline_ != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device_, depthPipeline_, nullptr);
+    }
     vkDestroyPipeline(device_, graphicsPipeline_, nullptr);
     vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
 
     vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+    if (vertexPool_ != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(allocator_, vertexPool_, vertexPoolAllocation_);
+    }
+    bindlessTextures_.reset();
+    clusteredLighting_.reset();
+    shadowMaps_.reset();
 
-    vkDestroyRenderPass(device_, renderPass_, nullptr);
+    renderGraph_.reset();
 
-    glfwDestroyWindow(window_);
-    glfwTerminate();
+    if (!config_.headless) {
+        glfwDestroyWindow(window_);
+        glfwTerminate();
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -8,7 +9,31 @@
 
 #include <GLFW/glfw3.h>
 
+#include "Benchmark.hpp"
+#include "BindlessTextures.hpp"
+#include "CameraPath.hpp"
+#include "CascadedShadowMaps.hpp"
+#include "ClusteredLighting.hpp"
+#include "DeletionQueue.hpp"
+#include "DescriptorAllocator.hpp"
+#include "FrameCapture.hpp"
+#include "FramePacer.hpp"
+#include "FrameScheduler.hpp"
+#include "FrustumCuller.hpp"
+#include "GpuCuller.hpp"
+#include "GltfModel.hpp"
+#include "GpuTimer.hpp"
+#include "HiZPyramid.hpp"
+#include "InstanceBatch.hpp"
 #include "Mesh.hpp"
+#include "ParallelCommandRecorder.hpp"
+#include "RenderGraph.hpp"
+#include "RendererConfig.hpp"
+#include "ResolutionController.hpp"
+#include "SceneGraph.hpp"
+#include "StartupTimer.hpp"
+#include "TangentSpace.hpp"
+#include "ThreadPool.hpp"
 #include "Vertex.hpp"
 #include "VulkanContext.hpp"
 
@@ -16,75 +41,148 @@ struct UniformBufferObject {
     glm::mat4 model, view, proj;
 };
 
+struct SceneInstance {
+    uint32_t batch = UINT32_MAX, instance = 0;
+};
+
+struct DrawRange {
+    uint32_t batch = 0, firstInstance = 0, instanceCount = UINT32_MAX;
+};
+
 class Renderer {
 public:
-    Renderer(uint32_t width, uint32_t height);
+    Renderer(const RendererConfig& config);
     ~Renderer();
     void Run();
+    BenchmarkResult GetBenchmarkResult() const;
 
 private:
-    const uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+    const VkDeviceSize UPLOAD_BUFFER_SIZE = 16 << 20;
+    const uint32_t MAX_BINDLESS_TEXTURES = 4096;
+    const uint32_t MAX_QUEUED_CAPTURE_FRAMES = 8;
+    const uint32_t PULLED_VERTEX_CONSTANTS_OFFSET = 16;
+    const uint32_t INSTANCES_PER_DRAW_RANGE = 256;
+    const uint32_t MIN_DRAW_RANGES_PER_TASK = 2;
+    const float NEAR_PLANE = 0.1f;
+    const float FAR_PLANE = 10.0f;
 
-    std::shared_ptr<Mesh> mesh_;
+    RendererConfig config_;
+    std::vector<std::shared_ptr<Mesh>> meshes_;
+    VkBuffer vertexPool_ = VK_NULL_HANDLE;
+    VmaAllocation vertexPoolAllocation_ = VK_NULL_HANDLE;
+    VkDeviceSize vertexPoolSize_ = 0;
+    std::vector<std::unique_ptr<InstanceBatch>> instanceBatches_;
+    std::unique_ptr<SceneGraph> sceneGraph_;
+    std::vector<SceneInstance> sceneInstances_;
+    std::vector<uint32_t> instanceNodes_;
+    uint32_t turntableNode_;
+    uint32_t instanceUpdateCursor_ = 0;
+    std::vector<Light> lights_;
+    std::vector<glm::vec3> lightOrigins_;
     uint32_t width_, height_;
-    GLFWwindow* window_;
+    GLFWwindow* window_ = nullptr;
     VkInstance instance_;
     VkSurfaceKHR surface_;
     VkDevice device_;
     VkQueue graphicsQueue_, presentQueue_;
     VmaAllocator allocator_;
-    VkCommandPool commandPool_;
-    VkSwapchainKHR swapchain_;
+    VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
     VkFormat swapchainImageFormat_;
     VkExtent2D swapchainImageExtent_;
     std::vector<VkImage> swapchainImages_;
+    std::vector<VmaAllocation> offscreenAllocations_;
     std::vector<VkImageView> swapchainImageViews_;
-    VkImage swapchainDepthImage_;
-    VmaAllocation swapchainDepthAllocation_;
-    VkImageView swapchainDepthImageView_;
-    VkRenderPass renderPass_;
-    VkShaderModule vertShaderModule_, fragShaderModule_;
+    VkExtent2D renderExtent_;
+    std::unique_ptr<RenderGraph> renderGraph_;
+    uint32_t swapchainResource_, depthResource_, sceneColorResource_ = UINT32_MAX;
+    uint32_t scenePass_, lateScenePass_ = UINT32_MAX;
+    uint32_t depthPrepassPass_ = UINT32_MAX, lateDepthPrepassPass_ = UINT32_MAX;
+    VkShaderModule vertShaderModule_, fragShaderModule_, depthShaderModule_;
     VkDescriptorSetLayout descriptorSetLayout_;
     VkPipelineLayout pipelineLayout_;
-    VkPipeline graphicsPipeline_;
-    std::vector<VkFramebuffer> swapchainFramebuffers_;
-    std::vector<VkCommandBuffer> commandBuffers_;
-    std::vector<VkBuffer> uniformBuffers_;
-    std::vector<VmaAllocation> uniformAllocations_;
-    VkDescriptorPool descriptorPool_;
-    std::vector<VkDescriptorSet> descriptorSets_;
-    std::vector<VkSemaphore> imageAvailableSemaphores_, renderFinishedSemaphores_;
-    std::vector<VkFence> inFlightFences_;
-    uint32_t currentFrame_ = 0;
+    VkPipeline graphicsPipeline_, depthPipeline_ = VK_NULL_HANDLE;
+    std::unique_ptr<DescriptorAllocator> descriptorAllocator_;
+    std::unique_ptr<FrameScheduler> frameScheduler_;
+    DeletionQueue deletionQueue_;
+    uint32_t requestedFramesInFlight_;
+    uint32_t frameIndex_ = 0;
+    uint32_t lastImageIndex_ = 0;
+    uint32_t lastResizeFrameIndex_ = 0;
+    uint32_t drawCount_ = 0;
+    float simulationTime_ = 0.0f;
+    UniformBufferObject uniforms_;
+    glm::mat4 viewProjection_;
+    glm::vec3 cameraPosition_;
+    std::chrono::steady_clock::time_point startTime_;
+    CameraPath cameraPath_;
+    std::unique_ptr<GpuTimer> gpuTimer_;
+    std::unique_ptr<GpuCuller> gpuCuller_;
+    std::unique_ptr<HiZPyramid> hiZPyramid_;
+    std::unique_ptr<BindlessTextures> bindlessTextures_;
+    std::unique_ptr<ClusteredLighting> clusteredLighting_;
+    std::unique_ptr<CascadedShadowMaps> shadowMaps_;
+    std::unique_ptr<FrustumCuller> frustumCuller_;
+    std::vector<uint32_t> visibleInstances_;
+    std::vector<DrawRange> drawRanges_;
+    std::vector<std::vector<VkDescriptorSet>> materialDescriptorSets_;
+    std::unique_ptr<Benchmark> benchmark_;
+    std::unique_ptr<FrameCapture> frameCapture_;
+    std::unique_ptr<FramePacer> framePacer_;
+    std::unique_ptr<ResolutionController> resolutionController_;
+    std::unique_ptr<ThreadPool> threadPool_;
+    std::unique_ptr<ParallelCommandRecorder> commandRecorder_;
+    StartupTimer startupTimer_;
+    TangentSpaceStats tangentSpaceStats_;
     bool framebufferResized_ = false;
 
     void InitWindow();
     static void FramebufferResizeCallback(GLFWwindow* window, int width, int height);
+    static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    void InitDevice();
     void InitVulkan();
     void CreateSwapchain();
+    void CreateOffscreenTargets();
     VkExtent2D ChooseSwapchainExtent(const VkSurfaceCapabilitiesKHR& capabilities);
     VkSurfaceFormatKHR ChooseSwapchainFormat(const std::vector<VkSurfaceFormatKHR>& formats);
     VkPresentModeKHR ChooseSwapchainPresentMode(const std::vector<VkPresentModeKHR>& presentModes);
     void CreateSwapchainImageViews();
-    void CreateSwapchainDepthResources();
-    void CreateRenderPass();
+    void CreateVertexPool();
     void CreateDescriptorSetLayout();
+    void CreateBindlessTextures();
+    void CreateClusteredLighting();
+    void CreateShadowMaps();
+    void CreateRenderGraph();
     void CreateGraphicsPipeline();
-    static std::vector<char> ReadFile(const std::string& fileName);
-    VkShaderModule CreateShaderModule(const std::vector<char>& code);
-    void CreateSwapchainFramebuffers();
-    void CreateCommandBuffers();
-    void CreateUniformBuffers();
-    void CreateDescriptorPool();
+    void CreateFrameResources();
     void CreateDescriptorSets();
-    void CreateSyncObjects();
+    void DestroyFrameResources();
+    void RecreateFrameResources(uint32_t framesInFlight);
+    void CreateFrameCapture();
     void InitScene();
+    void InitLights();
     void MainLoop();
+    bool ShouldClose() const;
+    void ApplyResizeStorm();
+    void SampleInput();
     void DrawFrame();
+    void AdvanceSimulation();
+    void AnimateScene();
+    void BlitSceneColor(VkCommandBuffer commandBuffer);
+    void CullInstances();
+    void BuildDrawRanges();
+    void CollectGpuTimings(uint32_t slot);
+    void CollectLatency(uint64_t completedFrame);
     void RecreateSwapchain();
-    void CleanupSwapchain();
-    void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
-    void UpdateUniformBuffer(uint32_t currentImage);
+    void RetireSwapchain();
+    void RecordCommandBuffer(const FrameResources& frame, uint32_t imageIndex);
+    void RecordInstanceBatches(VkCommandBuffer commandBuffer, uint32_t frameSlot, uint32_t begin, uint32_t end,
+        CullPhase phase);
+    void RecordDepthPrepass(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet, CullPhase phase);
+    void PushPulledVertexConstants(VkCommandBuffer commandBuffer, const InstanceBatch& instanceBatch);
+    void SetViewportAndScissor(VkCommandBuffer commandBuffer);
+    void UpdateUniformBuffer(const FrameResources& frame);
+    std::vector<uint8_t> ReadbackImage(uint32_t imageIndex);
+    void WriteImage(const std::string& path, const std::vector<uint8_t>& pixels);
     void Cleanup();
 };
 
@@ -0,0 +1,172 @@
+#include "RendererConfig.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+template <typename T>
+T ParseNumber(const std::string& arg, const std::string& value)
+{
+    T result{};
+    auto end = value.data() + value.size();
+    auto [parsed, error] = std::from_chars(value.data(), end, result);
+    if (value.empty() || error != std::errc() || parsed != end || !std::isfinite(static_cast<double>(result))) {
+        std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return result;
+}
+
+}
+
+void RendererConfig::ParseArguments(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for argument: " << arg << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            return argv[++i];
+        };
+        auto nextUint = [&]() {
+            return ParseNumber<uint32_t>(arg, next());
+        };
+        auto nextFloat = [&]() {
+            return ParseNumber<float>(arg, next());
+        };
+
+        if (arg == "--width") {
+            width = nextUint();
+        } else if (arg == "--height") {
+            height = nextUint();
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--windowed") {
+            headless = false;
+        } else if (arg == "--model") {
+            modelPath = next();
+        } else if (arg == "--texture") {
+            texturePath = next();
+        } else if (arg == "--grid") {
+            sceneGridSize = std::max(nextUint(), 1u);
+        } else if (arg == "--instance-updates") {
+            instanceUpdates = nextUint();
+        } else if (arg == "--culling") {
+            auto mode = next();
+            if (mode == "none") {
+                cullingMode = CullingMode::None;
+            } else if (mode == "cpu") {
+                cullingMode = CullingMode::Cpu;
+            } else if (mode == "gpu") {
+                cullingMode = CullingMode::Gpu;
+            } else if (mode == "gpu-occlusion") {
+                cullingMode = CullingMode::GpuOcclusion;
+            } else {
+                std::cerr << "Unknown culling mode: " << mode << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        } else if (arg == "--bindless") {
+            bindless = true;
+        } else if (arg == "--lights") {
+            lightCount = nextUint();
+        } else if (arg == "--shadows") {
+            shadows = true;
+        } else if (arg == "--shadow-resolution") {
+            shadowResolution = std::clamp(nextUint(), 256u, 8192u);
+        } else if (arg == "--depth-prepass") {
+            depthPrepass = true;
+        } else if (arg == "--vertex-pulling") {
+            vertexPulling = true;
+        } else if (arg == "--render-scale") {
+            renderScale = std::clamp(nextFloat(), 0.1f, 1.0f);
+        } else if (arg == "--min-render-scale") {
+            minRenderScale = std::clamp(nextFloat(), 0.1f, 1.0f);
+        } else if (arg == "--resolution-budget") {
+            resolutionBudgetMs = std::max(nextFloat(), 0.0f);
+        } else if (arg == "--record-threads") {
+            recordThreads = nextUint();
+        } else if (arg == "--frames-in-flight") {
+            framesInFlight = std::clamp(nextUint(), 1u, MAX_FRAMES_IN_FLIGHT);
+        } else if (arg == "--latency-mode") {
+            auto mode = next();
+            if (mode == "throughput") {
+                latencyMode = LatencyMode::Throughput;
+            } else if (mode == "vsync") {
+                latencyMode = LatencyMode::Vsync;
+            } else if (mode == "low-latency") {
+                latencyMode = LatencyMode::LowLatency;
+            } else {
+                std::cerr << "Unknown latency mode: " << mode << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        } else if (arg == "--fps-cap") {
+            frameRateCap = std::max(nextFloat(), 0.0f);
+        } else if (arg == "--resize-storm") {
+            resizeInterval = nextUint();
+        } else if (arg == "--frames") {
+            frameCount = nextUint();
+        } else if (arg == "--timestep") {
+            fixedTimestep = nextFloat();
+        } else if (arg == "--benchmark") {
+            benchmark = true;
+        } else if (arg == "--warmup") {
+            warmupFrames = nextUint();
+        } else if (arg == "--measure") {
+            measuredFrames = nextUint();
+        } else if (arg == "--report") {
+            reportPath = next();
+        } else if (arg == "--budget") {
+            budgetMs = ParseNumber<double>(arg, next());
+        } else if (arg == "--tangent-benchmark") {
+            tangentBenchmarkGrid = std::max(nextUint(), 1u);
+        } else if (arg == "--output") {
+            outputPath = next();
+        } else if (arg == "--capture-raw") {
+            captureRawPath = next();
+        } else if (arg == "--capture-png") {
+            capturePngDirectory = next();
+        } else if (arg == "--capture-pipe") {
+            capturePipeCommand = next();
+        } else if (arg == "--capture-slots") {
+            captureSlots = std::max(nextUint(), 1u);
+        } else if (arg == "--trace") {
+            tracePath = next();
+        } else if (arg == "--shader-dir") {
+            shaderDirectory = next();
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (benchmark) {
+        frameCount = warmupFrames + measuredFrames;
+        if (fixedTimestep <= 0.0f) {
+            fixedTimestep = 1.0f / 60.0f;
+        }
+    }
+    if (headless && frameCount == 0) {
+        frameCount = 1;
+    }
+}
+
+bool RendererConfig::IsDynamicResolutionEnabled() const
+{
+    return renderScale < 1.0f || resolutionBudgetMs > 0.0f;
+}
+
+bool RendererConfig::IsClusteredLightingEnabled() const
+{
+    return lightCount > 0;
+}
+
+bool RendererConfig::IsCaptureEnabled() const
+{
+    return !captureRawPath.empty() || !capturePngDirectory.empty() || !capturePipeCommand.empty();
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef RENDERER_CONFIG_HPP
+#define RENDERER_CONFIG_HPP
+
+#include <cstdint>
+#include <string>
+
+enum class CullingMode {
+    None,
+    Cpu,
+    Gpu,
+    GpuOcclusion
+};
+
+enum class LatencyMode {
+    Throughput,
+    Vsync,
+    LowLatency
+};
+
+struct RendererConfig {
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 8;
+
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    bool headless = false;
+    std::string modelPath = "model/marry/Marry.obj";
+    std::string texturePath = "model/marry/MC003_Kozakura_Mari.png";
+    uint32_t sceneGridSize = 1;
+    uint32_t instanceUpdates = 0;
+    CullingMode cullingMode = CullingMode::None;
+    bool bindless = false;
+    uint32_t lightCount = 0;
+    bool shadows = false;
+    uint32_t shadowResolution = 2048;
+    bool depthPrepass = false;
+    bool vertexPulling = false;
+    float renderScale = 1.0f;
+    float minRenderScale = 0.5f;
+    float resolutionBudgetMs = 0.0f;
+    uint32_t recordThreads = 0;
+    uint32_t framesInFlight = 2;
+    LatencyMode latencyMode = LatencyMode::Throughput;
+    float frameRateCap = 0.0f;
+    uint32_t resizeInterval = 0;
+    uint32_t frameCount = 0;
+    float fixedTimestep = 0.0f;
+    bool benchmark = false;
+    uint32_t warmupFrames = 60;
+    uint32_t measuredFrames = 600;
+    std::string reportPath;
+    double budgetMs = 0.0;
+    uint32_t tangentBenchmarkGrid = 0;
+    std::string outputPath;
+    std::string captureRawPath;
+    std::string capturePngDirectory;
+    std::string capturePipeCommand;
+    uint32_t captureSlots = 4;
+    std::string tracePath;
+    std::string shaderDirectory;
+
+    void ParseArguments(int argc, char* argv[]);
+    bool IsDynamicResolutionEnabled() const;
+    bool IsClusteredLightingEnabled() const;
+    bool IsCaptureEnabled() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "ResolutionController.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+ResolutionController::ResolutionController(float budgetMs, float initialScale, float minScale, float maxScale) :
+    budgetMs_(budgetMs),
+    scale_(std::clamp(initialScale, minScale, maxScale)),
+    minScale_(minScale),
+    maxScale_(maxScale),
+    lowestScale_(scale_),
+    highestScale_(scale_) {}
+
+void ResolutionController::AddGpuTime(double milliseconds)
+{
+    gpuTimeMs_ = sampleCount_ == 0 ? milliseconds : gpuTimeMs_ + (milliseconds - gpuTimeMs_) * SMOOTHING;
+    sampleCount_++;
+    totalScale_ += scale_;
+    framesSinceChange_++;
+
+    if (budgetMs_ <= 0.0 || gpuTimeMs_ <= 0.0 || framesSinceChange_ < COOLDOWN_FRAMES) {
+        return;
+    }
+
+    auto ratio = budgetMs_ * BUDGET_HEADROOM / gpuTimeMs_;
+    if (std::abs(ratio - 1.0) < HYSTERESIS) {
+        return;
+    }
+
+    auto scale = static_cast<float>(scale_ * std::sqrt(ratio));
+    scale = std::clamp(scale, scale_ - MAX_SCALE_STEP, scale_ + MAX_SCALE_STEP);
+    scale = std::clamp(scale, minScale_, maxScale_);
+    if (scale == scale_) {
+        return;
+    }
+
+    gpuTimeMs_ *= (scale * scale) / (scale_ * scale_);
+    scale_ = scale;
+    framesSinceChange_ = 0;
+    adjustmentCount_++;
+    lowestScale_ = std::min(lowestScale_, scale_);
+    highestScale_ = std::max(highestScale_, scale_);
+}
+
+float ResolutionController::GetScale() const
+{
+    return scale_;
+}
+
+VkExtent2D ResolutionController::GetRenderExtent(VkExtent2D targetExtent) const
+{
+    return {std::max(static_cast<uint32_t>(std::lround(targetExtent.width * scale_)), 1u),
+        std::max(static_cast<uint32_t>(std::lround(targetExtent.height * scale_)), 1u)};
+}
+
+void ResolutionController::PrintStats() const
+{
+    if (sampleCount_ == 0) {
+        return;
+    }
+
+    std::cout << "Render scale: mean " << totalScale_ / sampleCount_ << ", min " << lowestScale_ << ", max "
+        << highestScale_ << ", " << adjustmentCount_ << " adjustments";
+    if (budgetMs_ > 0.0) {
+        std::cout << " (GPU budget " << budgetMs_ << " ms, smoothed GPU time " << gpuTimeMs_ << " ms)";
+    }
+    std::cout << std::endl;
+}
\ No newline at end of file
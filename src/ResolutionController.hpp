@@ -0,0 +1,33 @@
+#ifndef RESOLUTION_CONTROLLER_HPP
+#define RESOLUTION_CONTROLLER_HPP
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+class ResolutionController {
+public:
+    ResolutionController(float budgetMs, float initialScale, float minScale, float maxScale);
+
+    void AddGpuTime(double milliseconds);
+    float GetScale() const;
+    VkExtent2D GetRenderExtent(VkExtent2D targetExtent) const;
+    void PrintStats() const;
+
+private:
+    const double SMOOTHING = 0.1;
+    const double BUDGET_HEADROOM = 0.9;
+    const double HYSTERESIS = 0.05;
+    const float MAX_SCALE_STEP = 0.1f;
+    const uint32_t COOLDOWN_FRAMES = 8;
+
+    double budgetMs_;
+    float scale_, minScale_, maxScale_;
+    double gpuTimeMs_ = 0.0;
+    uint32_t framesSinceChange_ = 0;
+    uint64_t sampleCount_ = 0, adjustmentCount_ = 0;
+    double totalScale_ = 0.0;
+    float lowestScale_, highestScale_;
+};
+
+#endif
\ No newline at end of file
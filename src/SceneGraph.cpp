@@ -0,0 +1,129 @@
+#include "SceneGraph.hpp"
+
+#include <algorithm>
+
+#include "Profiler.hpp"
+
+SceneGraph::SceneGraph(ThreadPool* threadPool) :
+    threadPool_(threadPool) {}
+
+void SceneGraph::Reserve(uint32_t nodeCount)
+{
+    parents_.reserve(nodeCount);
+    firstChildren_.reserve(nodeCount);
+    nextSiblings_.reserve(nodeCount);
+    depths_.reserve(nodeCount);
+    localTransforms_.reserve(nodeCount);
+    worldTransforms_.reserve(nodeCount);
+    dirty_.reserve(nodeCount);
+    dirtyNodes_.reserve(nodeCount);
+}
+
+uint32_t SceneGraph::AddNode(uint32_t parent, const glm::mat4& localTransform)
+{
+    auto node = GetNodeCount();
+    parents_.push_back(parent);
+    firstChildren_.push_back(INVALID_NODE);
+    if (parent == INVALID_NODE) {
+        nextSiblings_.push_back(INVALID_NODE);
+        depths_.push_back(0);
+    } else {
+        nextSiblings_.push_back(firstChildren_[parent]);
+        firstChildren_[parent] = node;
+        depths_.push_back(depths_[parent] + 1);
+    }
+    localTransforms_.push_back(localTransform);
+    worldTransforms_.push_back(parent == INVALID_NODE ? localTransform : worldTransforms_[parent] * localTransform);
+    dirty_.push_back(0);
+    return node;
+}
+
+uint32_t SceneGraph::GetNodeCount() const
+{
+    return static_cast<uint32_t>(parents_.size());
+}
+
+uint32_t SceneGraph::GetParent(uint32_t node) const
+{
+    return parents_[node];
+}
+
+const glm::mat4& SceneGraph::GetLocalTransform(uint32_t node) const
+{
+    return localTransforms_[node];
+}
+
+const glm::mat4& SceneGraph::GetWorldTransform(uint32_t node) const
+{
+    return worldTransforms_[node];
+}
+
+void SceneGraph::SetLocalTransform(uint32_t node, const glm::mat4& localTransform)
+{
+    localTransforms_[node] = localTransform;
+    if (!dirty_[node]) {
+        dirty_[node] = 1;
+        dirtyNodes_.push_back(node);
+    }
+}
+
+uint32_t SceneGraph::Update()
+{
+    changedNodes_.clear();
+    if (dirtyNodes_.empty()) {
+        return 0;
+    }
+
+    PROFILE_SCOPE("UpdateSceneGraph");
+
+    for (auto& level : levels_) {
+        level.clear();
+    }
+    pendingNodes_.assign(dirtyNodes_.begin(), dirtyNodes_.end());
+    dirtyNodes_.clear();
+    while (!pendingNodes_.empty()) {
+        auto node = pendingNodes_.back();
+        pendingNodes_.pop_back();
+        if (levels_.size() <= depths_[node]) {
+            levels_.resize(depths_[node] + 1);
+        }
+        levels_[depths_[node]].push_back(node);
+        for (auto child = firstChildren_[node]; child != INVALID_NODE; child = nextSiblings_[child]) {
+            if (!dirty_[child]) {
+                dirty_[child] = 1;
+                pendingNodes_.push_back(child);
+            }
+        }
+    }
+
+    for (const auto& level : levels_) {
+        auto count = static_cast<uint32_t>(level.size());
+        if (threadPool_ == nullptr || count < PARALLEL_CHUNK_SIZE * 2) {
+            UpdateRange(level.data(), count);
+        } else {
+            auto chunkCount = (count + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+            threadPool_->ParallelFor(chunkCount, [this, &level, count](uint32_t chunk, uint32_t) {
+                auto begin = chunk * PARALLEL_CHUNK_SIZE;
+                UpdateRange(level.data() + begin, std::min(PARALLEL_CHUNK_SIZE, count - begin));
+            });
+        }
+        changedNodes_.insert(changedNodes_.end(), level.begin(), level.end());
+    }
+    return static_cast<uint32_t>(changedNodes_.size());
+}
+
+const std::vector<uint32_t>& SceneGraph::GetChangedNodes() const
+{
+    return changedNodes_;
+}
+
+void SceneGraph::UpdateRange(const uint32_t* nodes, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        auto node = nodes[i];
+        auto parent = parents_[node];
+        worldTransforms_[node] = parent == INVALID_NODE ? localTransforms_[node] :
+            worldTransforms_[parent] * localTransforms_[node];
+        dirty_[node] = 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef SCENE_GRAPH_HPP
+#define SCENE_GRAPH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ThreadPool.hpp"
+
+class SceneGraph {
+public:
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    SceneGraph(ThreadPool* threadPool);
+
+    void Reserve(uint32_t nodeCount);
+    uint32_t AddNode(uint32_t parent, const glm::mat4& localTransform);
+    uint32_t GetNodeCount() const;
+    uint32_t GetParent(uint32_t node) const;
+    const glm::mat4& GetLocalTransform(uint32_t node) const;
+    const glm::mat4& GetWorldTransform(uint32_t node) const;
+    void SetLocalTransform(uint32_t node, const glm::mat4& localTransform);
+    uint32_t Update();
+    const std::vector<uint32_t>& GetChangedNodes() const;
+
+private:
+    const uint32_t PARALLEL_CHUNK_SIZE = 4096;
+
+    void UpdateRange(const uint32_t* nodes, uint32_t count);
+
+    ThreadPool* threadPool_;
+    std::vector<uint32_t> parents_;
+    std::vector<uint32_t> firstChildren_;
+    std::vector<uint32_t> nextSiblings_;
+    std::vector<uint32_t> depths_;
+    std::vector<glm::mat4> localTransforms_;
+    std::vector<glm::mat4> worldTransforms_;
+    std::vector<uint8_t> dirty_;
+    std::vector<uint32_t> dirtyNodes_;
+    std::vector<uint32_t> pendingNodes_;
+    std::vector<std::vector<uint32_t>> levels_;
+    std::vector<uint32_t> changedNodes_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "StartupTimer.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+StartupTimer::StartupTimer() :
+    launchTime_(Clock::now()) {}
+
+void StartupTimer::Measure(const std::string& name, const std::function<void()>& stage)
+{
+    auto begin = Clock::now();
+    stage();
+    Record(name, begin, Clock::now());
+}
+
+void StartupTimer::Record(const std::string& name, Clock::time_point begin, Clock::time_point end)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases_.push_back({name, ToMilliseconds(begin), ToMilliseconds(end)});
+}
+
+void StartupTimer::MarkFirstFrame(Clock::time_point begin, Clock::time_point end)
+{
+    Record("FirstFrame", begin, end);
+    std::lock_guard<std::mutex> lock(mutex_);
+    timeToFirstFrameMs_ = ToMilliseconds(end);
+    firstFrame_ = true;
+}
+
+bool StartupTimer::HasFirstFrame() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return firstFrame_;
+}
+
+double StartupTimer::GetTimeToFirstFrame() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timeToFirstFrameMs_;
+}
+
+std::vector<StartupPhase> StartupTimer::GetPhases() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto phases = phases_;
+    std::stable_sort(phases.begin(), phases.end(), [](const StartupPhase& a, const StartupPhase& b) {
+        return a.beginMs < b.beginMs;
+    });
+    return phases;
+}
+
+void StartupTimer::PrintStats() const
+{
+    if (!HasFirstFrame()) {
+        return;
+    }
+
+    std::cout << "Time to first frame: " << GetTimeToFirstFrame() << " ms" << std::endl;
+    for (const auto& phase : GetPhases()) {
+        std::cout << "  " << phase.name << ": " << phase.endMs - phase.beginMs << " ms (" << phase.beginMs << " - "
+            << phase.endMs << " ms)" << std::endl;
+    }
+}
+
+double StartupTimer::ToMilliseconds(Clock::time_point time) const
+{
+    return std::chrono::duration<double, std::milli>(time - launchTime_).count();
+}
\ No newline at end of file
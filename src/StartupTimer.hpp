@@ -0,0 +1,39 @@
+#ifndef STARTUP_TIMER_HPP
+#define STARTUP_TIMER_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct StartupPhase {
+    std::string name;
+    double beginMs, endMs;
+};
+
+class StartupTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    StartupTimer();
+
+    void Measure(const std::string& name, const std::function<void()>& stage);
+    void Record(const std::string& name, Clock::time_point begin, Clock::time_point end);
+    void MarkFirstFrame(Clock::time_point begin, Clock::time_point end);
+    bool HasFirstFrame() const;
+    double GetTimeToFirstFrame() const;
+    std::vector<StartupPhase> GetPhases() const;
+    void PrintStats() const;
+
+private:
+    double ToMilliseconds(Clock::time_point time) const;
+
+    Clock::time_point launchTime_;
+    mutable std::mutex mutex_;
+    std::vector<StartupPhase> phases_;
+    double timeToFirstFrameMs_ = 0.0;
+    bool firstFrame_ = false;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,486 @@
+#include "TangentSpace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "Profiler.hpp"
+
+namespace {
+
+constexpr float MIN_DETERMINANT = 1e-12f;
+constexpr float MIN_LENGTH2 = 1e-20f;
+constexpr uint32_t NORMAL = 0, TANGENT = 3, BITANGENT = 6;
+
+#if defined(__AVX2__)
+#define TANGENT_SPACE_SIMD
+constexpr uint32_t LANES = 8;
+using Lanes = __m256;
+
+Lanes Load(const float* data) { return _mm256_loadu_ps(data); }
+void Store(float* data, Lanes value) { _mm256_storeu_ps(data, value); }
+Lanes Splat(float value) { return _mm256_set1_ps(value); }
+Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+Lanes Div(Lanes a, Lanes b) { return _mm256_div_ps(a, b); }
+Lanes Sqrt(Lanes a) { return _mm256_sqrt_ps(a); }
+Lanes Abs(Lanes a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+Lanes Greater(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+Lanes Less(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b, a, mask); }
+
+Lanes Gather(const float* data, const uint32_t* indices, uint32_t stride)
+{
+    return _mm256_set_ps(data[stride * indices[7]], data[stride * indices[6]], data[stride * indices[5]],
+        data[stride * indices[4]], data[stride * indices[3]], data[stride * indices[2]], data[stride * indices[1]],
+        data[stride * indices[0]]);
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+#define TANGENT_SPACE_SIMD
+constexpr uint32_t LANES = 4;
+using Lanes = __m128;
+
+Lanes Load(const float* data) { return _mm_loadu_ps(data); }
+void Store(float* data, Lanes value) { _mm_storeu_ps(data, value); }
+Lanes Splat(float value) { return _mm_set1_ps(value); }
+Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+Lanes Sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+Lanes Div(Lanes a, Lanes b) { return _mm_div_ps(a, b); }
+Lanes Sqrt(Lanes a) { return _mm_sqrt_ps(a); }
+Lanes Abs(Lanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+Lanes Greater(Lanes a, Lanes b) { return _mm_cmpgt_ps(a, b); }
+Lanes Less(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+Lanes Gather(const float* data, const uint32_t* indices, uint32_t stride)
+{
+    return _mm_set_ps(data[stride * indices[3]], data[stride * indices[2]], data[stride * indices[1]],
+        data[stride * indices[0]]);
+}
+#endif
+
+struct FaceFrame {
+    glm::vec3 normal, tangent, bitangent;
+};
+
+struct CacheHeader {
+    uint32_t magic, version;
+    uint64_t key;
+    uint32_t vertexCount, padding;
+};
+
+FaceFrame ComputeFace(const TangentSpaceInput& input, uint32_t triangle)
+{
+    auto i0 = input.indices[3 * triangle];
+    auto i1 = input.indices[3 * triangle + 1];
+    auto i2 = input.indices[3 * triangle + 2];
+    auto edge1 = input.positions[i1] - input.positions[i0];
+    auto edge2 = input.positions[i2] - input.positions[i0];
+
+    FaceFrame face{glm::cross(edge1, edge2), glm::vec3(0.0f), glm::vec3(0.0f)};
+    if (input.uvs == nullptr) {
+        return face;
+    }
+
+    auto delta1 = input.uvs[i1] - input.uvs[i0];
+    auto delta2 = input.uvs[i2] - input.uvs[i0];
+    auto determinant = delta1.x * delta2.y - delta2.x * delta1.y;
+    if (std::abs(determinant) > MIN_DETERMINANT) {
+        auto scale = 1.0f / determinant;
+        face.tangent = (edge1 * delta2.y - edge2 * delta1.y) * scale;
+        face.bitangent = (edge2 * delta1.x - edge1 * delta2.x) * scale;
+    }
+    return face;
+}
+
+void ResolveVertex(glm::vec3 normal, glm::vec3 tangent, const glm::vec3& bitangent, glm::vec3& resolvedNormal,
+    glm::vec4& resolvedTangent)
+{
+    auto normalLength2 = glm::dot(normal, normal);
+    normal = normalLength2 > MIN_LENGTH2 ? normal * (1.0f / std::sqrt(normalLength2)) : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    tangent -= normal * glm::dot(normal, tangent);
+    if (glm::dot(tangent, tangent) <= MIN_LENGTH2) {
+        tangent = std::abs(normal.x) < 0.9f ? glm::vec3(0.0f, normal.z, -normal.y) :
+            glm::vec3(-normal.z, 0.0f, normal.x);
+    }
+    tangent *= 1.0f / std::sqrt(glm::dot(tangent, tangent));
+
+    resolvedNormal = normal;
+    resolvedTangent = glm::vec4(tangent, glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f);
+}
+
+}
+
+uint64_t TangentSpaceGenerator::GetCacheKey(const std::string& sourcePath, uint32_t meshIndex)
+{
+    std::error_code sizeError, timeError;
+    auto size = std::filesystem::file_size(sourcePath, sizeError);
+    auto time = std::filesystem::last_write_time(sourcePath, timeError);
+    if (sizeError || timeError) {
+        return 0;
+    }
+
+    uint64_t key = 0xcbf29ce484222325ull;
+    auto combine = [&key](uint64_t value) {
+        key ^= value + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+    };
+    combine(static_cast<uint64_t>(size));
+    combine(static_cast<uint64_t>(time.time_since_epoch().count()));
+    combine(meshIndex);
+    combine(CACHE_VERSION);
+    return key;
+}
+
+void TangentSpaceGenerator::GenerateScalar(const TangentSpaceInput& input, std::vector<glm::vec3>& normals,
+    std::vector<glm::vec4>& tangents)
+{
+    std::vector<glm::vec3> normalSums(input.vertexCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> tangentSums(input.vertexCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> bitangentSums(input.vertexCount, glm::vec3(0.0f));
+    for (uint32_t i = 0; i < input.indexCount / 3; i++) {
+        auto face = ComputeFace(input, i);
+        for (uint32_t j = 0; j < 3; j++) {
+            auto index = input.indices[3 * i + j];
+            normalSums[index] += face.normal;
+            tangentSums[index] += face.tangent;
+            bitangentSums[index] += face.bitangent;
+        }
+    }
+
+    normals.resize(input.vertexCount);
+    tangents.resize(input.vertexCount);
+    for (uint32_t i = 0; i < input.vertexCount; i++) {
+        ResolveVertex(input.normals != nullptr ? input.normals[i] : normalSums[i], tangentSums[i], bitangentSums[i],
+            normals[i], tangents[i]);
+    }
+}
+
+TangentSpaceGenerator::TangentSpaceGenerator(ThreadPool* threadPool) :
+    threadPool_(threadPool) {}
+
+void TangentSpaceGenerator::Generate(const TangentSpaceInput& input, std::vector<glm::vec3>& normals,
+    std::vector<glm::vec4>& tangents)
+{
+    PROFILE_SCOPE("GenerateTangentSpace");
+
+    auto start = std::chrono::steady_clock::now();
+    auto triangleCount = input.indexCount / 3;
+    auto parallel = threadPool_ != nullptr && threadPool_->GetThreadCount() > 1 &&
+        triangleCount >= PARALLEL_TRIANGLE_COUNT;
+    auto accumulatorCount = parallel ? threadPool_->GetThreadCount() : 1;
+    if (accumulators_.size() < accumulatorCount) {
+        accumulators_.resize(accumulatorCount);
+    }
+    if (resolveSums_.size() < accumulatorCount) {
+        resolveSums_.resize(accumulatorCount);
+    }
+
+    auto trianglesPerTask = (triangleCount + accumulatorCount - 1) / accumulatorCount;
+    auto accumulate = [this, &input, triangleCount, trianglesPerTask](uint32_t task, uint32_t) {
+        auto firstTriangle = std::min(task * trianglesPerTask, triangleCount);
+        Accumulate(input, firstTriangle, std::min(firstTriangle + trianglesPerTask, triangleCount),
+            accumulators_[task]);
+    };
+
+    normals.resize(input.vertexCount);
+    tangents.resize(input.vertexCount);
+    auto chunkCount = (input.vertexCount + RESOLVE_CHUNK_SIZE - 1) / RESOLVE_CHUNK_SIZE;
+    auto resolve = [this, &input, accumulatorCount, &normals, &tangents](uint32_t chunk, uint32_t threadIndex) {
+        auto begin = chunk * RESOLVE_CHUNK_SIZE;
+        Resolve(input, accumulatorCount, begin, std::min(begin + RESOLVE_CHUNK_SIZE, input.vertexCount),
+            resolveSums_[threadIndex], normals, tangents);
+    };
+
+    if (parallel) {
+        threadPool_->ParallelFor(accumulatorCount, accumulate);
+        threadPool_->ParallelFor(chunkCount, resolve);
+    } else {
+        accumulate(0, 0);
+        for (uint32_t i = 0; i < chunkCount; i++) {
+            resolve(i, 0);
+        }
+    }
+
+    stats_.generatedMeshes++;
+    stats_.vertices += input.vertexCount;
+    stats_.triangles += triangleCount;
+    stats_.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void TangentSpaceGenerator::GenerateCached(const TangentSpaceInput& input, const std::string& cachePath,
+    uint64_t cacheKey, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents)
+{
+    auto cacheable = cacheKey != 0 && !cachePath.empty();
+    auto start = std::chrono::steady_clock::now();
+    if (cacheable && LoadCache(cachePath, cacheKey, input.vertexCount, normals, tangents)) {
+        stats_.cachedMeshes++;
+        stats_.vertices += input.vertexCount;
+        stats_.triangles += input.indexCount / 3;
+        stats_.milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+            start).count();
+        return;
+    }
+
+    Generate(input, normals, tangents);
+    if (cacheable) {
+        SaveCache(cachePath, cacheKey, normals, tangents);
+    }
+}
+
+const TangentSpaceStats& TangentSpaceGenerator::GetStats() const
+{
+    return stats_;
+}
+
+void TangentSpaceGenerator::PrintStats(const TangentSpaceStats& stats)
+{
+    std::cout << "Tangent space: " << stats.generatedMeshes << " generated, " << stats.cachedMeshes << " cached, "
+        << stats.vertices << " vertices, " << stats.triangles << " triangles, " << stats.milliseconds << " ms"
+        << std::endl;
+}
+
+void TangentSpaceGenerator::Accumulate(const TangentSpaceInput& input, uint32_t firstTriangle, uint32_t lastTriangle,
+    Accumulator& accumulator) const
+{
+    accumulator.firstVertex = 0;
+    accumulator.vertexCount = 0;
+    if (firstTriangle >= lastTriangle) {
+        return;
+    }
+
+    if (firstTriangle == 0 && lastTriangle == input.indexCount / 3) {
+        accumulator.vertexCount = input.vertexCount;
+    } else {
+        auto [minIndex, maxIndex] = std::minmax_element(input.indices + 3 * firstTriangle,
+            input.indices + 3 * lastTriangle);
+        accumulator.firstVertex = *minIndex;
+        accumulator.vertexCount = *maxIndex - *minIndex + 1;
+    }
+    accumulator.sums.assign(SUM_COMPONENTS * accumulator.vertexCount, 0.0f);
+
+    auto triangle = firstTriangle;
+#ifdef TANGENT_SPACE_SIMD
+    const auto positions = &input.positions[0].x;
+    const auto uvs = input.uvs != nullptr ? &input.uvs[0].x : nullptr;
+    uint32_t corners[3][LANES];
+    float faces[SUM_COMPONENTS][LANES];
+    for (; triangle + LANES <= lastTriangle; triangle += LANES) {
+        for (uint32_t lane = 0; lane < LANES; lane++) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                corners[corner][lane] = input.indices[3 * (triangle + lane) + corner];
+            }
+        }
+
+        auto x0 = Gather(positions, corners[0], 3);
+        auto y0 = Gather(positions + 1, corners[0], 3);
+        auto z0 = Gather(positions + 2, corners[0], 3);
+        auto edge1X = Sub(Gather(positions, corners[1], 3), x0);
+        auto edge1Y = Sub(Gather(positions + 1, corners[1], 3), y0);
+        auto edge1Z = Sub(Gather(positions + 2, corners[1], 3), z0);
+        auto edge2X = Sub(Gather(positions, corners[2], 3), x0);
+        auto edge2Y = Sub(Gather(positions + 1, corners[2], 3), y0);
+        auto edge2Z = Sub(Gather(positions + 2, corners[2], 3), z0);
+        auto delta1U = Splat(0.0f), delta1V = Splat(0.0f), delta2U = Splat(0.0f), delta2V = Splat(0.0f);
+        if (uvs != nullptr) {
+            auto u0 = Gather(uvs, corners[0], 2);
+            auto v0 = Gather(uvs + 1, corners[0], 2);
+            delta1U = Sub(Gather(uvs, corners[1], 2), u0);
+            delta1V = Sub(Gather(uvs + 1, corners[1], 2), v0);
+            delta2U = Sub(Gather(uvs, corners[2], 2), u0);
+            delta2V = Sub(Gather(uvs + 1, corners[2], 2), v0);
+        }
+
+        Store(faces[NORMAL], Sub(Mul(edge1Y, edge2Z), Mul(edge1Z, edge2Y)));
+        Store(faces[NORMAL + 1], Sub(Mul(edge1Z, edge2X), Mul(edge1X, edge2Z)));
+        Store(faces[NORMAL + 2], Sub(Mul(edge1X, edge2Y), Mul(edge1Y, edge2X)));
+
+        auto determinant = Sub(Mul(delta1U, delta2V), Mul(delta2U, delta1V));
+        auto scale = Select(Greater(Abs(determinant), Splat(MIN_DETERMINANT)), Div(Splat(1.0f), determinant),
+            Splat(0.0f));
+        Store(faces[TANGENT], Mul(Sub(Mul(edge1X, delta2V), Mul(edge2X, delta1V)), scale));
+        Store(faces[TANGENT + 1], Mul(Sub(Mul(edge1Y, delta2V), Mul(edge2Y, delta1V)), scale));
+        Store(faces[TANGENT + 2], Mul(Sub(Mul(edge1Z, delta2V), Mul(edge2Z, delta1V)), scale));
+        Store(faces[BITANGENT], Mul(Sub(Mul(edge2X, delta1U), Mul(edge1X, delta2U)), scale));
+        Store(faces[BITANGENT + 1], Mul(Sub(Mul(edge2Y, delta1U), Mul(edge1Y, delta2U)), scale));
+        Store(faces[BITANGENT + 2], Mul(Sub(Mul(edge2Z, delta1U), Mul(edge1Z, delta2U)), scale));
+
+        for (uint32_t lane = 0; lane < LANES; lane++) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                auto sum = &accumulator.sums[SUM_COMPONENTS * (corners[corner][lane] - accumulator.firstVertex)];
+                for (uint32_t i = 0; i < SUM_COMPONENTS; i++) {
+                    sum[i] += faces[i][lane];
+                }
+            }
+        }
+    }
+#endif
+
+    for (; triangle < lastTriangle; triangle++) {
+        auto face = ComputeFace(input, triangle);
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            auto vertex = input.indices[3 * triangle + corner] - accumulator.firstVertex;
+            auto sum = &accumulator.sums[SUM_COMPONENTS * vertex];
+            for (uint32_t i = 0; i < 3; i++) {
+                sum[NORMAL + i] += face.normal[i];
+                sum[TANGENT + i] += face.tangent[i];
+                sum[BITANGENT + i] += face.bitangent[i];
+            }
+        }
+    }
+}
+
+void TangentSpaceGenerator::Resolve(const TangentSpaceInput& input, uint32_t accumulatorCount, uint32_t begin,
+    uint32_t end, std::vector<float>& sums, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents) const
+{
+    auto count = end - begin;
+    const auto& first = accumulators_[0];
+    if (accumulatorCount == 1 && input.normals == nullptr && first.firstVertex <= begin &&
+        end <= first.firstVertex + first.vertexCount) {
+        ResolveSums(first.sums.data() + SUM_COMPONENTS * (begin - first.firstVertex), begin, end, normals, tangents);
+        return;
+    }
+
+    sums.assign(SUM_COMPONENTS * count, 0.0f);
+    for (uint32_t i = 0; i < accumulatorCount; i++) {
+        const auto& accumulator = accumulators_[i];
+        auto overlapBegin = std::max(begin, accumulator.firstVertex);
+        auto overlapEnd = std::min(end, accumulator.firstVertex + accumulator.vertexCount);
+        if (overlapBegin >= overlapEnd) {
+            continue;
+        }
+
+        auto source = accumulator.sums.data() + SUM_COMPONENTS * (overlapBegin - accumulator.firstVertex);
+        auto target = sums.data() + SUM_COMPONENTS * (overlapBegin - begin);
+        auto overlapCount = SUM_COMPONENTS * (overlapEnd - overlapBegin);
+        uint32_t j = 0;
+#ifdef TANGENT_SPACE_SIMD
+        for (; j + LANES <= overlapCount; j += LANES) {
+            Store(target + j, Add(Load(target + j), Load(source + j)));
+        }
+#endif
+        for (; j < overlapCount; j++) {
+            target[j] += source[j];
+        }
+    }
+    if (input.normals != nullptr) {
+        for (uint32_t i = 0; i < count; i++) {
+            for (uint32_t j = 0; j < 3; j++) {
+                sums[SUM_COMPONENTS * i + NORMAL + j] = input.normals[begin + i][j];
+            }
+        }
+    }
+    ResolveSums(sums.data(), begin, end, normals, tangents);
+}
+
+void TangentSpaceGenerator::ResolveSums(const float* sums, uint32_t begin, uint32_t end,
+    std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents) const
+{
+    auto count = end - begin;
+    uint32_t i = 0;
+#ifdef TANGENT_SPACE_SIMD
+    float lanes[SUM_COMPONENTS][LANES];
+    float resolved[7][LANES];
+    for (; i + LANES <= count; i += LANES) {
+        for (uint32_t lane = 0; lane < LANES; lane++) {
+            for (uint32_t j = 0; j < SUM_COMPONENTS; j++) {
+                lanes[j][lane] = sums[SUM_COMPONENTS * (i + lane) + j];
+            }
+        }
+
+        auto normalX = Load(lanes[NORMAL]);
+        auto normalY = Load(lanes[NORMAL + 1]);
+        auto normalZ = Load(lanes[NORMAL + 2]);
+        auto normalLength2 = Add(Add(Mul(normalX, normalX), Mul(normalY, normalY)), Mul(normalZ, normalZ));
+        auto validNormal = Greater(normalLength2, Splat(MIN_LENGTH2));
+        auto inverseLength = Div(Splat(1.0f), Sqrt(normalLength2));
+        normalX = Select(validNormal, Mul(normalX, inverseLength), Splat(0.0f));
+        normalY = Select(validNormal, Mul(normalY, inverseLength), Splat(0.0f));
+        normalZ = Select(validNormal, Mul(normalZ, inverseLength), Splat(1.0f));
+
+        auto tangentX = Load(lanes[TANGENT]);
+        auto tangentY = Load(lanes[TANGENT + 1]);
+        auto tangentZ = Load(lanes[TANGENT + 2]);
+        auto projection = Add(Add(Mul(normalX, tangentX), Mul(normalY, tangentY)), Mul(normalZ, tangentZ));
+        tangentX = Sub(tangentX, Mul(normalX, projection));
+        tangentY = Sub(tangentY, Mul(normalY, projection));
+        tangentZ = Sub(tangentZ, Mul(normalZ, projection));
+        auto tangentLength2 = Add(Add(Mul(tangentX, tangentX), Mul(tangentY, tangentY)), Mul(tangentZ, tangentZ));
+        auto validTangent = Greater(tangentLength2, Splat(MIN_LENGTH2));
+        auto crossX = Less(Abs(normalX), Splat(0.9f));
+        tangentX = Select(validTangent, tangentX, Select(crossX, Splat(0.0f), Sub(Splat(0.0f), normalZ)));
+        tangentY = Select(validTangent, tangentY, Select(crossX, normalZ, Splat(0.0f)));
+        tangentZ = Select(validTangent, tangentZ, Select(crossX, Sub(Splat(0.0f), normalY), normalX));
+        tangentLength2 = Add(Add(Mul(tangentX, tangentX), Mul(tangentY, tangentY)), Mul(tangentZ, tangentZ));
+        inverseLength = Div(Splat(1.0f), Sqrt(tangentLength2));
+        tangentX = Mul(tangentX, inverseLength);
+        tangentY = Mul(tangentY, inverseLength);
+        tangentZ = Mul(tangentZ, inverseLength);
+
+        auto handedness = Add(Add(
+            Mul(Sub(Mul(normalY, tangentZ), Mul(normalZ, tangentY)), Load(lanes[BITANGENT])),
+            Mul(Sub(Mul(normalZ, tangentX), Mul(normalX, tangentZ)), Load(lanes[BITANGENT + 1]))),
+            Mul(Sub(Mul(normalX, tangentY), Mul(normalY, tangentX)), Load(lanes[BITANGENT + 2])));
+
+        Store(resolved[0], normalX);
+        Store(resolved[1], normalY);
+        Store(resolved[2], normalZ);
+        Store(resolved[3], tangentX);
+        Store(resolved[4], tangentY);
+        Store(resolved[5], tangentZ);
+        Store(resolved[6], Select(Less(handedness, Splat(0.0f)), Splat(-1.0f), Splat(1.0f)));
+        for (uint32_t lane = 0; lane < LANES; lane++) {
+            normals[begin + i + lane] = glm::vec3(resolved[0][lane], resolved[1][lane], resolved[2][lane]);
+            tangents[begin + i + lane] = glm::vec4(resolved[3][lane], resolved[4][lane], resolved[5][lane],
+                resolved[6][lane]);
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        auto sum = &sums[SUM_COMPONENTS * i];
+        ResolveVertex(glm::vec3(sum[NORMAL], sum[NORMAL + 1], sum[NORMAL + 2]),
+            glm::vec3(sum[TANGENT], sum[TANGENT + 1], sum[TANGENT + 2]),
+            glm::vec3(sum[BITANGENT], sum[BITANGENT + 1], sum[BITANGENT + 2]), normals[begin + i], tangents[begin + i]);
+    }
+}
+
+bool TangentSpaceGenerator::LoadCache(const std::string& cachePath, uint64_t cacheKey, uint32_t vertexCount,
+    std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents) const
+{
+    std::ifstream file(cachePath, std::ios::binary);
+    CacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != CACHE_MAGIC ||
+        header.version != CACHE_VERSION || header.key != cacheKey || header.vertexCount != vertexCount) {
+        return false;
+    }
+
+    normals.resize(vertexCount);
+    tangents.resize(vertexCount);
+    file.read(reinterpret_cast<char*>(normals.data()), sizeof(glm::vec3) * vertexCount);
+    file.read(reinterpret_cast<char*>(tangents.data()), sizeof(glm::vec4) * vertexCount);
+    return static_cast<bool>(file);
+}
+
+void TangentSpaceGenerator::SaveCache(const std::string& cachePath, uint64_t cacheKey,
+    const std::vector<glm::vec3>& normals, const std::vector<glm::vec4>& tangents) const
+{
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return;
+    }
+
+    CacheHeader header{CACHE_MAGIC, CACHE_VERSION, cacheKey, static_cast<uint32_t>(normals.size()), 0};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(normals.data()), sizeof(glm::vec3) * normals.size());
+    file.write(reinterpret_cast<const char*>(tangents.data()), sizeof(glm::vec4) * tangents.size());
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef TANGENT_SPACE_HPP
+#define TANGENT_SPACE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ThreadPool.hpp"
+
+struct TangentSpaceInput {
+    const glm::vec3* positions = nullptr;
+    const glm::vec2* uvs = nullptr;
+    const glm::vec3* normals = nullptr;
+    const uint32_t* indices = nullptr;
+    uint32_t vertexCount = 0, indexCount = 0;
+};
+
+struct TangentSpaceStats {
+    uint32_t generatedMeshes = 0, cachedMeshes = 0;
+    uint64_t vertices = 0, triangles = 0;
+    double milliseconds = 0.0;
+};
+
+class TangentSpaceGenerator {
+public:
+    static uint64_t GetCacheKey(const std::string& sourcePath, uint32_t meshIndex);
+    static void GenerateScalar(const TangentSpaceInput& input, std::vector<glm::vec3>& normals,
+        std::vector<glm::vec4>& tangents);
+    static void PrintStats(const TangentSpaceStats& stats);
+
+    TangentSpaceGenerator(ThreadPool* threadPool);
+
+    void Generate(const TangentSpaceInput& input, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents);
+    void GenerateCached(const TangentSpaceInput& input, const std::string& cachePath, uint64_t cacheKey,
+        std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents);
+    const TangentSpaceStats& GetStats() const;
+
+private:
+    static constexpr uint32_t CACHE_MAGIC = 0x43505354;
+    static constexpr uint32_t CACHE_VERSION = 1;
+    static constexpr uint32_t SUM_COMPONENTS = 9;
+    const uint32_t PARALLEL_TRIANGLE_COUNT = 65536;
+    const uint32_t RESOLVE_CHUNK_SIZE = 16384;
+
+    struct Accumulator {
+        uint32_t firstVertex = 0, vertexCount = 0;
+        std::vector<float> sums;
+    };
+
+    void Accumulate(const TangentSpaceInput& input, uint32_t firstTriangle, uint32_t lastTriangle,
+        Accumulator& accumulator) const;
+    void Resolve(const TangentSpaceInput& input, uint32_t accumulatorCount, uint32_t begin, uint32_t end,
+        std::vector<float>& sums, std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents) const;
+    void ResolveSums(const float* sums, uint32_t begin, uint32_t end, std::vector<glm::vec3>& normals,
+        std::vector<glm::vec4>& tangents) const;
+    bool LoadCache(const std::string& cachePath, uint64_t cacheKey, uint32_t vertexCount,
+        std::vector<glm::vec3>& normals, std::vector<glm::vec4>& tangents) const;
+    void SaveCache(const std::string& cachePath, uint64_t cacheKey, const std::vector<glm::vec3>& normals,
+        const std::vector<glm::vec4>& tangents) const;
+
+    ThreadPool* threadPool_;
+    std::vector<Accumulator> accumulators_;
+    std::vector<std::vector<float>> resolveSums_;
+    TangentSpaceStats stats_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "Texture.hpp"
+
+#include "Profiler.hpp"
+#include "VulkanContext.hpp"
+
+Texture::Texture(std::shared_ptr<Image> image) :
+    pixels_(std::move(image)) {}
+
+Texture::~Texture()
+{
+    const auto& context = VulkanContext::Instance();
+    if (sampler_ != VK_NULL_HANDLE) {
+        vkDestroySampler(context.GetDevice(), sampler_, nullptr);
+    }
+    if (imageView_ != VK_NULL_HANDLE) {
+        vkDestroyImageView(context.GetDevice(), imageView_, nullptr);
+    }
+    if (image_ != VK_NULL_HANDLE) {
+        vmaDestroyImage(context.GetAllocator(), image_, allocation_);
+    }
+}
+
+void Texture::Bind()
+{
+    std::call_once(bound_, [this]() {
+        PROFILE_SCOPE("BindTexture");
+
+        CreateImage();
+        CreateImageView();
+        CreateSampler();
+        pixels_.reset();
+    });
+}
+
+VkDescriptorImageInfo Texture::GetImageInfo() const
+{
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView_;
+    imageInfo.sampler = sampler_;
+    return imageInfo;
+}
+
+void Texture::CreateImage()
+{
+    VulkanContext::Instance().CreateAndCopyImage(pixels_->GetWidth(), pixels_->GetHeight(), pixels_->GetChannels(),
+        pixels_->GetPixels(), VK_IMAGE_USAGE_SAMPLED_BIT, image_, allocation_);
+}
+
+void Texture::CreateImageView()
+{
+    imageView_ = VulkanContext::Instance().CreateImageView(image_, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+void Texture::CreateSampler()
+{
+    VkSamplerCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    createInfo.magFilter = VK_FILTER_LINEAR;
+    createInfo.minFilter = VK_FILTER_LINEAR;
+    createInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    createInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    createInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    createInfo.anisotropyEnable = VK_TRUE;
+    createInfo.maxAnisotropy = 16;
+    createInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    createInfo.unnormalizedCoordinates = VK_FALSE;
+    createInfo.compareEnable = VK_FALSE;
+    createInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    createInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    createInfo.mipLodBias = 0.0f;
+    createInfo.minLod = 0.0f;
+    createInfo.maxLod = 0.0f;
+    VULKAN_CHECK(vkCreateSampler(VulkanContext::Instance().GetDevice(), &createInfo, nullptr, &sampler_));
+}
\ No newline at end of file
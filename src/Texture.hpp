@@ -0,0 +1,36 @@
+#ifndef TEXTURE_HPP
+#define TEXTURE_HPP
+
+#include <memory>
+#include <mutex>
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "Image.hpp"
+
+class Texture {
+public:
+    Texture(std::shared_ptr<Image> image);
+    ~Texture();
+
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    void Bind();
+    VkDescriptorImageInfo GetImageInfo() const;
+
+private:
+    void CreateImage();
+    void CreateImageView();
+    void CreateSampler();
+
+    std::shared_ptr<Image> pixels_;
+    std::once_flag bound_;
+    VkImage image_ = VK_NULL_HANDLE;
+    VmaAllocation allocation_ = VK_NULL_HANDLE;
+    VkImageView imageView_ = VK_NULL_HANDLE;
+    VkSampler sampler_ = VK_NULL_HANDLE;
+};
+
+#endif
\ No newline at end of file
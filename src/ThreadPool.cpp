@@ -0,0 +1,88 @@
+#include "ThreadPool.hpp"
+
+#include <string>
+
+#include "Profiler.hpp"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    startCondition_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+    return static_cast<uint32_t>(threads_.size());
+}
+
+void ThreadPool::ParallelFor(uint32_t taskCount, const Task& task)
+{
+    if (taskCount == 0) {
+        return;
+    } else if (threads_.empty()) {
+        for (uint32_t i = 0; i < taskCount; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    taskCount_ = taskCount;
+    nextTask_.store(0, std::memory_order_relaxed);
+    activeThreads_ = static_cast<uint32_t>(threads_.size());
+    generation_++;
+    startCondition_.notify_all();
+
+    doneCondition_.wait(lock, [this]() {
+        return activeThreads_ == 0;
+    });
+    task_ = nullptr;
+}
+
+void ThreadPool::WorkerLoop(uint32_t threadIndex)
+{
+    if (Profiler::Instance().IsEnabled()) {
+        Profiler::Instance().SetThreadName("Worker " + std::to_string(threadIndex));
+    }
+
+    uint64_t generation = 0;
+    while (true) {
+        const Task* task;
+        uint32_t taskCount;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            startCondition_.wait(lock, [this, generation]() {
+                return stopping_ || generation_ != generation;
+            });
+            if (stopping_) {
+                return;
+            }
+            generation = generation_;
+            task = task_;
+            taskCount = taskCount_;
+        }
+
+        for (auto i = nextTask_.fetch_add(1); i < taskCount; i = nextTask_.fetch_add(1)) {
+            (*task)(i, threadIndex);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--activeThreads_ == 0) {
+            doneCondition_.notify_one();
+        }
+    }
+}
\ No newline at end of file
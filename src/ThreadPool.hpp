@@ -0,0 +1,39 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    using Task = std::function<void(uint32_t taskIndex, uint32_t threadIndex)>;
+
+    ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    uint32_t GetThreadCount() const;
+    void ParallelFor(uint32_t taskCount, const Task& task);
+
+private:
+    void WorkerLoop(uint32_t threadIndex);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable startCondition_, doneCondition_;
+    const Task* task_ = nullptr;
+    uint32_t taskCount_ = 0;
+    std::atomic<uint32_t> nextTask_ = 0;
+    uint32_t activeThreads_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+#endif
\ No newline at end of file
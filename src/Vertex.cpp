@@ -11,7 +11,7 @@ VkVertexInputBindingDescription Vertex::GetBindingDescription()
 
 std::vector<VkVertexInputAttributeDescription> Vertex::GetAttributeDescriptions()
 {
-    std::vector<VkVertexInputAttributeDescription> attributeDescriptions(2);
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions(4);
 
     attributeDescriptions[0].binding = 0;
     attributeDescriptions[0].location = 0;
@@ -23,5 +23,37 @@ std::vector<VkVertexInputAttributeDescription> Vertex::GetAttributeDescriptions(
     attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
     attributeDescriptions[1].offset = offsetof(Vertex, uv);
 
+    attributeDescriptions[2].binding = 0;
+    attributeDescriptions[2].location = 6;
+    attributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[2].offset = offsetof(Vertex, normal);
+
+    attributeDescriptions[3].binding = 0;
+    attributeDescriptions[3].location = 7;
+    attributeDescriptions[3].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    attributeDescriptions[3].offset = offsetof(Vertex, tangent);
+
     return attributeDescriptions;
 }
+
+
+VkVertexInputBindingDescription Vertex::GetPositionBindingDescription()
+{
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(glm::vec3);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return bindingDescription;
+}
+
+std::vector<VkVertexInputAttributeDescription> Vertex::GetPositionAttributeDescriptions()
+{
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions(1);
+
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = 0;
+
+    return attributeDescriptions;
+}
\ No newline at end of file
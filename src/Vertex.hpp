@@ -1,6 +1,7 @@
 #ifndef VERTEX_HPP
 #define VERTEX_HPP
 
+#include <cstdint>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -9,9 +10,19 @@
 struct Vertex {
     glm::vec3 position;
     glm::vec2 uv;
+    glm::vec3 normal;
+    glm::vec4 tangent;
 
     static VkVertexInputBindingDescription GetBindingDescription();
     static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
+    static VkVertexInputBindingDescription GetPositionBindingDescription();
+    static std::vector<VkVertexInputAttributeDescription> GetPositionAttributeDescriptions();
+};
+
+struct PackedVertex {
+    uint16_t position[3];
+    uint16_t tangentSign;
+    uint32_t uv, normal, tangent;
 };
 
 #endif
\ No newline at end of file
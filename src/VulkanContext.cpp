@@ -1,11 +1,17 @@
 #define VMA_IMPLEMENTATION
 #include "VulkanContext.hpp"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <unordered_set>
 
 #include <vulkan/vk_enum_string_helper.h>
 
+#include "EmbeddedShaders.hpp"
+
 VulkanContext& VulkanContext::Instance()
 {
     static VulkanContext instance;
@@ -22,15 +28,23 @@ void VulkanContext::CheckResult(VkResult result, const char* func, const char* f
 
 void VulkanContext::Init(GLFWwindow* window)
 {
+    headless_ = window == nullptr;
+
     CreateInstance();
     CreateValidationLayers();
     CreateSurface(window);
     CreatePhysicalDevice();
+    QueryDeviceFeatures();
     CreateDevice();
     CreateMemoryAllocator();
     CreateCommandPool();
 }
 
+bool VulkanContext::IsHeadless() const
+{
+    return headless_;
+}
+
 VkInstance VulkanContext::GetInstance() const
 {
     return instance_;
@@ -51,6 +65,21 @@ QueueFamilyIndices VulkanContext::GetQueueFamilyIndices() const
     return queueFamilyIndices_;
 }
 
+VkPhysicalDeviceProperties VulkanContext::GetPhysicalDeviceProperties() const
+{
+    return physicalDeviceProperties_;
+}
+
+uint32_t VulkanContext::GetApiVersion() const
+{
+    return apiVersion_;
+}
+
+const DeviceFeatures& VulkanContext::GetDeviceFeatures() const
+{
+    return deviceFeatures_;
+}
+
 VkDevice VulkanContext::GetDevice() const
 {
     return device_;
@@ -76,9 +105,54 @@ VkCommandPool VulkanContext::GetCommandPool() const
     return commandPool_;
 }
 
+void VulkanContext::SetShaderDirectory(const std::string& directory)
+{
+    shaderDirectory_ = directory;
+}
+
+UploadStats VulkanContext::GetUploadStats() const
+{
+    return {directUploadBytes_.load(), stagedUploadBytes_.load()};
+}
+
+void VulkanContext::CreateAndUploadBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+    const std::function<void(void* stagingData)>& write, VkBuffer& buffer, VmaAllocation& allocation)
+{
+    CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage, DIRECT_UPLOAD_ALLOCATION_FLAGS, buffer, allocation);
+    UploadBuffer(buffer, allocation, 0, size, write);
+}
+
+void VulkanContext::UploadBuffer(VkBuffer buffer, VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size,
+    const std::function<void(void* stagingData)>& write)
+{
+    PROFILE_SCOPE("UploadBuffer");
+
+    if (allocation != VK_NULL_HANDLE && WriteHostVisible(allocation, offset, size, write)) {
+        directUploadBytes_ += size;
+        return;
+    }
+
+    VkBuffer stagingBuffer;
+    VmaAllocation stagingAllocation;
+    CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+        stagingBuffer, stagingAllocation);
+
+    void* stagingData;
+    vmaMapMemory(allocator_, stagingAllocation, &stagingData);
+    write(stagingData);
+    vmaUnmapMemory(allocator_, stagingAllocation);
+
+    CopyBuffer(stagingBuffer, buffer, size, offset);
+
+    vmaDestroyBuffer(allocator_, stagingBuffer, stagingAllocation);
+    stagedUploadBytes_ += size;
+}
+
 void VulkanContext::CreateAndCopyImage(uint32_t width, uint32_t height, uint32_t channels, unsigned char* pixels,
     VkImageUsageFlagBits usage, VkImage& image, VmaAllocation& allocation)
 {
+    PROFILE_SCOPE("CreateAndCopyImage");
+
     VkDeviceSize imageSize = width * height * 4;
     VkBuffer stagingBuffer;
     VmaAllocation stagingAllocation;
@@ -99,9 +173,10 @@ void VulkanContext::CreateAndCopyImage(uint32_t width, uint32_t height, uint32_t
         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
     vmaDestroyBuffer(allocator_, stagingBuffer, stagingAllocation);
+    stagedUploadBytes_ += imageSize;
 }
 
-void VulkanContext::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocationCreateFlagBits allocationFlags,
+void VulkanContext::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocationCreateFlags allocationFlags,
     VkBuffer& buffer, VmaAllocation& allocation)
 {
     VkBufferCreateInfo bufferInfo{};
@@ -159,63 +234,140 @@ VkImageView VulkanContext::CreateImageView(VkImage image, VkFormat format, VkIma
     return imageView;
 }
 
+VkShaderModule VulkanContext::CreateShaderModule(const std::string& path)
+{
+    auto name = std::filesystem::path(path).filename().string();
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+
+    std::vector<uint32_t> code;
+    if (!shaderDirectory_.empty()) {
+        auto filePath = std::filesystem::path(shaderDirectory_) / name;
+        std::ifstream file(filePath, std::ios::ate | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << filePath.string() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        auto size = static_cast<size_t>(file.tellg());
+        code.resize((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(code.data()), size);
+        file.close();
+
+        createInfo.codeSize = size;
+        createInfo.pCode = code.data();
+    } else {
+        auto shader = std::find_if(std::begin(EMBEDDED_SHADERS), std::end(EMBEDDED_SHADERS),
+            [&name](const EmbeddedShader& embeddedShader) {
+                return name == embeddedShader.name;
+            });
+        if (shader == std::end(EMBEDDED_SHADERS)) {
+            std::cerr << "Shader not embedded: " << name << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        createInfo.codeSize = shader->size;
+        createInfo.pCode = shader->code;
+    }
+
+    VkShaderModule shaderModule;
+    VULKAN_CHECK(vkCreateShaderModule(device_, &createInfo, nullptr, &shaderModule));
+
+    return shaderModule;
+}
+
 void VulkanContext::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
 {
     auto commandBuffer = BeginSingleTimeCommands();
 
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = GetLayoutAccessMask(oldLayout);
+    barrier.dstAccessMask = GetLayoutAccessMask(newLayout);
     barrier.oldLayout = oldLayout;
     barrier.newLayout = newLayout;
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = image;
+    barrier.subresourceRange.aspectMask = GetFormatAspectMask(format);
     barrier.subresourceRange.baseMipLevel = 0;
     barrier.subresourceRange.levelCount = 1;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
-    if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    } else {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    }
-
-    VkPipelineStageFlags srcStage;
-    VkPipelineStageFlags dstStage;
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-        newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    } else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED &&
-        newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        dstStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    } else {
-        std::cerr << "Unsupported layout transition" << std::endl;
-        exit(EXIT_FAILURE);
-    }
-    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    vkCmdPipelineBarrier(commandBuffer, GetLayoutStageMask(oldLayout), GetLayoutStageMask(newLayout), 0, 0, nullptr,
+        0, nullptr, 1, &barrier);
 
     EndSingleTimeCommands(commandBuffer);
 }
 
-void VulkanContext::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+VkAccessFlags VulkanContext::GetLayoutAccessMask(VkImageLayout layout)
+{
+    if (layout == VK_IMAGE_LAYOUT_UNDEFINED || layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
+        return 0;
+    } else if (layout == VK_IMAGE_LAYOUT_PREINITIALIZED) {
+        return VK_ACCESS_HOST_WRITE_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+        return VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
+        return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL) {
+        return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+        return VK_ACCESS_SHADER_READ_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        return VK_ACCESS_TRANSFER_READ_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+        return VK_ACCESS_TRANSFER_WRITE_BIT;
+    }
+    return VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+}
+
+VkPipelineStageFlags VulkanContext::GetLayoutStageMask(VkImageLayout layout)
+{
+    if (layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        return VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
+        return VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_PREINITIALIZED) {
+        return VK_PIPELINE_STAGE_HOST_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+        return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
+        return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL) {
+        return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+        return VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    } else if (layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL || layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+        return VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+    return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+}
+
+VkImageAspectFlags VulkanContext::GetFormatAspectMask(VkFormat format)
+{
+    if (format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D32_SFLOAT) {
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    } else if (format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT ||
+        format == VK_FORMAT_D32_SFLOAT_S8_UINT) {
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    } else if (format == VK_FORMAT_S8_UINT) {
+        return VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    return VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+void VulkanContext::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset)
 {
     auto commandBuffer = BeginSingleTimeCommands();
 
     VkBufferCopy copy{};
     copy.srcOffset = 0;
-    copy.dstOffset = 0;
+    copy.dstOffset = dstOffset;
     copy.size = size;
     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copy);
 
@@ -241,12 +393,31 @@ void VulkanContext::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t w
     EndSingleTimeCommands(commandBuffer);
 }
 
+void VulkanContext::CopyImageToBuffer(VkImage image, VkBuffer buffer, uint32_t width, uint32_t height)
+{
+    auto commandBuffer = BeginSingleTimeCommands();
+
+    VkBufferImageCopy copy{};
+    copy.bufferOffset = 0;
+    copy.bufferRowLength = 0;
+    copy.bufferImageHeight = 0;
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.mipLevel = 0;
+    copy.imageSubresource.baseArrayLayer = 0;
+    copy.imageSubresource.layerCount = 1;
+    copy.imageOffset = {0, 0, 0};
+    copy.imageExtent = {width, height, 1};
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &copy);
+
+    EndSingleTimeCommands(commandBuffer);
+}
+
 VkCommandBuffer VulkanContext::BeginSingleTimeCommands()
 {
     VkCommandBufferAllocateInfo allocateInfo{};
     allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocateInfo.commandPool = commandPool_;
+    allocateInfo.commandPool = GetThreadCommandPool();
     allocateInfo.commandBufferCount = 1;
 
     VkCommandBuffer commandBuffer;
@@ -262,21 +433,34 @@ VkCommandBuffer VulkanContext::BeginSingleTimeCommands()
 
 void VulkanContext::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
 {
+    PROFILE_SCOPE("EndSingleTimeCommands");
+
     vkEndCommandBuffer(commandBuffer);
 
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence;
+    VULKAN_CHECK(vkCreateFence(device_, &fenceInfo, nullptr, &fence));
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
-    VULKAN_CHECK(vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE));
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        VULKAN_CHECK(vkQueueSubmit(graphicsQueue_, 1, &submitInfo, fence));
+    }
 
-    vkQueueWaitIdle(graphicsQueue_);
-    vkFreeCommandBuffers(device_, commandPool_, 1, &commandBuffer);
+    VULKAN_CHECK(vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX));
+    vkDestroyFence(device_, fence, nullptr);
+    vkFreeCommandBuffers(device_, GetThreadCommandPool(), 1, &commandBuffer);
 }
 
 VulkanContext::~VulkanContext()
 {
-    vkDestroyCommandPool(device_, commandPool_, nullptr);
+    for (const auto& [thread, commandPool] : threadCommandPools_) {
+        vkDestroyCommandPool(device_, commandPool, nullptr);
+    }
 
     vmaDestroyAllocator(allocator_);
 
@@ -286,7 +470,9 @@ VulkanContext::~VulkanContext()
         DestroyDebugUtilsMessengerEXT(instance_, messenger_, nullptr);
     }
 
-    vkDestroySurfaceKHR(instance_, surface_, nullptr);
+    if (surface_ != VK_NULL_HANDLE) {
+        vkDestroySurfaceKHR(instance_, surface_, nullptr);
+    }
 
     vkDestroyInstance(instance_, nullptr);
 }
@@ -298,13 +484,21 @@ void VulkanContext::CreateInstance()
         exit(EXIT_FAILURE);
     }
 
+    auto enumerateInstanceVersion = (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(nullptr,
+        "vkEnumerateInstanceVersion");
+    instanceApiVersion_ = VK_API_VERSION_1_0;
+    if (enumerateInstanceVersion != nullptr) {
+        enumerateInstanceVersion(&instanceApiVersion_);
+    }
+    instanceApiVersion_ = std::min(instanceApiVersion_, static_cast<uint32_t>(VK_API_VERSION_1_2));
+
     VkApplicationInfo appInfo{};
     appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
     appInfo.pApplicationName = "Hello Triangle";
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = instanceApiVersion_;
 
     auto extensions = GetRequiredExtensions();
 
@@ -346,10 +540,12 @@ bool VulkanContext::CheckValidationLayerSupport()
 
 std::vector<const char*> VulkanContext::GetRequiredExtensions()
 {
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    std::vector<const char*> extensions;
+    if (!headless_) {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
     if (ENABLE_VALIDATION_LAYERS) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
@@ -404,6 +600,10 @@ VKAPI_ATTR VkBool32 VKAPI_CALL VulkanContext::DebugCallback(VkDebugUtilsMessageS
 
 void VulkanContext::CreateSurface(GLFWwindow* window)
 {
+    if (headless_) {
+        return;
+    }
+
     VULKAN_CHECK(glfwCreateWindowSurface(instance_, window, nullptr, &surface_));
 }
 
@@ -430,10 +630,17 @@ void VulkanContext::CreatePhysicalDevice()
         std::cerr << "Suitable physical device not found" << std::endl;
         exit(EXIT_FAILURE);
     }
+
+    vkGetPhysicalDeviceProperties(physicalDevice_, &physicalDeviceProperties_);
 }
 
 bool VulkanContext::IsPhysicalDeviceSuitable(VkPhysicalDevice device)
 {
+    if (headless_) {
+        queueFamilyIndices_ = FindQueueFamilies(device);
+        return queueFamilyIndices_.IsComplete();
+    }
+
     if (!CheckSwapchainExtensionSupport(device)) {
         return false;
     }
@@ -503,10 +710,19 @@ QueueFamilyIndices VulkanContext::FindQueueFamilies(VkPhysicalDevice device)
     int32_t i = 0;
     QueueFamilyIndices indices;
     for (uint32_t i = 0; i < queueFamilies.size(); i++) {
-        if (queueFamilies[i].queueCount > 0 && (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+        if (queueFamilies[i].queueCount > 0 && (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
+            (queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
             indices.graphicsFamilyIndex = i;
         }
 
+        if (headless_) {
+            indices.presentFamilyIndex = indices.graphicsFamilyIndex;
+            if (indices.IsComplete()) {
+                break;
+            }
+            continue;
+        }
+
         VkBool32 supportPresent = false;
         vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &supportPresent);
         if (queueFamilies[i].queueCount > 0 && supportPresent) {
@@ -521,6 +737,42 @@ QueueFamilyIndices VulkanContext::FindQueueFamilies(VkPhysicalDevice device)
     return indices;
 }
 
+void VulkanContext::QueryDeviceFeatures()
+{
+    apiVersion_ = std::min(instanceApiVersion_, physicalDeviceProperties_.apiVersion);
+    deviceFeatures_ = {};
+    if (apiVersion_ < VK_API_VERSION_1_2) {
+        return;
+    }
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan12Features;
+    vkGetPhysicalDeviceFeatures2(physicalDevice_, &features);
+
+    deviceFeatures_.timelineSemaphore = vulkan12Features.timelineSemaphore == VK_TRUE;
+    deviceFeatures_.descriptorIndexing = vulkan12Features.runtimeDescriptorArray == VK_TRUE &&
+        vulkan12Features.descriptorBindingPartiallyBound == VK_TRUE &&
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE;
+
+    VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+    vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &vulkan12Properties;
+    vkGetPhysicalDeviceProperties2(physicalDevice_, &properties);
+
+    deviceFeatures_.maxBindlessTextures = std::min({
+        vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+        vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers,
+        vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages});
+}
+
 void VulkanContext::CreateDevice()
 {
     float queuePriority = 1.0f;
@@ -540,13 +792,31 @@ void VulkanContext::CreateDevice()
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.timelineSemaphore = deviceFeatures_.timelineSemaphore;
+    vulkan12Features.runtimeDescriptorArray = deviceFeatures_.descriptorIndexing;
+    vulkan12Features.descriptorBindingPartiallyBound = deviceFeatures_.descriptorIndexing;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = deviceFeatures_.descriptorIndexing;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan12Features;
+    features.features = deviceFeatures;
+
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(SWAPCHAIN_EXTENSIONS.size());
-    createInfo.ppEnabledExtensionNames = SWAPCHAIN_EXTENSIONS.data();
+    if (apiVersion_ >= VK_API_VERSION_1_2) {
+        createInfo.pNext = &features;
+    } else {
+        createInfo.pEnabledFeatures = &deviceFeatures;
+    }
+    if (!headless_) {
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(SWAPCHAIN_EXTENSIONS.size());
+        createInfo.ppEnabledExtensionNames = SWAPCHAIN_EXTENSIONS.data();
+    }
     VULKAN_CHECK(vkCreateDevice(physicalDevice_, &createInfo, nullptr, &device_));
 
     vkGetDeviceQueue(device_, queueFamilyIndices_.graphicsFamilyIndex, 0, &graphicsQueue_);
@@ -556,7 +826,7 @@ void VulkanContext::CreateDevice()
 void VulkanContext::CreateMemoryAllocator()
 {
     VmaAllocatorCreateInfo allocatorInfo = {};
-    allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_0;
+    allocatorInfo.vulkanApiVersion = apiVersion_;
     allocatorInfo.physicalDevice = physicalDevice_;
     allocatorInfo.device = device_;
     allocatorInfo.instance = instance_;
@@ -570,4 +840,36 @@ void VulkanContext::CreateCommandPool()
     createInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     createInfo.queueFamilyIndex = queueFamilyIndices_.graphicsFamilyIndex;
     VULKAN_CHECK(vkCreateCommandPool(device_, &createInfo, nullptr, &commandPool_));
+    threadCommandPools_[std::this_thread::get_id()] = commandPool_;
+}
+
+VkCommandPool VulkanContext::GetThreadCommandPool()
+{
+    std::lock_guard<std::mutex> lock(commandPoolMutex_);
+    auto& commandPool = threadCommandPools_[std::this_thread::get_id()];
+    if (commandPool == VK_NULL_HANDLE) {
+        VkCommandPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        createInfo.queueFamilyIndex = queueFamilyIndices_.graphicsFamilyIndex;
+        VULKAN_CHECK(vkCreateCommandPool(device_, &createInfo, nullptr, &commandPool));
+    }
+    return commandPool;
+}
+
+bool VulkanContext::WriteHostVisible(VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size,
+    const std::function<void(void* stagingData)>& write)
+{
+    VkMemoryPropertyFlags memoryProperties;
+    vmaGetAllocationMemoryProperties(allocator_, allocation, &memoryProperties);
+    if ((memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0) {
+        return false;
+    }
+
+    void* data;
+    VULKAN_CHECK(vmaMapMemory(allocator_, allocation, &data));
+    write(static_cast<uint8_t*>(data) + offset);
+    VULKAN_CHECK(vmaFlushAllocation(allocator_, allocation, offset, size));
+    vmaUnmapMemory(allocator_, allocation);
+    return true;
 }
\ No newline at end of file
@@ -1,12 +1,21 @@
 #ifndef VULKAN_CONTEXT_HPP
 #define VULKAN_CONTEXT_HPP
 
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <GLFW/glfw3.h>
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include "Profiler.hpp"
+
 #define VULKAN_CHECK(val) VulkanContext::CheckResult((val), #val, __FILE__, __LINE__)
 
 struct SwapchainSupportDetails {
@@ -15,6 +24,16 @@ struct SwapchainSupportDetails {
     std::vector<VkPresentModeKHR> presentModes;
 };
 
+struct DeviceFeatures {
+    bool timelineSemaphore = false;
+    bool descriptorIndexing = false;
+    uint32_t maxBindlessTextures = 0;
+};
+
+struct UploadStats {
+    VkDeviceSize directBytes = 0, stagedBytes = 0;
+};
+
 struct QueueFamilyIndices {
     int32_t graphicsFamilyIndex = -1;
     int32_t presentFamilyIndex = -1;
@@ -27,53 +46,60 @@ struct QueueFamilyIndices {
 
 class VulkanContext {
 public:
+    static constexpr VmaAllocationCreateFlags DIRECT_UPLOAD_ALLOCATION_FLAGS =
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT;
+
     static VulkanContext& Instance();
     static void CheckResult(VkResult result, const char* func, const char* file, int line);
+    static VkAccessFlags GetLayoutAccessMask(VkImageLayout layout);
+    static VkPipelineStageFlags GetLayoutStageMask(VkImageLayout layout);
+    static VkImageAspectFlags GetFormatAspectMask(VkFormat format);
 
     void Init(GLFWwindow* window);
+    bool IsHeadless() const;
     VkInstance GetInstance() const;
     VkSurfaceKHR GetSurface() const;
     SwapchainSupportDetails GetSwapchainSupport() const;
     QueueFamilyIndices GetQueueFamilyIndices() const;
+    VkPhysicalDeviceProperties GetPhysicalDeviceProperties() const;
+    uint32_t GetApiVersion() const;
+    const DeviceFeatures& GetDeviceFeatures() const;
     VkDevice GetDevice() const;
     VkQueue GetGraphicsQueue() const;
     VkQueue GetPresentQueue() const;
     VmaAllocator GetAllocator() const;
     VkCommandPool GetCommandPool() const;
+    void SetShaderDirectory(const std::string& directory);
+    UploadStats GetUploadStats() const;
 
     template<typename T>
     void CreateAndCopyBuffer(const std::vector<T>& data, VkBufferUsageFlags usage, VkBuffer& buffer,
         VmaAllocation& allocation)
     {
         VkDeviceSize bufferSize = sizeof(T) * data.size();
-
-        VkBuffer stagingBuffer;
-        VmaAllocation stagingAllocation;
-        CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
-            stagingBuffer, stagingAllocation);
-
-        void* stagingData;
-        vmaMapMemory(allocator_, stagingAllocation, &stagingData);
-        memcpy(stagingData, data.data(), static_cast<size_t>(bufferSize));
-        vmaUnmapMemory(allocator_, stagingAllocation);
-
-        CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage, {}, buffer, allocation);
-
-        CopyBuffer(stagingBuffer, buffer, bufferSize);
-
-        vmaDestroyBuffer(allocator_, stagingBuffer, stagingAllocation);
+        CreateAndUploadBuffer(bufferSize, usage, [&data, bufferSize](void* stagingData) {
+            memcpy(stagingData, data.data(), static_cast<size_t>(bufferSize));
+        }, buffer, allocation);
     }
 
+    void CreateAndUploadBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+        const std::function<void(void* stagingData)>& write, VkBuffer& buffer, VmaAllocation& allocation);
+    void UploadBuffer(VkBuffer buffer, VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size,
+        const std::function<void(void* stagingData)>& write);
+
     void CreateAndCopyImage(uint32_t width, uint32_t height, uint32_t channels, unsigned char* pixels,
         VkImageUsageFlagBits usage, VkImage& image, VmaAllocation& allocation);
-    void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocationCreateFlagBits allocationFlags,
+    void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocationCreateFlags allocationFlags,
         VkBuffer& buffer, VmaAllocation& allocation);
     void CreateImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
         VmaAllocationCreateFlagBits allocationFlags, VkImage& image, VmaAllocation& allocation);
     VkImageView CreateImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectMask);
+    VkShaderModule CreateShaderModule(const std::string& path);
     void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-    void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+    void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset = 0);
     void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+    void CopyImageToBuffer(VkImage image, VkBuffer buffer, uint32_t width, uint32_t height);
     VkCommandBuffer BeginSingleTimeCommands();
     void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
 
@@ -104,9 +130,13 @@ private:
     bool CheckSwapchainExtensionSupport(VkPhysicalDevice device);
     SwapchainSupportDetails QuerySwapchainSupport(VkPhysicalDevice device);
     QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device);
+    void QueryDeviceFeatures();
     void CreateDevice();
     void CreateMemoryAllocator();
     void CreateCommandPool();
+    VkCommandPool GetThreadCommandPool();
+    bool WriteHostVisible(VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size,
+        const std::function<void(void* stagingData)>& write);
 
 #ifdef NDEBUG
     const bool ENABLE_VALIDATION_LAYERS = false;
@@ -120,16 +150,25 @@ private:
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
 
+    bool headless_ = false;
+    uint32_t instanceApiVersion_ = VK_API_VERSION_1_0;
+    uint32_t apiVersion_ = VK_API_VERSION_1_0;
+    DeviceFeatures deviceFeatures_;
     VkInstance instance_;
     VkDebugUtilsMessengerEXT messenger_;
-    VkSurfaceKHR surface_;
+    VkSurfaceKHR surface_ = VK_NULL_HANDLE;
     SwapchainSupportDetails swapchainSupport_;
     QueueFamilyIndices queueFamilyIndices_;
     VkPhysicalDevice physicalDevice_;
+    VkPhysicalDeviceProperties physicalDeviceProperties_;
     VkDevice device_;
     VkQueue graphicsQueue_, presentQueue_;
     VmaAllocator allocator_;
     VkCommandPool commandPool_;
+    std::mutex commandPoolMutex_, queueMutex_;
+    std::unordered_map<std::thread::id, VkCommandPool> threadCommandPools_;
+    std::string shaderDirectory_;
+    std::atomic<VkDeviceSize> directUploadBytes_ = 0, stagedUploadBytes_ = 0;
 };
 
 #endif
\ No newline at end of file
@@ -2,13 +2,14 @@
 #include <cstdlib>
 
 #include "Renderer.hpp"
+#include "RendererConfig.hpp"
 
-constexpr uint32_t WIDTH = 1920;
-constexpr uint32_t HEIGHT = 1080;
-
-int main()
+int main(int argc, char* argv[])
 {
-    Renderer renderer(WIDTH, HEIGHT);
+    RendererConfig config;
+    config.ParseArguments(argc, argv);
+
+    Renderer renderer(config);
     renderer.Run();
 
     return EXIT_SUCCESS;